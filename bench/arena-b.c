@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Measures the time and the number of allocations for building a batch of
+ * short strings with duplication and formatting, and then throwing all of
+ * them away. The strings are built once with the Alloc functions, which
+ * allocate each string on its own and free it with StrSafeFree, and once
+ * with an arena that is reset after each batch.
+ */
+
+#include <string.h>
+#include <strsafe.h>
+#include "bench.h"
+
+#define BATCHES 20000UL
+#define STRINGS 200
+
+/* Counts the calls to the allocator. */
+static unsigned long allocations = 0;
+
+static void * countingRealloc(void * pContext, void * pv, size_t cb){
+    (void)pContext;
+    allocations++;
+    return realloc(pv, cb);
+}
+
+static void countingFree(void * pContext, void * pv){
+    (void)pContext;
+    free(pv);
+}
+
+int main(void){
+    STRSAFE_ALLOCATOR allocator = {countingRealloc, countingFree, NULL};
+    static const char * const words[] = {
+        "alpha", "bravo", "charlie", "delta", "echo", "foxtrot"
+    };
+    char * strings[STRINGS];
+    STRSAFE_ARENA * arena;
+    unsigned long n;
+    double start;
+    int i;
+
+    printf("Batches of %d short strings, allocated and thrown away\n",
+            STRINGS);
+    StrSafeSetAllocator(&allocator);
+
+    allocations = 0;
+    start = bench_now();
+    for(n = 0; n < BATCHES; n++){
+        for(i = 0; i < STRINGS; i += 2){
+            size_t cch = 0;
+            strings[i] = NULL;
+            StringCchCopyAllocA(&strings[i], &cch, words[i % 6]);
+            strings[i + 1] = NULL;
+            cch = 0;
+            StringCchPrintfAllocA(&strings[i + 1], &cch, "%s-%d",
+                    words[i % 6], i);
+        }
+        for(i = 0; i < STRINGS; i++){
+            StrSafeFree(strings[i]);
+        }
+    }
+    bench_report("Alloc functions and StrSafeFree", bench_now() - start,
+            BATCHES * STRINGS);
+    printf("    %-48s %8lu allocations\n", "", allocations);
+
+    allocations = 0;
+    start = bench_now();
+    StrSafeArenaCreate(&arena, 0);
+    for(n = 0; n < BATCHES; n++){
+        for(i = 0; i < STRINGS; i += 2){
+            StringCchArenaDupA(arena, &strings[i], words[i % 6]);
+            StringCchArenaPrintfA(arena, &strings[i + 1], "%s-%d",
+                    words[i % 6], i);
+        }
+        StrSafeArenaReset(arena);
+    }
+    StrSafeArenaDestroy(arena);
+    bench_report("Arena functions and StrSafeArenaReset",
+            bench_now() - start, BATCHES * STRINGS);
+    printf("    %-48s %8lu allocations\n", "", allocations);
+
+    StrSafeSetAllocator(NULL);
+
+    return 0;
+}
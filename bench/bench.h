@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Helpers shared by the libstrsafe benchmarks.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/**
+ * Gets the current time.
+ *
+ * @return The current time of a monotonic clock in seconds.
+ */
+static double bench_now(void){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/**
+ * Prints the average time spent per call.
+ *
+ * @param name The name of the benchmark.
+ * @param seconds The total time spent.
+ * @param calls The number of calls made.
+ */
+static void bench_report(const char * name, double seconds,
+        unsigned long calls){
+    printf("    %-48s %8.2f ns/call\n", name,
+            seconds * 1e9 / (double)calls);
+}
+
+/**
+ * Runs the benchmark program again once for each set of kernels, with the
+ * STRSAFE_KERNEL environment variable set to the name of the set.
+ *
+ * @param argv The arguments to the benchmark program.
+ *
+ * @return Zero if the caller should run the benchmarks, which is the case
+ *         when STRSAFE_KERNEL is already set, and non-zero otherwise.
+ */
+static int bench_each_kernel(char * argv[]){
+    static const char * const kernels[] = {
+        "scalar", "swar", "sse2", "avx2", "avx512"
+    };
+    size_t i;
+
+    if(getenv("STRSAFE_KERNEL") != NULL){
+        return 0;
+    }
+    for(i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++){
+        pid_t pid = fork();
+        if(pid == 0){
+            setenv("STRSAFE_KERNEL", kernels[i], 1);
+            execv(argv[0], argv);
+            _exit(127);
+        }
+        if(pid > 0){
+            waitpid(pid, NULL, 0);
+        }
+    }
+    return 1;
+}
+
+#endif /* BENCH_H */
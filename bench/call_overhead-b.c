@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Measures the time per call for a four character string through each of
+ * the public functions that copy it, from the ones that used to call
+ * through several other public functions to the one doing the work. With
+ * so little to copy, the differences between them are the cost of the
+ * calls between functions.
+ */
+
+#include <string.h>
+#include <strsafe.h>
+#include "bench.h"
+
+#define CALLS 20000000UL
+
+int main(void){
+    char source[] = "four";
+    char dest[16];
+    size_t length;
+    unsigned long n;
+    double start;
+
+    printf("Call overhead for a four character string\n");
+
+    start = bench_now();
+    for(n = 0; n < CALLS; n++){
+        StringCchCopyA(dest, sizeof(dest), source);
+    }
+    bench_report("StringCchCopyA", bench_now() - start, CALLS);
+
+    start = bench_now();
+    for(n = 0; n < CALLS; n++){
+        StringCbCopyA(dest, sizeof(dest), source);
+    }
+    bench_report("StringCbCopyA", bench_now() - start, CALLS);
+
+    start = bench_now();
+    for(n = 0; n < CALLS; n++){
+        StringCchCopyNA(dest, sizeof(dest), source, sizeof(source));
+    }
+    bench_report("StringCchCopyNA", bench_now() - start, CALLS);
+
+    start = bench_now();
+    for(n = 0; n < CALLS; n++){
+        StringCchCopyNExA(dest, sizeof(dest), source, sizeof(source),
+                NULL, NULL, 0);
+    }
+    bench_report("StringCchCopyNExA", bench_now() - start, CALLS);
+
+    start = bench_now();
+    for(n = 0; n < CALLS; n++){
+        dest[0] = '\0';
+        StringCchCatNExA(dest, sizeof(dest), source, sizeof(source),
+                NULL, NULL, 0);
+    }
+    bench_report("StringCchCatNExA", bench_now() - start, CALLS);
+
+    start = bench_now();
+    for(n = 0; n < CALLS; n++){
+        StringCbLengthA(source, sizeof(source), &length);
+    }
+    bench_report("StringCbLengthA", bench_now() - start, CALLS);
+
+    start = bench_now();
+    for(n = 0; n < CALLS; n++){
+        StringCchLengthA(source, sizeof(source), &length);
+    }
+    bench_report("StringCchLengthA", bench_now() - start, CALLS);
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Measures what filling a large buffer with STRSAFE_FILL_BEHIND_NULL costs
+ * the rest of the program. Each round fills a 1 MB buffer and then reads a
+ * 256 KB working set that fits in the caches. With ordinary stores the
+ * fill pushes the working set out and the reads miss, with non-temporal
+ * stores it stays. The cache misses of the reads are counted where the
+ * kernel lets the program read the hardware counters.
+ */
+
+#include <string.h>
+#include <strsafe.h>
+#include "bench.h"
+#ifdef __linux__
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+#endif
+
+#define ROUNDS 2000UL
+#define FILL_SIZE (1024 * 1024)
+#define WORKING_SET_SIZE (256 * 1024)
+
+/**
+ * Opens a counter for the cache misses of the calling thread.
+ *
+ * @return The file descriptor of the counter, or -1 if it is not
+ *         available.
+ */
+static int open_counter(void){
+#ifdef __linux__
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif
+}
+
+static void start_counter(int fd){
+#ifdef __linux__
+    if(fd >= 0){
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#else
+    (void)fd;
+#endif
+}
+
+static void stop_counter(int fd){
+#ifdef __linux__
+    if(fd >= 0){
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+#else
+    (void)fd;
+#endif
+}
+
+/**
+ * Fills the buffer and reads the working set ROUNDS times, and reports the
+ * time per round and the cache misses per read of the working set.
+ */
+static void run(const char * name, char * buffer,
+        const unsigned long * workingSet, int fd){
+    const size_t words = WORKING_SET_SIZE / sizeof(unsigned long);
+    volatile unsigned long sink = 0;
+    unsigned long long misses = 0;
+    double reading = 0;
+    unsigned long n;
+
+    for(n = 0; n < ROUNDS; n++){
+        double readStart;
+        unsigned long sum = 0;
+        size_t i;
+
+        buffer[0] = '\0';
+        StringCchCatExA(buffer, FILL_SIZE, "x", NULL, NULL,
+                STRSAFE_FILL_BEHIND_NULL | '@');
+
+        readStart = bench_now();
+        start_counter(fd);
+        for(i = 0; i < words; i++){
+            sum += workingSet[i];
+        }
+        stop_counter(fd);
+        reading += bench_now() - readStart;
+        sink += sum;
+    }
+    (void)sink;
+
+    printf("    %s\n", name);
+    printf("        %-44s %8.0f ns/round\n", "Reading the working set",
+            reading * 1e9 / (double)ROUNDS);
+    if(fd >= 0 && read(fd, &misses, sizeof(misses)) == sizeof(misses)){
+        printf("        %-44s %8.0f misses/round\n",
+                "Cache misses reading the working set",
+                (double)misses / (double)ROUNDS);
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    }
+}
+
+int main(void){
+    char * buffer = malloc(FILL_SIZE);
+    unsigned long * workingSet = malloc(WORKING_SET_SIZE);
+    int fd = open_counter();
+    double start;
+    unsigned long n;
+
+    if(buffer == NULL || workingSet == NULL){
+        return 1;
+    }
+    memset(workingSet, 1, WORKING_SET_SIZE);
+
+    printf("Filling a 1 MB buffer, then reading a 256 KB working set\n");
+    if(fd < 0){
+        printf("    Cache miss counter not available\n");
+    }
+
+    StrSafeSetFillThreshold((size_t)-1);
+    run("Ordinary stores", buffer, workingSet, fd);
+    StrSafeSetFillThreshold(32768);
+    run("Non-temporal stores", buffer, workingSet, fd);
+
+    StrSafeSetFillThreshold((size_t)-1);
+    start = bench_now();
+    for(n = 0; n < ROUNDS; n++){
+        buffer[0] = '\0';
+        StringCchCatExA(buffer, FILL_SIZE, "x", NULL, NULL,
+                STRSAFE_FILL_BEHIND_NULL | '@');
+    }
+    bench_report("Fill only, ordinary stores", bench_now() - start, ROUNDS);
+
+    StrSafeSetFillThreshold(32768);
+    start = bench_now();
+    for(n = 0; n < ROUNDS; n++){
+        buffer[0] = '\0';
+        StringCchCatExA(buffer, FILL_SIZE, "x", NULL, NULL,
+                STRSAFE_FILL_BEHIND_NULL | '@');
+    }
+    bench_report("Fill only, non-temporal stores", bench_now() - start,
+            ROUNDS);
+
+    free(buffer);
+    free(workingSet);
+
+    return 0;
+}
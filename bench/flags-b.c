@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Measures the time per call for short strings through the functions
+ * without Ex, through the Ex functions with dwFlags set to 0 and through
+ * the Ex functions with flags that do not change the result but take the
+ * code path that checks every flag at run time.
+ */
+
+#include <string.h>
+#include <strsafe.h>
+#include "bench.h"
+
+#define CALLS 10000000UL
+
+/* Flags that make no difference when the buffer is exactly as large as the
+ * source, as there is nothing to fill behind the null termination. */
+#define RUNTIME_FLAGS (STRSAFE_IGNORE_NULLS | STRSAFE_FILL_BEHIND_NULL)
+
+int main(void){
+    char source[] = "sixteen chars ok";
+    char format[] = "%s";
+    char dest[sizeof(source)];
+    LPSTR destEnd;
+    size_t remaining;
+    unsigned long n;
+    double start;
+
+    printf("Short strings with different dwFlags\n");
+
+    start = bench_now();
+    for(n = 0; n < CALLS; n++){
+        dest[0] = '\0';
+        StringCchCatA(dest, sizeof(dest), source);
+    }
+    bench_report("StringCchCatA", bench_now() - start, CALLS);
+
+    start = bench_now();
+    for(n = 0; n < CALLS; n++){
+        dest[0] = '\0';
+        StringCchCatExA(dest, sizeof(dest), source,
+                &destEnd, &remaining, 0);
+    }
+    bench_report("StringCchCatExA, dwFlags 0", bench_now() - start, CALLS);
+
+    start = bench_now();
+    for(n = 0; n < CALLS; n++){
+        dest[0] = '\0';
+        StringCchCatExA(dest, sizeof(dest), source,
+                &destEnd, &remaining, RUNTIME_FLAGS);
+    }
+    bench_report("StringCchCatExA, flags checked at run time",
+            bench_now() - start, CALLS);
+
+    start = bench_now();
+    for(n = 0; n < CALLS; n++){
+        StringCchCopyA(dest, sizeof(dest), source);
+    }
+    bench_report("StringCchCopyA", bench_now() - start, CALLS);
+
+    start = bench_now();
+    for(n = 0; n < CALLS; n++){
+        StringCchCopyExA(dest, sizeof(dest), source,
+                &destEnd, &remaining, RUNTIME_FLAGS);
+    }
+    bench_report("StringCchCopyExA, flags checked at run time",
+            bench_now() - start, CALLS);
+
+    start = bench_now();
+    for(n = 0; n < CALLS / 10; n++){
+        StringCchPrintfA(dest, sizeof(dest), format, source);
+    }
+    bench_report("StringCchPrintfA", bench_now() - start, CALLS / 10);
+
+    start = bench_now();
+    for(n = 0; n < CALLS / 10; n++){
+        StringCchPrintfExA(dest, sizeof(dest), &destEnd, &remaining,
+                RUNTIME_FLAGS, format, source);
+    }
+    bench_report("StringCchPrintfExA, flags checked at run time",
+            bench_now() - start, CALLS / 10);
+
+    return 0;
+}
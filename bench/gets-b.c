@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Measures the throughput of reading stdin line by line. The old way is
+ * the loop StringCchGetsA used to have, which calls getchar and so locks
+ * stdin once for every character. The new way is StringCchGetsA, which
+ * locks stdin once for every line.
+ */
+
+#include <string.h>
+#include <strsafe.h>
+#include "bench.h"
+
+#define LINES 400000UL
+#define LINE "The quick brown fox jumps over the lazy dog, again and again."
+
+/**
+ * Reads a line from stdin the way StringCchGetsA used to.
+ */
+static HRESULT old_gets(char * pszDest, size_t cchDest){
+    size_t length = 0;
+    HRESULT result = S_OK;
+
+    while(length < cchDest - 1){
+        int c = getchar();
+        if(c == EOF){
+            if(length == 0){
+                result = STRSAFE_E_END_OF_FILE;
+            }
+            break;
+        }
+        if((char)c == '\n'){
+            break;
+        }
+        pszDest[length++] = (char)c;
+    }
+    pszDest[length] = '\0';
+
+    return result;
+}
+
+/**
+ * Reads all of stdin line by line and reports the throughput.
+ */
+static void run(const char * name, const char * path,
+        HRESULT (*gets)(char *, size_t)){
+    char line[256];
+    unsigned long lines = 0;
+    double start;
+    double seconds;
+
+    if(freopen(path, "r", stdin) == NULL){
+        printf("    Could not open %s\n", path);
+        return;
+    }
+    start = bench_now();
+    while(gets(line, sizeof(line)) != STRSAFE_E_END_OF_FILE){
+        lines++;
+    }
+    seconds = bench_now() - start;
+    printf("    %-48s %8.1f MB/s\n", name,
+            (double)(lines * sizeof(LINE)) / seconds / 1e6);
+}
+
+int main(void){
+    char path[] = "/tmp/strsafe-gets-XXXXXX";
+    int fd = mkstemp(path);
+    FILE * file;
+    unsigned long n;
+
+    if(fd < 0 || (file = fdopen(fd, "w")) == NULL){
+        return 1;
+    }
+    for(n = 0; n < LINES; n++){
+        fputs(LINE "\n", file);
+    }
+    fclose(file);
+
+    printf("Reading %lu lines from stdin\n", LINES);
+    run("getchar for every character", path, old_gets);
+    run("StringCchGetsA", path, StringCchGetsA);
+
+    unlink(path);
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Measures the time per path for combining a deep directory with a
+ * relative path and normalizing the result. The old way builds the path
+ * with a chain of StringCchCatA calls, each of which scans the whole path
+ * built so far, and then normalizes it in a second pass that moves every
+ * component again. The new way is one call to StringCchPathCombineA.
+ */
+
+#include <string.h>
+#include <strsafe.h>
+#include "bench.h"
+
+#define CALLS 1000000UL
+
+/**
+ * Normalizes a path in place the way StringCchPathCombineA does, as a
+ * separate pass over the path.
+ */
+static void normalize(char * path){
+    char * read = path;
+    char * write = path;
+    int absolute = *path == '/';
+
+    if(absolute){
+        write++;
+    }
+    while(*read != '\0'){
+        char * end;
+        size_t length;
+
+        while(*read == '/'){
+            read++;
+        }
+        if(*read == '\0'){
+            break;
+        }
+        for(end = read; *end != '\0' && *end != '/'; end++){
+        }
+        length = (size_t)(end - read);
+        if(length == 1 && read[0] == '.'){
+            read = end;
+            continue;
+        }
+        if(length == 2 && read[0] == '.' && read[1] == '.' &&
+                write > path + absolute){
+            while(write > path + absolute && write[-1] != '/'){
+                write--;
+            }
+            if(write > path + absolute){
+                write--;
+            }
+            read = end;
+            continue;
+        }
+        if(write > path + absolute){
+            *write++ = '/';
+        }
+        memmove(write, read, length);
+        write += length;
+        read = end;
+    }
+    *write = '\0';
+}
+
+int main(void){
+    static const char * const components[] = {
+        "srv", "export", "projects", "libstrsafe", "build", "x86_64",
+        "release", "objects", "src", "..", "include", ".", "strsafe",
+        "detail", "generated", "headers"
+    };
+    const size_t count = sizeof(components) / sizeof(components[0]);
+    char dir[256];
+    char dest[256];
+    char check[256];
+    unsigned long n;
+    double start;
+    size_t i;
+
+    /* The directory the file server has already resolved, and the
+     * relative path that comes in with a request. */
+    dir[0] = '\0';
+    for(i = 0; i < count; i++){
+        StringCchCatA(dir, sizeof(dir), "/");
+        StringCchCatA(dir, sizeof(dir), components[i]);
+    }
+
+    printf("Combining a %lu character directory with a relative path\n",
+            (unsigned long)strlen(dir));
+
+    start = bench_now();
+    for(n = 0; n < CALLS; n++){
+        StringCchCopyA(dest, sizeof(dest), "/");
+        StringCchCatA(dest, sizeof(dest), dir);
+        StringCchCatA(dest, sizeof(dest), "/");
+        StringCchCatA(dest, sizeof(dest), "../x//./name.h");
+        normalize(dest);
+    }
+    bench_report("Chain of StringCchCatA and normalize", bench_now() - start,
+            CALLS);
+
+    start = bench_now();
+    for(n = 0; n < CALLS; n++){
+        StringCchPathCombineA(check, sizeof(check), dir, "../x//./name.h");
+    }
+    bench_report("StringCchPathCombineA", bench_now() - start, CALLS);
+
+    if(strcmp(dest, check) != 0){
+        printf("    Results differ: %s and %s\n", dest, check);
+        return 1;
+    }
+
+    return 0;
+}
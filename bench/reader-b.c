@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Measures the throughput of reading a file line by line with getline,
+ * with StringCchGetsA from stdin and with readers on the file descriptor
+ * that read it into a buffer or map it, both copying the lines and peeking
+ * at them where they are.
+ * The file is 64 MB unless the size in MB is given in the environment
+ * variable STRSAFE_BENCH_MB, e.g. 1024 for a 1 GB file.
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <strsafe.h>
+#include "bench.h"
+
+#define LINE "The quick brown fox jumps over the lazy dog, again and again."
+
+/**
+ * Prints the throughput of reading cbFile bytes in the given time.
+ */
+static void report(const char * name, unsigned long long cbFile,
+        double seconds){
+    printf("    %-48s %8.1f MB/s\n", name, (double)cbFile / seconds / 1e6);
+}
+
+/**
+ * Reads all lines of a file with a reader and reports the throughput.
+ *
+ * @return The number of lines, or 0 if the reader could not be created.
+ */
+static unsigned long run(const char * name, const char * path,
+        unsigned long long cbFile, int mapped, int peek){
+    char line[256];
+    STRSAFE_SEGMENT_A view;
+    STRSAFE_READER * reader;
+    unsigned long lines = 0;
+    double start;
+    int fd = open(path, O_RDONLY);
+
+    if(fd < 0 || FAILED(mapped ? StrSafeReaderCreateMapped(&reader, fd, 0) :
+                    StrSafeReaderCreate(&reader, fd, 0))){
+        printf("    Could not open %s\n", path);
+        return 0;
+    }
+    start = bench_now();
+    if(peek){
+        while(StringCchPeekLineA(reader, sizeof(line) - 1, &view) !=
+                STRSAFE_E_END_OF_FILE){
+            lines++;
+        }
+    } else {
+        while(StringCchReadLineExA(reader, line, sizeof(line), NULL, NULL,
+                        0) != STRSAFE_E_END_OF_FILE){
+            lines++;
+        }
+    }
+    report(name, cbFile, bench_now() - start);
+    StrSafeReaderDestroy(reader);
+    close(fd);
+
+    return lines;
+}
+
+int main(void){
+    char path[] = "/tmp/strsafe-reader-XXXXXX";
+    int fd = mkstemp(path);
+    const char * mb = getenv("STRSAFE_BENCH_MB");
+    unsigned long long cbFile = (mb != NULL ? strtoull(mb, NULL, 10) : 64)
+            << 20;
+    unsigned long long cbWritten = 0;
+    unsigned long lines[6] = {0, 0, 0, 0, 0, 0};
+    char line[256];
+    char * pLine = NULL;
+    size_t cbLine = 0;
+    FILE * file;
+    double start;
+    int i;
+
+    if(fd < 0 || (file = fdopen(fd, "w")) == NULL){
+        return 1;
+    }
+    while(cbWritten < cbFile){
+        fputs(LINE "\n", file);
+        cbWritten += sizeof(LINE);
+    }
+    fclose(file);
+
+    printf("Reading a %llu MB file line by line\n", cbWritten >> 20);
+
+    if((file = fopen(path, "r")) == NULL){
+        return 1;
+    }
+    start = bench_now();
+    while(getline(&pLine, &cbLine, file) != -1){
+        lines[0]++;
+    }
+    report("getline", cbWritten, bench_now() - start);
+    fclose(file);
+    free(pLine);
+
+    if(freopen(path, "r", stdin) == NULL){
+        return 1;
+    }
+    start = bench_now();
+    while(StringCchGetsA(line, sizeof(line)) != STRSAFE_E_END_OF_FILE){
+        lines[1]++;
+    }
+    report("StringCchGetsA", cbWritten, bench_now() - start);
+
+    lines[2] = run("StringCchReadLineExA", path, cbWritten, 0, 0);
+    lines[3] = run("StringCchPeekLineA", path, cbWritten, 0, 1);
+    lines[4] = run("StringCchReadLineExA, mapped", path, cbWritten, 1, 0);
+    lines[5] = run("StringCchPeekLineA, mapped", path, cbWritten, 1, 1);
+
+    unlink(path);
+
+    for(i = 1; i < 6; i++){
+        if(lines[i] != lines[0]){
+            printf("    Line counts differ: %lu and %lu\n", lines[0],
+                    lines[i]);
+            return 1;
+        }
+    }
+
+    return 0;
+}
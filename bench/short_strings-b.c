@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Measures the time per call for copying and concatenating strings of
+ * 8 to 120 characters, where the code for the start and the end of the
+ * string matters more than the main loop of the kernels.
+ */
+
+#include <string.h>
+#include <strsafe.h>
+#include "bench.h"
+
+#define CALLS 5000000UL
+
+int main(int argc, char * argv[]){
+    static const size_t lengths[] = {8, 16, 32, 64, 120};
+    char src[160];
+    char dest[256];
+    size_t i;
+
+    (void)argc;
+    if(bench_each_kernel(argv)){
+        return 0;
+    }
+
+    printf("Short strings with STRSAFE_KERNEL=%s\n",
+            getenv("STRSAFE_KERNEL"));
+    for(i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++){
+        /* Start the source at an odd address, as most strings are. */
+        char * source = src + 1;
+        char name[64];
+        LPSTR destEnd;
+        size_t remaining;
+        size_t length;
+        unsigned long n;
+        double start;
+
+        memset(src, 'x', sizeof(src));
+        src[1 + lengths[i]] = '\0';
+
+        start = bench_now();
+        for(n = 0; n < CALLS; n++){
+            StringCchLengthA(source, sizeof(dest), &length);
+        }
+        snprintf(name, sizeof(name), "StringCchLengthA, %lu characters",
+                (unsigned long)lengths[i]);
+        bench_report(name, bench_now() - start, CALLS);
+
+        start = bench_now();
+        for(n = 0; n < CALLS; n++){
+            StringCchCopyExA(dest, sizeof(dest), source,
+                    &destEnd, &remaining, 0);
+        }
+        snprintf(name, sizeof(name), "StringCchCopyExA, %lu characters",
+                (unsigned long)lengths[i]);
+        bench_report(name, bench_now() - start, CALLS);
+
+        strcpy(dest, "prefix:");
+        start = bench_now();
+        for(n = 0; n < CALLS; n++){
+            dest[7] = '\0';
+            StringCchCatExA(dest, sizeof(dest), source,
+                    &destEnd, &remaining, 0);
+        }
+        snprintf(name, sizeof(name), "StringCchCatExA, %lu characters",
+                (unsigned long)lengths[i]);
+        bench_report(name, bench_now() - start, CALLS);
+    }
+
+    return 0;
+}
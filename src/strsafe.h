@@ -14,6 +14,7 @@
 #include <stdarg.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 
 /* Enable both versions of the UNICODE macro. */
 
@@ -63,6 +64,12 @@ typedef uint32_t HRESULT;
  */
 #define STRSAFE_E_INSUFFICIENT_BUFFER (uint32_t)0x00000004
 
+/**
+ * Memory could not be allocated. Only the functions that allocate their
+ * output buffers return this.
+ */
+#define STRSAFE_E_OUT_OF_MEMORY (uint32_t)0x00000008
+
 /*
  * Flags to set in parameters to the extended functions.
  */
@@ -175,6 +182,39 @@ HRESULT StringCchCatExW(
     DWORD dwFlags
 );
 
+/*
+ * The Ex2 functions work like the Ex functions, but also store the length
+ * the whole result would have, not counting the null termination, in
+ * *pcchRequired when they succeed or fail with
+ * STRSAFE_E_INSUFFICIENT_BUFFER. A buffer of *pcchRequired + 1 characters
+ * is then large enough, unless the length is STRSAFE_MAX_CCH, which is the
+ * most that is reported. pcchRequired may be NULL, in which case pszSrc is
+ * not read further than for the Ex function.
+ */
+#ifdef UNICODE
+    #define StringCchCatEx2 StringCchCatEx2W
+#else
+    #define StringCchCatEx2 StringCchCatEx2A
+#endif
+HRESULT StringCchCatEx2A(
+    LPSTR pszDest,
+    size_t cchDest,
+    LPCSTR pszSrc,
+    LPSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags,
+    size_t * pcchRequired
+);
+HRESULT StringCchCatEx2W(
+    LPWSTR pszDest,
+    size_t cchDest,
+    LPCWSTR pszSrc,
+    LPWSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags,
+    size_t * pcchRequired
+);
+
 #ifdef UNICODE
     #define StringCchCatN StringCchCatNW
 #else
@@ -217,6 +257,308 @@ HRESULT StringCchCatNExW(
     DWORD dwFlags
 );
 
+/*
+ * Concatenates several strings to pszDest in one call, in order. The
+ * sources are given either as an array of cSrc strings or as arguments
+ * ending with NULL. dwFlags works like for StringCchCatEx, for the
+ * concatenation of all sources as a whole: with STRSAFE_NO_TRUNCATION,
+ * pszDest is left untouched unless all of them fit. NULL elements of the
+ * array are only allowed with STRSAFE_IGNORE_NULLS.
+ */
+#ifdef UNICODE
+    #define StringCchCatMultiEx StringCchCatMultiExW
+    #define StringCchCatMultiListEx StringCchCatMultiListExW
+#else
+    #define StringCchCatMultiEx StringCchCatMultiExA
+    #define StringCchCatMultiListEx StringCchCatMultiListExA
+#endif
+HRESULT StringCchCatMultiExA(
+    LPSTR pszDest,
+    size_t cchDest,
+    LPCSTR * ppszSrc,
+    size_t cSrc,
+    LPSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+HRESULT StringCchCatMultiExW(
+    LPWSTR pszDest,
+    size_t cchDest,
+    LPCWSTR * ppszSrc,
+    size_t cSrc,
+    LPWSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+HRESULT StringCchCatMultiListExA(
+    LPSTR pszDest,
+    size_t cchDest,
+    LPSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags,
+    ...
+);
+HRESULT StringCchCatMultiListExW(
+    LPWSTR pszDest,
+    size_t cchDest,
+    LPWSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags,
+    ...
+);
+
+/**
+ * A piece of a string whose length is already known, for the Gather
+ * functions. The piece is pch[0] to pch[cch - 1], which should not contain
+ * null characters. pch is not read if cch is 0.
+ */
+typedef struct STRSAFE_SEGMENT_A {
+    const char * pch;
+    size_t cch;
+} STRSAFE_SEGMENT_A;
+typedef struct STRSAFE_SEGMENT_W {
+    const wchar_t * pch;
+    size_t cch;
+} STRSAFE_SEGMENT_W;
+
+/*
+ * Copies or concatenates the cSegments segments in pSegments to pszDest,
+ * in order. The segments are copied without being scanned, so the length
+ * of the result is known up front and dwFlags is applied once, for the
+ * result as a whole, like for StringCchCopyEx and StringCchCatEx. A
+ * segment with pch set to NULL and cch set to more than 0 is only allowed
+ * with STRSAFE_IGNORE_NULLS, and is then treated as empty.
+ */
+#ifdef UNICODE
+    #define STRSAFE_SEGMENT STRSAFE_SEGMENT_W
+    #define StringCchCopyGatherEx StringCchCopyGatherExW
+    #define StringCchCatGatherEx StringCchCatGatherExW
+#else
+    #define STRSAFE_SEGMENT STRSAFE_SEGMENT_A
+    #define StringCchCopyGatherEx StringCchCopyGatherExA
+    #define StringCchCatGatherEx StringCchCatGatherExA
+#endif
+HRESULT StringCchCopyGatherExA(
+    LPSTR pszDest,
+    size_t cchDest,
+    const STRSAFE_SEGMENT_A * pSegments,
+    size_t cSegments,
+    LPSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+HRESULT StringCchCopyGatherExW(
+    LPWSTR pszDest,
+    size_t cchDest,
+    const STRSAFE_SEGMENT_W * pSegments,
+    size_t cSegments,
+    LPWSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+HRESULT StringCchCatGatherExA(
+    LPSTR pszDest,
+    size_t cchDest,
+    const STRSAFE_SEGMENT_A * pSegments,
+    size_t cSegments,
+    LPSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+HRESULT StringCchCatGatherExW(
+    LPWSTR pszDest,
+    size_t cchDest,
+    const STRSAFE_SEGMENT_W * pSegments,
+    size_t cSegments,
+    LPWSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+
+/*
+ * Concatenates the cSrc strings in ppszSrc to pszDest, in order, with
+ * pszSeparator between each two of them. The Gather version takes
+ * segments instead of strings. dwFlags works like for StringCchCatMultiEx:
+ * with STRSAFE_NO_TRUNCATION, STRSAFE_NULL_ON_FAILURE or
+ * STRSAFE_FILL_ON_FAILURE the length of the whole result is found before
+ * anything is written, so pszDest is only changed as the flag says unless
+ * all of it fits. Start with an empty pszDest to build a new string. NULL
+ * strings, including pszSeparator, are only allowed with
+ * STRSAFE_IGNORE_NULLS and are then treated as empty.
+ */
+#ifdef UNICODE
+    #define StringCchJoinEx StringCchJoinExW
+    #define StringCchJoinGatherEx StringCchJoinGatherExW
+#else
+    #define StringCchJoinEx StringCchJoinExA
+    #define StringCchJoinGatherEx StringCchJoinGatherExA
+#endif
+HRESULT StringCchJoinExA(
+    LPSTR pszDest,
+    size_t cchDest,
+    LPCSTR * ppszSrc,
+    size_t cSrc,
+    LPCSTR pszSeparator,
+    LPSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+HRESULT StringCchJoinExW(
+    LPWSTR pszDest,
+    size_t cchDest,
+    LPCWSTR * ppszSrc,
+    size_t cSrc,
+    LPCWSTR pszSeparator,
+    LPWSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+HRESULT StringCchJoinGatherExA(
+    LPSTR pszDest,
+    size_t cchDest,
+    const STRSAFE_SEGMENT_A * pSegments,
+    size_t cSegments,
+    LPCSTR pszSeparator,
+    LPSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+HRESULT StringCchJoinGatherExW(
+    LPWSTR pszDest,
+    size_t cchDest,
+    const STRSAFE_SEGMENT_W * pSegments,
+    size_t cSegments,
+    LPCWSTR pszSeparator,
+    LPWSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+
+/*
+ * Combines the directory pszDir and the path pszFile into a normalized
+ * path in pszDest, in one pass and without allocating memory. Components
+ * are separated by '/'. An absolute pszFile replaces pszDir. Repeated
+ * separators and "." components are dropped, and a ".." component takes
+ * back the component in front of it, except at the start of a relative
+ * path, where it stays, and at the root, where it is dropped. The result
+ * has no trailing separator, and an empty result is ".". dwFlags works
+ * like for StringCchCopyEx. A result that does not fit is truncated at
+ * the first component that does not fit, even if a later ".." would have
+ * taken it back. With STRSAFE_IGNORE_NULLS, NULL paths are treated as
+ * empty.
+ */
+#ifdef UNICODE
+    #define StringCchPathCombine StringCchPathCombineW
+    #define StringCchPathCombineEx StringCchPathCombineExW
+#else
+    #define StringCchPathCombine StringCchPathCombineA
+    #define StringCchPathCombineEx StringCchPathCombineExA
+#endif
+HRESULT StringCchPathCombineA(
+    LPSTR pszDest,
+    size_t cchDest,
+    LPCSTR pszDir,
+    LPCSTR pszFile
+);
+HRESULT StringCchPathCombineW(
+    LPWSTR pszDest,
+    size_t cchDest,
+    LPCWSTR pszDir,
+    LPCWSTR pszFile
+);
+HRESULT StringCchPathCombineExA(
+    LPSTR pszDest,
+    size_t cchDest,
+    LPCSTR pszDir,
+    LPCSTR pszFile,
+    LPSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+HRESULT StringCchPathCombineExW(
+    LPWSTR pszDest,
+    size_t cchDest,
+    LPCWSTR pszDir,
+    LPCWSTR pszFile,
+    LPWSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+
+/*
+ * Edit pszDest in place. StringCchReplaceRangeEx replaces the cchCount
+ * characters that start at cchOffset with pszSrc, StringCchInsertEx
+ * inserts pszSrc at cchOffset and StringCchDelete removes the cchCount
+ * characters that start at cchOffset. A range that goes past the end of
+ * pszDest ends at the end of it, and a cchOffset past the end of pszDest
+ * is an invalid parameter. The characters behind the range are moved once
+ * and pszSrc must not overlap pszDest. If the result does not fit, it is
+ * truncated to its first cchDest - 1 characters, and dwFlags works like
+ * for StringCchCatEx. *ppszDestEnd is set to the end of the result so
+ * further edits do not have to measure pszDest again.
+ */
+#ifdef UNICODE
+    #define StringCchInsertEx StringCchInsertExW
+    #define StringCchDelete StringCchDeleteW
+    #define StringCchReplaceRangeEx StringCchReplaceRangeExW
+#else
+    #define StringCchInsertEx StringCchInsertExA
+    #define StringCchDelete StringCchDeleteA
+    #define StringCchReplaceRangeEx StringCchReplaceRangeExA
+#endif
+HRESULT StringCchInsertExA(
+    LPSTR pszDest,
+    size_t cchDest,
+    size_t cchOffset,
+    LPCSTR pszSrc,
+    LPSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+HRESULT StringCchInsertExW(
+    LPWSTR pszDest,
+    size_t cchDest,
+    size_t cchOffset,
+    LPCWSTR pszSrc,
+    LPWSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+HRESULT StringCchDeleteA(
+    LPSTR pszDest,
+    size_t cchDest,
+    size_t cchOffset,
+    size_t cchCount,
+    LPSTR * ppszDestEnd
+);
+HRESULT StringCchDeleteW(
+    LPWSTR pszDest,
+    size_t cchDest,
+    size_t cchOffset,
+    size_t cchCount,
+    LPWSTR * ppszDestEnd
+);
+HRESULT StringCchReplaceRangeExA(
+    LPSTR pszDest,
+    size_t cchDest,
+    size_t cchOffset,
+    size_t cchCount,
+    LPCSTR pszSrc,
+    LPSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+HRESULT StringCchReplaceRangeExW(
+    LPWSTR pszDest,
+    size_t cchDest,
+    size_t cchOffset,
+    size_t cchCount,
+    LPCWSTR pszSrc,
+    LPWSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+
 #ifdef UNICODE
     #define StringCchCopy StringCchCopyW
 #else
@@ -255,6 +597,33 @@ HRESULT StringCchCopyExW(
     DWORD dwFlags
 );
 
+/*
+ * See StringCchCatEx2 for *pcchRequired.
+ */
+#ifdef UNICODE
+    #define StringCchCopyEx2 StringCchCopyEx2W
+#else
+    #define StringCchCopyEx2 StringCchCopyEx2A
+#endif
+HRESULT StringCchCopyEx2A(
+    LPSTR pszDest,
+    size_t cchDest,
+    LPCSTR pszSrc,
+    LPSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags,
+    size_t * pcchRequired
+);
+HRESULT StringCchCopyEx2W(
+    LPWSTR pszDest,
+    size_t cchDest,
+    LPCWSTR pszSrc,
+    LPWSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags,
+    size_t * pcchRequired
+);
+
 #ifdef UNICODE
     #define StringCchCopyN StringCchCopyNW
 #else
@@ -331,6 +700,33 @@ HRESULT StringCchGetsExW(
     DWORD dwFlags
 );
 
+/*
+ * The FGets functions work like the Gets functions, but read a line from
+ * pStream instead of from stdin. pStream is locked once for each line, so
+ * other threads do not see half a line read.
+ */
+#ifdef UNICODE
+    #define StringCchFGetsEx StringCchFGetsExW
+#else
+    #define StringCchFGetsEx StringCchFGetsExA
+#endif
+HRESULT StringCchFGetsExA(
+    LPSTR pszDest,
+    size_t cchDest,
+    FILE * pStream,
+    LPSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+HRESULT StringCchFGetsExW(
+    LPWSTR pszDest,
+    size_t cchDest,
+    FILE * pStream,
+    LPWSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+
 #ifdef UNICODE
     #define StringCchPrintf StringCchPrintfW
 #else
@@ -625,6 +1021,28 @@ HRESULT StringCbGetsExW(
     DWORD dwFlags
 );
 
+#ifdef UNICODE
+    #define StringCbFGetsEx StringCbFGetsExW
+#else
+    #define StringCbFGetsEx StringCbFGetsExA
+#endif
+HRESULT StringCbFGetsExA(
+    LPSTR pszDest,
+    size_t cbDest,
+    FILE * pStream,
+    LPSTR * ppszDestEnd,
+    size_t * pcbRemaining,
+    DWORD dwFlags
+);
+HRESULT StringCbFGetsExW(
+    LPWSTR pszDest,
+    size_t cbDest,
+    FILE * pStream,
+    LPWSTR * ppszDestEnd,
+    size_t * pcbRemaining,
+    DWORD dwFlags
+);
+
 #ifdef UNICODE
     #define StringCbPrintf StringCbPrintfW
 #else
@@ -725,4 +1143,671 @@ HRESULT StringCbLengthW(
     size_t *pcb
 );
 
+/**
+ * Describes the kernels that the libstrsafe functions use to scan and copy
+ * strings. Each kernel is named after the instruction set it is written
+ * for, for example "avx2", "sse2", "swar" or "scalar".
+ */
+typedef struct STRSAFE_KERNEL_INFO {
+    /**
+     * The kernels that find the length of strings.
+     */
+    const char * pszLengthA;
+    const char * pszLengthW;
+
+    /**
+     * The kernels that copy strings.
+     */
+    const char * pszCopyA;
+    const char * pszCopyW;
+
+    /**
+     * How calls to the kernels are made. This is "ifunc" if the dynamic
+     * linker has bound the calls directly to the kernels and "table" if
+     * they are made through a table of function pointers.
+     */
+    const char * pszDispatch;
+} STRSAFE_KERNEL_INFO;
+
+/**
+ * Gets the kernels picked when the library was loaded. The kernels are
+ * the best ones for the processor unless the STRSAFE_KERNEL environment
+ * variable named another supported set when the program started. The
+ * variable is only used when the calls go through the table.
+ *
+ * @param pInfo The structure to fill in.
+ *
+ * @return S_OK, or STRSAFE_E_INVALID_PARAMETER if pInfo is NULL.
+ */
+HRESULT StrSafeGetKernelInfo(
+    STRSAFE_KERNEL_INFO * pInfo
+);
+
+/**
+ * Sets the size from which STRSAFE_FILL_BEHIND_NULL and
+ * STRSAFE_FILL_ON_FAILURE fill buffers with non-temporal stores, on
+ * processors that have them. These stores go straight to memory, so
+ * filling a large buffer does not push the data the program is working on
+ * out of the caches. Smaller fills use ordinary stores, which are faster
+ * when the buffer is used again soon. The size can also be set with the
+ * STRSAFE_FILL_THRESHOLD environment variable when the program starts and
+ * is 32768 bytes by default. It may be changed while other threads are
+ * using the library.
+ *
+ * @param cbThreshold The size in bytes. Fills of at least this many bytes
+ *                    use non-temporal stores.
+ *
+ * @return S_OK.
+ */
+HRESULT StrSafeSetFillThreshold(
+    size_t cbThreshold
+);
+
+/**
+ * Builds a string in a buffer piece by piece. The builder keeps track of
+ * the end of the string, so each append only costs as much as the piece
+ * that is appended, unlike a series of StringCchCatEx calls which all
+ * start by finding the end of the string.
+ *
+ * The dwFlags given to StringCchBuilderInit work like for the Ex
+ * functions, with the buffer as a whole taking the place of pszDest.
+ * STRSAFE_NO_TRUNCATION leaves the string as it was before a piece that
+ * does not fit. STRSAFE_NULL_ON_FAILURE and STRSAFE_FILL_ON_FAILURE apply
+ * to the whole buffer, after which the builder ignores further appends.
+ * STRSAFE_FILL_BEHIND_NULL fills the rest of the buffer once, in
+ * StringCchBuilderFinish.
+ *
+ * The members should not be changed other than through the
+ * StringCchBuilder functions.
+ */
+typedef struct STRSAFE_BUILDER_A {
+    /**
+     * The buffer the string is built in and its size in characters.
+     */
+    LPSTR pszDest;
+    size_t cchDest;
+
+    /**
+     * The null termination of the string and the number of characters
+     * from it to the end of the buffer, including the null termination.
+     */
+    LPSTR pszEnd;
+    size_t cchRemaining;
+
+    /**
+     * The flags given to StringCchBuilderInit.
+     */
+    DWORD dwFlags;
+
+    /**
+     * The result of the first call that failed, or S_OK.
+     */
+    HRESULT result;
+
+    /**
+     * Set when the buffer has been emptied or filled because of a failure.
+     */
+    int discarded;
+} STRSAFE_BUILDER_A;
+typedef struct STRSAFE_BUILDER_W {
+    LPWSTR pszDest;
+    size_t cchDest;
+    LPWSTR pszEnd;
+    size_t cchRemaining;
+    DWORD dwFlags;
+    HRESULT result;
+    int discarded;
+} STRSAFE_BUILDER_W;
+
+#ifdef UNICODE
+    #define STRSAFE_BUILDER STRSAFE_BUILDER_W
+    #define StringCchBuilderInit StringCchBuilderInitW
+    #define StringCchBuilderAppend StringCchBuilderAppendW
+    #define StringCchBuilderAppendN StringCchBuilderAppendNW
+    #define StringCchBuilderAppendChar StringCchBuilderAppendCharW
+    #define StringCchBuilderPrintf StringCchBuilderPrintfW
+    #define StringCchBuilderVPrintf StringCchBuilderVPrintfW
+    #define StringCchBuilderFinish StringCchBuilderFinishW
+#else
+    #define STRSAFE_BUILDER STRSAFE_BUILDER_A
+    #define StringCchBuilderInit StringCchBuilderInitA
+    #define StringCchBuilderAppend StringCchBuilderAppendA
+    #define StringCchBuilderAppendN StringCchBuilderAppendNA
+    #define StringCchBuilderAppendChar StringCchBuilderAppendCharA
+    #define StringCchBuilderPrintf StringCchBuilderPrintfA
+    #define StringCchBuilderVPrintf StringCchBuilderVPrintfA
+    #define StringCchBuilderFinish StringCchBuilderFinishA
+#endif
+
+/**
+ * Starts building a string in pszDest, which is set to the empty string.
+ *
+ * @param pBuilder The builder to initialize.
+ * @param pszDest The buffer to build the string in.
+ * @param cchDest The size of pszDest in characters.
+ * @param dwFlags The flags to use for the string, as for the Ex functions.
+ *
+ * @return S_OK, or STRSAFE_E_INVALID_PARAMETER if pBuilder or pszDest is
+ *         NULL or cchDest is 0 or larger than STRSAFE_MAX_CCH. The error is
+ *         also returned by all later calls for the builder.
+ */
+HRESULT StringCchBuilderInitA(
+    STRSAFE_BUILDER_A * pBuilder,
+    LPSTR pszDest,
+    size_t cchDest,
+    DWORD dwFlags
+);
+HRESULT StringCchBuilderInitW(
+    STRSAFE_BUILDER_W * pBuilder,
+    LPWSTR pszDest,
+    size_t cchDest,
+    DWORD dwFlags
+);
+
+/*
+ * The append functions return the result for the piece they append, the
+ * same as StringCchCatEx, StringCchCatNEx or StringCchPrintfEx would for
+ * the same string and buffer.
+ */
+HRESULT StringCchBuilderAppendA(
+    STRSAFE_BUILDER_A * pBuilder,
+    LPCSTR pszSrc
+);
+HRESULT StringCchBuilderAppendW(
+    STRSAFE_BUILDER_W * pBuilder,
+    LPCWSTR pszSrc
+);
+
+HRESULT StringCchBuilderAppendNA(
+    STRSAFE_BUILDER_A * pBuilder,
+    LPCSTR pszSrc,
+    size_t cchMaxAppend
+);
+HRESULT StringCchBuilderAppendNW(
+    STRSAFE_BUILDER_W * pBuilder,
+    LPCWSTR pszSrc,
+    size_t cchMaxAppend
+);
+
+HRESULT StringCchBuilderAppendCharA(
+    STRSAFE_BUILDER_A * pBuilder,
+    char ch
+);
+HRESULT StringCchBuilderAppendCharW(
+    STRSAFE_BUILDER_W * pBuilder,
+    wchar_t ch
+);
+
+HRESULT StringCchBuilderPrintfA(
+    STRSAFE_BUILDER_A * pBuilder,
+    LPCSTR pszFormat,
+    ...
+);
+HRESULT StringCchBuilderPrintfW(
+    STRSAFE_BUILDER_W * pBuilder,
+    LPCWSTR pszFormat,
+    ...
+);
+
+HRESULT StringCchBuilderVPrintfA(
+    STRSAFE_BUILDER_A * pBuilder,
+    LPCSTR pszFormat,
+    va_list argList
+);
+HRESULT StringCchBuilderVPrintfW(
+    STRSAFE_BUILDER_W * pBuilder,
+    LPCWSTR pszFormat,
+    va_list argList
+);
+
+/**
+ * Finishes building a string.
+ *
+ * @param pBuilder The builder.
+ * @param pcchLength Receives the length of the string, if not NULL.
+ *
+ * @return The result of the first call for the builder that failed, or
+ *         S_OK if all calls succeeded.
+ */
+HRESULT StringCchBuilderFinishA(
+    STRSAFE_BUILDER_A * pBuilder,
+    size_t * pcchLength
+);
+HRESULT StringCchBuilderFinishW(
+    STRSAFE_BUILDER_W * pBuilder,
+    size_t * pcchLength
+);
+
+/**
+ * The functions used to allocate the buffers of the Alloc functions.
+ */
+typedef struct STRSAFE_ALLOCATOR {
+    /**
+     * Works like realloc. Allocates a new block if pv is NULL.
+     *
+     * @param pContext The pContext member of the allocator.
+     * @param pv The block to resize, or NULL.
+     * @param cb The new size of the block in bytes.
+     *
+     * @return The resized block, or NULL if it could not be resized, in
+     *         which case pv is left as it was.
+     */
+    void * (*pfnRealloc)(void * pContext, void * pv, size_t cb);
+
+    /**
+     * Works like free.
+     *
+     * @param pContext The pContext member of the allocator.
+     * @param pv The block to free, or NULL.
+     */
+    void (*pfnFree)(void * pContext, void * pv);
+
+    /**
+     * Passed on to pfnRealloc and pfnFree.
+     */
+    void * pContext;
+} STRSAFE_ALLOCATOR;
+
+/**
+ * Sets the allocator used by the Alloc functions. This should be done
+ * before any buffers are allocated, since the buffers are later resized
+ * and freed with the allocator in use at that time.
+ *
+ * @param pAllocator The allocator to use, or NULL to use realloc and free.
+ *                   The structure is copied.
+ *
+ * @return S_OK, or STRSAFE_E_INVALID_PARAMETER if either function of the
+ *         allocator is NULL.
+ */
+HRESULT StrSafeSetAllocator(
+    const STRSAFE_ALLOCATOR * pAllocator
+);
+
+/**
+ * Frees a buffer allocated by the Alloc functions.
+ *
+ * @param pv The buffer to free, or NULL.
+ */
+void StrSafeFree(
+    void * pv
+);
+
+/*
+ * The Alloc functions work like the functions without Alloc, but the
+ * buffer is allocated with the allocator set by StrSafeSetAllocator and
+ * grown as needed. *ppszDest is the buffer and *pcchDest its size in
+ * characters. Both should be set to NULL and 0 before the first call, and
+ * the buffer should be freed with StrSafeFree once it is not needed. The
+ * buffer is only reallocated when the result does not fit in it, and then
+ * at least doubles in size, so it can be reused for many calls.
+ *
+ * The result can be at most STRSAFE_MAX_CCH - 1 characters long. If it
+ * would be longer, STRSAFE_E_INSUFFICIENT_BUFFER is returned, and if the
+ * buffer cannot be grown, STRSAFE_E_OUT_OF_MEMORY is. In both cases the
+ * buffer is kept. It then holds the empty string, or for StringCchCatAlloc
+ * the string it held before the call.
+ */
+#ifdef UNICODE
+    #define StringCchCopyAlloc StringCchCopyAllocW
+    #define StringCchCatAlloc StringCchCatAllocW
+    #define StringCchPrintfAlloc StringCchPrintfAllocW
+    #define StringCchVPrintfAlloc StringCchVPrintfAllocW
+#else
+    #define StringCchCopyAlloc StringCchCopyAllocA
+    #define StringCchCatAlloc StringCchCatAllocA
+    #define StringCchPrintfAlloc StringCchPrintfAllocA
+    #define StringCchVPrintfAlloc StringCchVPrintfAllocA
+#endif
+HRESULT StringCchCopyAllocA(
+    LPSTR * ppszDest,
+    size_t * pcchDest,
+    LPCSTR pszSrc
+);
+HRESULT StringCchCopyAllocW(
+    LPWSTR * ppszDest,
+    size_t * pcchDest,
+    LPCWSTR pszSrc
+);
+
+HRESULT StringCchCatAllocA(
+    LPSTR * ppszDest,
+    size_t * pcchDest,
+    LPCSTR pszSrc
+);
+HRESULT StringCchCatAllocW(
+    LPWSTR * ppszDest,
+    size_t * pcchDest,
+    LPCWSTR pszSrc
+);
+
+HRESULT StringCchPrintfAllocA(
+    LPSTR * ppszDest,
+    size_t * pcchDest,
+    LPCSTR pszFormat,
+    ...
+);
+HRESULT StringCchPrintfAllocW(
+    LPWSTR * ppszDest,
+    size_t * pcchDest,
+    LPCWSTR pszFormat,
+    ...
+);
+
+HRESULT StringCchVPrintfAllocA(
+    LPSTR * ppszDest,
+    size_t * pcchDest,
+    LPCSTR pszFormat,
+    va_list argList
+);
+HRESULT StringCchVPrintfAllocW(
+    LPWSTR * ppszDest,
+    size_t * pcchDest,
+    LPCWSTR pszFormat,
+    va_list argList
+);
+
+/**
+ * An arena that strings are allocated from. Memory is taken from the
+ * allocator set by StrSafeSetAllocator in large chunks, and the strings
+ * are placed one after the other in them. The strings are not freed one
+ * by one, but all at once by StrSafeArenaReset or StrSafeArenaDestroy.
+ * An arena must not be used by more than one thread at a time.
+ */
+typedef struct STRSAFE_ARENA STRSAFE_ARENA;
+
+/**
+ * Creates an arena.
+ *
+ * @param ppArena Receives the arena.
+ * @param cbChunk The size in bytes of the chunks of memory taken from the
+ *                allocator, or 0 for the default size. Strings larger than
+ *                a chunk get chunks of their own.
+ *
+ * @return S_OK, STRSAFE_E_INVALID_PARAMETER if ppArena is NULL or cbChunk
+ *         is too large to allocate, or STRSAFE_E_OUT_OF_MEMORY.
+ */
+HRESULT StrSafeArenaCreate(
+    STRSAFE_ARENA ** ppArena,
+    size_t cbChunk
+);
+
+/**
+ * Frees all strings of an arena at once. The chunks are kept and reused
+ * for the strings allocated after this.
+ *
+ * @param pArena The arena, or NULL.
+ */
+void StrSafeArenaReset(
+    STRSAFE_ARENA * pArena
+);
+
+/**
+ * Frees an arena along with all of its strings.
+ *
+ * @param pArena The arena, or NULL.
+ */
+void StrSafeArenaDestroy(
+    STRSAFE_ARENA * pArena
+);
+
+/*
+ * Functions that allocate strings from an arena. The new string is stored
+ * in *ppszDest. Dup copies pszSrc, DupN copies at most cchMaxCopy
+ * characters of it, Cat concatenates psz1 and psz2, which is done in place
+ * if psz1 is the last string allocated from the arena, and Printf formats
+ * a string. Strings are checked like by StringCchCatNEx and
+ * StringCchVPrintfEx. A string of STRSAFE_MAX_CCH characters or more
+ * gives STRSAFE_E_INSUFFICIENT_BUFFER and a failure to allocate memory
+ * gives STRSAFE_E_OUT_OF_MEMORY. *ppszDest is only set on success.
+ */
+#ifdef UNICODE
+    #define StringCchArenaDup StringCchArenaDupW
+    #define StringCchArenaDupN StringCchArenaDupNW
+    #define StringCchArenaCat StringCchArenaCatW
+    #define StringCchArenaPrintf StringCchArenaPrintfW
+    #define StringCchArenaVPrintf StringCchArenaVPrintfW
+#else
+    #define StringCchArenaDup StringCchArenaDupA
+    #define StringCchArenaDupN StringCchArenaDupNA
+    #define StringCchArenaCat StringCchArenaCatA
+    #define StringCchArenaPrintf StringCchArenaPrintfA
+    #define StringCchArenaVPrintf StringCchArenaVPrintfA
+#endif
+HRESULT StringCchArenaDupA(
+    STRSAFE_ARENA * pArena,
+    LPSTR * ppszDest,
+    LPCSTR pszSrc
+);
+HRESULT StringCchArenaDupW(
+    STRSAFE_ARENA * pArena,
+    LPWSTR * ppszDest,
+    LPCWSTR pszSrc
+);
+
+HRESULT StringCchArenaDupNA(
+    STRSAFE_ARENA * pArena,
+    LPSTR * ppszDest,
+    LPCSTR pszSrc,
+    size_t cchMaxCopy
+);
+HRESULT StringCchArenaDupNW(
+    STRSAFE_ARENA * pArena,
+    LPWSTR * ppszDest,
+    LPCWSTR pszSrc,
+    size_t cchMaxCopy
+);
+
+HRESULT StringCchArenaCatA(
+    STRSAFE_ARENA * pArena,
+    LPSTR * ppszDest,
+    LPCSTR psz1,
+    LPCSTR psz2
+);
+HRESULT StringCchArenaCatW(
+    STRSAFE_ARENA * pArena,
+    LPWSTR * ppszDest,
+    LPCWSTR psz1,
+    LPCWSTR psz2
+);
+
+HRESULT StringCchArenaPrintfA(
+    STRSAFE_ARENA * pArena,
+    LPSTR * ppszDest,
+    LPCSTR pszFormat,
+    ...
+);
+HRESULT StringCchArenaPrintfW(
+    STRSAFE_ARENA * pArena,
+    LPWSTR * ppszDest,
+    LPCWSTR pszFormat,
+    ...
+);
+
+HRESULT StringCchArenaVPrintfA(
+    STRSAFE_ARENA * pArena,
+    LPSTR * ppszDest,
+    LPCSTR pszFormat,
+    va_list argList
+);
+HRESULT StringCchArenaVPrintfW(
+    STRSAFE_ARENA * pArena,
+    LPWSTR * ppszDest,
+    LPCWSTR pszFormat,
+    va_list argList
+);
+
+/**
+ * Reads lines from a file descriptor without going through stdio. The
+ * reader reads large blocks into a buffer of its own and copies each line
+ * out of it, or returns where the line is in it. The buffer is taken from
+ * the allocator set by StrSafeSetAllocator. A reader must not be used by
+ * more than one thread at a time, and the file descriptor should not be
+ * read by anything else while the reader is in use, since the reader may
+ * have read ahead.
+ */
+typedef struct STRSAFE_READER STRSAFE_READER;
+
+/**
+ * Creates a reader.
+ *
+ * @param ppReader Receives the reader.
+ * @param fd The file descriptor to read from. It is not closed by the
+ *           reader.
+ * @param cbBuffer The size in bytes of the buffer, or 0 for the default
+ *                 size.
+ *
+ * @return S_OK, STRSAFE_E_INVALID_PARAMETER if ppReader is NULL or fd is
+ *         negative, or STRSAFE_E_OUT_OF_MEMORY.
+ */
+HRESULT StrSafeReaderCreate(
+    STRSAFE_READER ** ppReader,
+    int fd,
+    size_t cbBuffer
+);
+
+/**
+ * Creates a reader that maps the file into memory instead of reading it,
+ * if fd is a regular file. The lines are then returned straight from the
+ * mapping, from the current offset of fd to the end of the file as it was
+ * when the reader was created, and StringCchPeekLineA does not limit the
+ * length of a line to the size of a buffer. The kernel is told that the
+ * file will be read sequentially. For anything that cannot be mapped,
+ * such as a pipe, this creates the same reader as StrSafeReaderCreate.
+ * The file must not be truncated while the reader is in use.
+ *
+ * @param ppReader Receives the reader.
+ * @param fd The file descriptor to read from. It is not closed by the
+ *           reader.
+ * @param cbBuffer The size in bytes of the buffer if the file is not
+ *                 mapped, or 0 for the default size.
+ *
+ * @return S_OK, STRSAFE_E_INVALID_PARAMETER if ppReader is NULL or fd is
+ *         negative, or STRSAFE_E_OUT_OF_MEMORY.
+ */
+HRESULT StrSafeReaderCreateMapped(
+    STRSAFE_READER ** ppReader,
+    int fd,
+    size_t cbBuffer
+);
+
+/**
+ * Frees a reader and unmaps its file. The file descriptor is left open.
+ *
+ * @param pReader The reader, or NULL.
+ */
+void StrSafeReaderDestroy(
+    STRSAFE_READER * pReader
+);
+
+/**
+ * Reads a line from a reader. The results are the same as for
+ * StringCchGetsExA reading the same data from stdin: the line break is
+ * read but not stored, a line that does not fit is split and the rest of
+ * it is left for the next call, and STRSAFE_E_END_OF_FILE is returned
+ * once there is nothing left. A last line without a line break is
+ * returned like any other line, and the next call returns
+ * STRSAFE_E_END_OF_FILE. A read error ends the data like the end of the
+ * file does. Reads that are interrupted by a signal are restarted.
+ *
+ * @param pReader The reader.
+ * @param pszDest The buffer to store the line in.
+ * @param cchDest The size of pszDest in characters.
+ * @param ppszDestEnd Receives the end of the line in pszDest, or NULL.
+ * @param pcchRemaining Receives the number of characters left in pszDest,
+ *                      or NULL.
+ * @param dwFlags The flags, as for StringCchGetsExA.
+ *
+ * @return The same as StringCchGetsExA, or STRSAFE_E_INVALID_PARAMETER if
+ *         pReader is NULL.
+ */
+HRESULT StringCchReadLineExA(
+    STRSAFE_READER * pReader,
+    LPSTR pszDest,
+    size_t cchDest,
+    LPSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+
+/**
+ * Returns the next line of a reader without copying it. pLine is set to
+ * point to the line in the buffer of the reader, which stays valid until
+ * the next call that takes the reader. The line break is read but is not
+ * part of the line. A line that is split between two reads is moved
+ * within the buffer to make it whole, so a line can be no longer than the
+ * buffer less one character. A line that is longer than that or than
+ * cchMax is split, and the part that fits is returned along with
+ * STRSAFE_E_INSUFFICIENT_BUFFER. The rest is returned by the next call.
+ *
+ * @param pReader The reader.
+ * @param cchMax The maximum length of a line in characters.
+ * @param pLine Receives the line.
+ *
+ * @return S_OK, STRSAFE_E_INSUFFICIENT_BUFFER if the line was split,
+ *         STRSAFE_E_END_OF_FILE if there are no more lines, or
+ *         STRSAFE_E_INVALID_PARAMETER if pReader or pLine is NULL, if
+ *         cchMax is 0 or larger than STRSAFE_MAX_CCH, or if the buffer of
+ *         the reader is a single byte.
+ */
+HRESULT StringCchPeekLineA(
+    STRSAFE_READER * pReader,
+    size_t cchMax,
+    STRSAFE_SEGMENT_A * pLine
+);
+
+/*
+ * Inline versions of the functions that copy narrow strings, enabled by
+ * defining STRSAFE_INLINE before including strsafe.h. When the compiler
+ * can tell the length of pszSrc and the size of pszDest, and the string
+ * fits, the copy is done with fixed-size stores instead of a call into
+ * the library. All other calls go to the library functions, so the results
+ * are always the same. The inline versions need GCC or a compatible
+ * compiler with optimization turned on.
+ */
+#if defined(STRSAFE_INLINE) && defined(__GNUC__)
+
+#include <string.h>
+
+/**
+ * Copies a string whose length is known at compile time, or calls
+ * StringCchCopyA if it is not known that the string fits.
+ *
+ * @param pszDest The buffer to copy to.
+ * @param cchDest The size of pszDest in characters.
+ * @param pszSrc The string to copy.
+ * @param cbObject The size of the object pszDest points to, as returned by
+ *                 __builtin_object_size.
+ *
+ * @return The same result as StringCchCopyA.
+ */
+static __inline__ __attribute__((__always_inline__)) HRESULT
+strsafe_inline_copy_a(
+        LPSTR pszDest,
+        size_t cchDest,
+        LPCSTR pszSrc,
+        size_t cbObject){
+    if(__builtin_constant_p(cchDest) &&
+            __builtin_constant_p(pszDest != NULL) && pszDest != NULL &&
+            __builtin_constant_p(__builtin_strlen(pszSrc)) &&
+            cchDest != 0 && cchDest <= STRSAFE_MAX_CCH &&
+            __builtin_strlen(pszSrc) < cchDest &&
+            (cbObject == (size_t)-1 ||
+                    __builtin_strlen(pszSrc) < cbObject)){
+        memcpy(pszDest, pszSrc, __builtin_strlen(pszSrc) + 1);
+        return S_OK;
+    }
+    return (StringCchCopyA)(pszDest, cchDest, pszSrc);
+}
+
+/* StringCchCopyA is put in parentheses in strsafe_inline_copy_a so that
+ * the macro is not expanded there. */
+#define StringCchCopyA(pszDest, cchDest, pszSrc) \
+    strsafe_inline_copy_a((pszDest), (cchDest), (pszSrc), \
+            __builtin_object_size((pszDest), 1))
+#define StringCbCopyA(pszDest, cbDest, pszSrc) \
+    strsafe_inline_copy_a((pszDest), (cbDest), (pszSrc), \
+            __builtin_object_size((pszDest), 1))
+
+#endif /* STRSAFE_INLINE */
+
 #endif /* STRSAFE_H */
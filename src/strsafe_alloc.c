@@ -0,0 +1,383 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+#include "strsafe.h"
+#include "../config.h"
+#ifdef HAVE_ERRNO_H
+    #include <errno.h>
+#endif
+#ifdef HAVE_STDARG_H
+    #include <stdarg.h>
+#endif
+#ifdef HAVE_STDINT_H
+    #include <stdint.h>
+#endif
+#ifdef HAVE_STDIO_H
+    #include <stdio.h>
+#endif
+#ifdef HAVE_STDLIB_H
+    #include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+    #include <string.h>
+#endif
+#ifdef HAVE_WCHAR_H
+    #include <wchar.h>
+#endif
+#include "strsafe_kernel.h"
+
+/* The size of the first buffer allocated, in characters. */
+#define STRSAFE_ALLOC_MIN_CCH 64
+
+static void * strsafe_default_realloc(
+        void * pContext,
+        void * pv,
+        size_t cb){
+    (void)pContext;
+    return realloc(pv, cb);
+}
+
+static void strsafe_default_free(
+        void * pContext,
+        void * pv){
+    (void)pContext;
+    free(pv);
+}
+
+static STRSAFE_ALLOCATOR strsafe_allocator = {
+    strsafe_default_realloc,
+    strsafe_default_free,
+    NULL
+};
+
+HRESULT StrSafeSetAllocator(
+        const STRSAFE_ALLOCATOR * pAllocator){
+    if(pAllocator == NULL){
+        strsafe_allocator.pfnRealloc = strsafe_default_realloc;
+        strsafe_allocator.pfnFree = strsafe_default_free;
+        strsafe_allocator.pContext = NULL;
+        return S_OK;
+    }
+    if(pAllocator->pfnRealloc == NULL || pAllocator->pfnFree == NULL){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+
+    strsafe_allocator = *pAllocator;
+    return S_OK;
+}
+
+void * strsafe_realloc(
+        void * pv,
+        size_t cb){
+    return strsafe_allocator.pfnRealloc(strsafe_allocator.pContext, pv, cb);
+}
+
+void strsafe_free(
+        void * pv){
+    strsafe_allocator.pfnFree(strsafe_allocator.pContext, pv);
+}
+
+void StrSafeFree(
+        void * pv){
+    strsafe_free(pv);
+}
+
+/**
+ * Grows a buffer so that it holds at least cchRequired characters. The
+ * size is doubled until it is large enough, so that a buffer that is
+ * appended to over and over is only reallocated a few times.
+ *
+ * @param pv The buffer to grow, or NULL.
+ * @param pcch The size of the buffer in characters. It is updated if the
+ *             buffer is grown.
+ * @param cchRequired The number of characters needed. It must not be
+ *                    larger than STRSAFE_MAX_CCH.
+ * @param cbChar The size of a character in bytes.
+ *
+ * @return The grown buffer, or NULL if it could not be grown, in which case
+ *         pv is left as it was.
+ */
+static void * strsafe_alloc_grow(
+        void * pv,
+        size_t * pcch,
+        size_t cchRequired,
+        size_t cbChar){
+    size_t cchNew = *pcch < STRSAFE_ALLOC_MIN_CCH ?
+            STRSAFE_ALLOC_MIN_CCH : *pcch;
+    void * pvNew;
+
+    while(cchNew < cchRequired){
+        cchNew = cchNew > STRSAFE_MAX_CCH / 2 ? STRSAFE_MAX_CCH : cchNew * 2;
+    }
+    /* STRSAFE_MAX_CCH wide characters do not fit in a 32-bit size_t. */
+    if(cchNew > SIZE_MAX / cbChar){
+        return NULL;
+    }
+
+    pvNew = strsafe_realloc(pv, cchNew * cbChar);
+    if(pvNew != NULL){
+        *pcch = cchNew;
+    }
+
+    return pvNew;
+}
+
+/**
+ * Checks the buffer that is passed to the Alloc functions.
+ *
+ * @param pv The buffer.
+ * @param pcch The size of the buffer in characters. It is set to 0 if the
+ *             buffer has not been allocated yet.
+ *
+ * @return Non-zero if the buffer is valid.
+ */
+static int strsafe_alloc_check(
+        const void * pv,
+        size_t * pcch){
+    if(pcch == NULL){
+        return 0;
+    }
+    if(pv == NULL){
+        *pcch = 0;
+        return 1;
+    }
+    return *pcch != 0 && *pcch <= STRSAFE_MAX_CCH;
+}
+
+static HRESULT strsafe_alloc_cat_a(
+        LPSTR * ppszDest,
+        size_t * pcchDest,
+        LPCSTR pszSrc,
+        size_t destLength){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #include "strsafe_alloc_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT StringCchCopyAllocA(
+        LPSTR * ppszDest,
+        size_t * pcchDest,
+        LPCSTR pszSrc){
+    if(ppszDest == NULL || !strsafe_alloc_check(*ppszDest, pcchDest)){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+
+    return strsafe_alloc_cat_a(ppszDest, pcchDest, pszSrc, 0);
+}
+
+HRESULT StringCchCatAllocA(
+        LPSTR * ppszDest,
+        size_t * pcchDest,
+        LPCSTR pszSrc){
+    size_t destLength = 0;
+
+    if(ppszDest == NULL || !strsafe_alloc_check(*ppszDest, pcchDest)){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+    if(*ppszDest != NULL){
+        destLength = strsafe_length_a(*ppszDest, *pcchDest);
+        if(destLength == *pcchDest){
+            /* *ppszDest not null terminated. */
+            return STRSAFE_E_INVALID_PARAMETER;
+        }
+    }
+
+    return strsafe_alloc_cat_a(ppszDest, pcchDest, pszSrc, destLength);
+}
+
+static HRESULT strsafe_alloc_vprintf_a(
+        LPSTR * ppszDest,
+        size_t * pcchDest,
+        LPCSTR pszFormat,
+        va_list argList){
+    int length;
+    va_list argCopy;
+
+    if(ppszDest == NULL || !strsafe_alloc_check(*ppszDest, pcchDest) ||
+            pszFormat == NULL){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+    if(*ppszDest == NULL){
+        LPSTR pszDest = strsafe_alloc_grow(NULL, pcchDest, 1,
+                sizeof(char));
+        if(pszDest == NULL){
+            return STRSAFE_E_OUT_OF_MEMORY;
+        }
+        *ppszDest = pszDest;
+    }
+
+    /* Format straight into the buffer. Only if the result does not fit
+     * is it formatted again, into a buffer of the size vsnprintf asked
+     * for. */
+    va_copy(argCopy, argList);
+    length = vsnprintf(*ppszDest, *pcchDest, pszFormat, argCopy);
+    va_end(argCopy);
+    if(length >= 0 && (size_t)length < *pcchDest){
+        return S_OK;
+    }
+
+    **ppszDest = '\0';
+    if(length < 0){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+    if((size_t)length >= STRSAFE_MAX_CCH){
+        return STRSAFE_E_INSUFFICIENT_BUFFER;
+    }
+    {
+        LPSTR pszDest = strsafe_alloc_grow(*ppszDest, pcchDest,
+                (size_t)length + 1, sizeof(char));
+        if(pszDest == NULL){
+            return STRSAFE_E_OUT_OF_MEMORY;
+        }
+        *ppszDest = pszDest;
+    }
+    vsnprintf(*ppszDest, *pcchDest, pszFormat, argList);
+
+    return S_OK;
+}
+
+HRESULT StringCchVPrintfAllocA(
+        LPSTR * ppszDest,
+        size_t * pcchDest,
+        LPCSTR pszFormat,
+        va_list argList){
+    return strsafe_alloc_vprintf_a(ppszDest, pcchDest, pszFormat, argList);
+}
+
+HRESULT StringCchPrintfAllocA(
+        LPSTR * ppszDest,
+        size_t * pcchDest,
+        LPCSTR pszFormat,
+        ...){
+    va_list argList;
+    HRESULT result;
+
+    va_start(argList, pszFormat);
+    result = strsafe_alloc_vprintf_a(ppszDest, pcchDest, pszFormat,
+            argList);
+    va_end(argList);
+
+    return result;
+}
+
+static HRESULT strsafe_alloc_cat_w(
+        LPWSTR * ppszDest,
+        size_t * pcchDest,
+        LPCWSTR pszSrc,
+        size_t destLength){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #include "strsafe_alloc_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT StringCchCopyAllocW(
+        LPWSTR * ppszDest,
+        size_t * pcchDest,
+        LPCWSTR pszSrc){
+    if(ppszDest == NULL || !strsafe_alloc_check(*ppszDest, pcchDest)){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+
+    return strsafe_alloc_cat_w(ppszDest, pcchDest, pszSrc, 0);
+}
+
+HRESULT StringCchCatAllocW(
+        LPWSTR * ppszDest,
+        size_t * pcchDest,
+        LPCWSTR pszSrc){
+    size_t destLength = 0;
+
+    if(ppszDest == NULL || !strsafe_alloc_check(*ppszDest, pcchDest)){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+    if(*ppszDest != NULL){
+        destLength = strsafe_length_w(*ppszDest, *pcchDest);
+        if(destLength == *pcchDest){
+            /* *ppszDest not null terminated. */
+            return STRSAFE_E_INVALID_PARAMETER;
+        }
+    }
+
+    return strsafe_alloc_cat_w(ppszDest, pcchDest, pszSrc, destLength);
+}
+
+static HRESULT strsafe_alloc_vprintf_w(
+        LPWSTR * ppszDest,
+        size_t * pcchDest,
+        LPCWSTR pszFormat,
+        va_list argList){
+    if(ppszDest == NULL || !strsafe_alloc_check(*ppszDest, pcchDest) ||
+            pszFormat == NULL){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+    if(*ppszDest == NULL){
+        LPWSTR pszDest = strsafe_alloc_grow(NULL, pcchDest, 1,
+                sizeof(wchar_t));
+        if(pszDest == NULL){
+            return STRSAFE_E_OUT_OF_MEMORY;
+        }
+        *ppszDest = pszDest;
+    }
+
+    /* vswprintf does not tell how much space it needs, so the buffer is
+     * doubled until the result fits. A result that does not fit fills the
+     * buffer, so a failure that leaves room in it is an error in the
+     * format or the arguments. */
+    for(;;){
+        LPWSTR pszDest;
+        int length;
+        int filled;
+        va_list argCopy;
+
+        errno = 0;
+        va_copy(argCopy, argList);
+        length = vswprintf(*ppszDest, *pcchDest, pszFormat, argCopy);
+        va_end(argCopy);
+        if(length >= 0 && (size_t)length < *pcchDest){
+            return S_OK;
+        }
+
+        filled = strsafe_length_w(*ppszDest, *pcchDest) >= *pcchDest - 1;
+        **ppszDest = L'\0';
+        if(!filled || errno == EILSEQ){
+            return STRSAFE_E_INVALID_PARAMETER;
+        }
+        if(*pcchDest == STRSAFE_MAX_CCH){
+            return STRSAFE_E_INSUFFICIENT_BUFFER;
+        }
+        pszDest = strsafe_alloc_grow(*ppszDest, pcchDest, *pcchDest + 1,
+                sizeof(wchar_t));
+        if(pszDest == NULL){
+            return STRSAFE_E_OUT_OF_MEMORY;
+        }
+        *ppszDest = pszDest;
+    }
+}
+
+HRESULT StringCchVPrintfAllocW(
+        LPWSTR * ppszDest,
+        size_t * pcchDest,
+        LPCWSTR pszFormat,
+        va_list argList){
+    return strsafe_alloc_vprintf_w(ppszDest, pcchDest, pszFormat, argList);
+}
+
+HRESULT StringCchPrintfAllocW(
+        LPWSTR * ppszDest,
+        size_t * pcchDest,
+        LPCWSTR pszFormat,
+        ...){
+    va_list argList;
+    HRESULT result;
+
+    va_start(argList, pszFormat);
+    result = strsafe_alloc_vprintf_w(ppszDest, pcchDest, pszFormat,
+            argList);
+    va_end(argList);
+
+    return result;
+}
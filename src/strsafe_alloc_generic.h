@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Internal header for generic implementation of the Alloc functions that
+ * copy and concatenate strings. The including function appends pszSrc at
+ * destLength in the buffer described by ppszDest and pcchDest, which has
+ * already been checked.
+ */
+
+#ifndef STRSAFE_GENERIC_WIDE_CHAR
+#error "STRSAFE_GENERIC_WIDE_CHAR must be defined."
+#elif STRSAFE_GENERIC_WIDE_CHAR == 0
+#define STRSAFE_LENGTH_KERNEL strsafe_length_a
+#define STRSAFE_COPY_KERNEL strsafe_copy_a
+#define STRSAFE_CHAR char
+#define STRSAFE_TEXT(c) c
+#else
+#define STRSAFE_LENGTH_KERNEL strsafe_length_w
+#define STRSAFE_COPY_KERNEL strsafe_copy_w
+#define STRSAFE_CHAR wchar_t
+#define STRSAFE_TEXT(c) L##c
+#endif
+
+STRSAFE_CHAR * pszDest = *ppszDest;
+size_t srcLength;
+size_t copied = 0;
+
+if(pszSrc == NULL){
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+
+if(pszDest != NULL){
+    /* Use the space that is left in the buffer first, while looking for
+     * the null termination of pszSrc. */
+    copied = STRSAFE_COPY_KERNEL(pszDest + destLength, pszSrc,
+            *pcchDest - destLength - 1);
+    if(pszSrc[copied] == STRSAFE_TEXT('\0')){
+        pszDest[destLength + copied] = STRSAFE_TEXT('\0');
+        return S_OK;
+    }
+}
+
+/* Find the rest of the length of pszSrc, starting where the copy stopped. */
+srcLength = copied + STRSAFE_LENGTH_KERNEL(pszSrc + copied,
+        STRSAFE_MAX_CCH - destLength - copied);
+if(destLength + srcLength >= STRSAFE_MAX_CCH){
+    /* The result would be too long. */
+    if(pszDest != NULL){
+        pszDest[destLength] = STRSAFE_TEXT('\0');
+    }
+    return STRSAFE_E_INSUFFICIENT_BUFFER;
+}
+
+pszDest = strsafe_alloc_grow(pszDest, pcchDest,
+        destLength + srcLength + 1, sizeof(STRSAFE_CHAR));
+if(pszDest == NULL){
+    if(*ppszDest != NULL){
+        (*ppszDest)[destLength] = STRSAFE_TEXT('\0');
+    }
+    return STRSAFE_E_OUT_OF_MEMORY;
+}
+*ppszDest = pszDest;
+
+memcpy(pszDest + destLength + copied, pszSrc + copied,
+        (srcLength - copied) * sizeof(STRSAFE_CHAR));
+pszDest[destLength + srcLength] = STRSAFE_TEXT('\0');
+
+return S_OK;
+
+#undef STRSAFE_LENGTH_KERNEL
+#undef STRSAFE_COPY_KERNEL
+#undef STRSAFE_CHAR
+#undef STRSAFE_TEXT
@@ -0,0 +1,664 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+#include "strsafe.h"
+#include "../config.h"
+#ifdef HAVE_ERRNO_H
+    #include <errno.h>
+#endif
+#ifdef HAVE_STDARG_H
+    #include <stdarg.h>
+#endif
+#ifdef HAVE_STDINT_H
+    #include <stdint.h>
+#endif
+#ifdef HAVE_STDIO_H
+    #include <stdio.h>
+#endif
+#ifdef HAVE_STRING_H
+    #include <string.h>
+#endif
+#ifdef HAVE_WCHAR_H
+    #include <wchar.h>
+#endif
+#include "strsafe_kernel.h"
+
+/* The size of the chunks when the caller does not pick one, in bytes. */
+#define STRSAFE_ARENA_DEFAULT_CHUNK 4096
+
+/**
+ * A block of memory that strings are allocated from. The data follows
+ * right after the header.
+ */
+typedef struct strsafe_arena_chunk {
+    /**
+     * The next chunk, or NULL.
+     */
+    struct strsafe_arena_chunk * pNext;
+
+    /**
+     * The size of the data in bytes.
+     */
+    size_t cbData;
+} strsafe_arena_chunk;
+
+struct STRSAFE_ARENA {
+    /**
+     * The first chunk. The chunks are kept in a list and are used in
+     * order, so after a reset the same chunks are filled again.
+     */
+    strsafe_arena_chunk * pFirst;
+
+    /**
+     * The chunk that strings are allocated from, or NULL if there is no
+     * chunk yet.
+     */
+    strsafe_arena_chunk * pCurrent;
+
+    /**
+     * The first free byte and the end of the data of pCurrent.
+     */
+    char * pFree;
+    char * pEnd;
+
+    /**
+     * The string allocated last, which can be extended in place by the
+     * Cat functions, or NULL.
+     */
+    char * pLast;
+
+    /**
+     * The size of the data of new chunks in bytes.
+     */
+    size_t cbChunk;
+};
+
+static char * strsafe_arena_data(
+        strsafe_arena_chunk * pChunk){
+    return (char *)(pChunk + 1);
+}
+
+/**
+ * Makes pChunk the chunk to allocate from. The string allocated last is
+ * in another chunk, so it can no longer be extended in place.
+ */
+static void strsafe_arena_use(
+        STRSAFE_ARENA * pArena,
+        strsafe_arena_chunk * pChunk){
+    pArena->pCurrent = pChunk;
+    pArena->pLast = NULL;
+    pArena->pFree = strsafe_arena_data(pChunk);
+    pArena->pEnd = pArena->pFree + pChunk->cbData;
+}
+
+/**
+ * Finds space for a string of at least cch characters. The space is not
+ * allocated until it is committed, so the caller may write to all of the
+ * space up to pArena->pEnd first and then only keep what it needs. If the
+ * current chunk is too small, the next chunk is used if it is large enough
+ * and otherwise a new chunk is put in front of it.
+ *
+ * @param pArena The arena.
+ * @param cch The number of characters needed.
+ * @param cbChar The size of a character in bytes, which is also the
+ *               alignment of the string.
+ *
+ * @return The space, or NULL if no memory could be allocated.
+ */
+static void * strsafe_arena_reserve(
+        STRSAFE_ARENA * pArena,
+        size_t cch,
+        size_t cbChar){
+    strsafe_arena_chunk * pChunk;
+    size_t cbData;
+    size_t cb;
+
+    if(cch > (SIZE_MAX - sizeof(strsafe_arena_chunk)) / cbChar){
+        return NULL;
+    }
+    cb = cch * cbChar;
+
+    if(pArena->pCurrent != NULL){
+        size_t misalignment = (size_t)(uintptr_t)pArena->pFree % cbChar;
+        char * pFree = pArena->pFree +
+                (misalignment == 0 ? 0 : cbChar - misalignment);
+        if(pFree <= pArena->pEnd && (size_t)(pArena->pEnd - pFree) >= cb){
+            pArena->pFree = pFree;
+            return pFree;
+        }
+
+        pChunk = pArena->pCurrent->pNext;
+        if(pChunk != NULL && pChunk->cbData >= cb){
+            strsafe_arena_use(pArena, pChunk);
+            return pArena->pFree;
+        }
+    }
+
+    cbData = cb > pArena->cbChunk ? cb : pArena->cbChunk;
+    pChunk = strsafe_realloc(NULL, sizeof(strsafe_arena_chunk) + cbData);
+    if(pChunk == NULL){
+        return NULL;
+    }
+    pChunk->cbData = cbData;
+    if(pArena->pCurrent == NULL){
+        pChunk->pNext = pArena->pFirst;
+        pArena->pFirst = pChunk;
+    } else {
+        pChunk->pNext = pArena->pCurrent->pNext;
+        pArena->pCurrent->pNext = pChunk;
+    }
+    strsafe_arena_use(pArena, pChunk);
+
+    return pArena->pFree;
+}
+
+/**
+ * Returns the number of characters of space at pv, which was returned by
+ * strsafe_arena_reserve. Strings cannot be longer than STRSAFE_MAX_CCH
+ * characters, so there is no need to use more space than that.
+ */
+static size_t strsafe_arena_space(
+        const STRSAFE_ARENA * pArena,
+        const void * pv,
+        size_t cbChar){
+    size_t cch = (size_t)(pArena->pEnd - (const char *)pv) / cbChar;
+
+    return cch < STRSAFE_MAX_CCH ? cch : STRSAFE_MAX_CCH;
+}
+
+/**
+ * Allocates a string of cch characters, including the null termination,
+ * at pv, which was returned by strsafe_arena_reserve.
+ */
+static void strsafe_arena_commit(
+        STRSAFE_ARENA * pArena,
+        void * pv,
+        size_t cch,
+        size_t cbChar){
+    pArena->pLast = pv;
+    pArena->pFree = (char *)pv + cch * cbChar;
+}
+
+/**
+ * Allocates a copy of the first cch characters of pvSrc followed by a null
+ * termination.
+ *
+ * @return The copy, or NULL if no memory could be allocated.
+ */
+static void * strsafe_arena_copy(
+        STRSAFE_ARENA * pArena,
+        const void * pvSrc,
+        size_t cch,
+        size_t cbChar){
+    char * pDest = strsafe_arena_reserve(pArena, cch + 1, cbChar);
+
+    if(pDest == NULL){
+        return NULL;
+    }
+    memcpy(pDest, pvSrc, cch * cbChar);
+    memset(pDest + cch * cbChar, 0, cbChar);
+    strsafe_arena_commit(pArena, pDest, cch + 1, cbChar);
+
+    return pDest;
+}
+
+/**
+ * Allocates the concatenation of two strings of known length. If pv1 is
+ * the string allocated last and there is room behind it, pv2 is appended
+ * to it in place.
+ *
+ * @return The concatenation, or NULL if no memory could be allocated.
+ */
+static void * strsafe_arena_cat(
+        STRSAFE_ARENA * pArena,
+        const void * pv1,
+        size_t cch1,
+        const void * pv2,
+        size_t cch2,
+        size_t cbChar){
+    char * pDest;
+
+    if(pv1 == pArena->pLast && pArena->pLast != NULL &&
+            (size_t)(pArena->pEnd - pArena->pLast) / cbChar > cch1 + cch2){
+        /* pv1 is written through pLast. If pv2 is a part of pv1, it lies
+         * in front of where it is copied to, so the copies do not
+         * overlap. */
+        pDest = pArena->pLast;
+        memcpy(pDest + cch1 * cbChar, pv2, cch2 * cbChar);
+    } else {
+        pDest = strsafe_arena_reserve(pArena, cch1 + cch2 + 1, cbChar);
+        if(pDest == NULL){
+            return NULL;
+        }
+        memcpy(pDest, pv1, cch1 * cbChar);
+        memcpy(pDest + cch1 * cbChar, pv2, cch2 * cbChar);
+    }
+    memset(pDest + (cch1 + cch2) * cbChar, 0, cbChar);
+    strsafe_arena_commit(pArena, pDest, cch1 + cch2 + 1, cbChar);
+
+    return pDest;
+}
+
+HRESULT StrSafeArenaCreate(
+        STRSAFE_ARENA ** ppArena,
+        size_t cbChunk){
+    STRSAFE_ARENA * pArena;
+
+    /* A chunk is allocated together with its header, so the size of the
+     * two must not overflow. */
+    if(ppArena == NULL ||
+            cbChunk > SIZE_MAX - sizeof(strsafe_arena_chunk)){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+
+    pArena = strsafe_realloc(NULL, sizeof(STRSAFE_ARENA));
+    if(pArena == NULL){
+        return STRSAFE_E_OUT_OF_MEMORY;
+    }
+    pArena->pFirst = NULL;
+    pArena->pCurrent = NULL;
+    pArena->pFree = NULL;
+    pArena->pEnd = NULL;
+    pArena->pLast = NULL;
+    pArena->cbChunk = cbChunk == 0 ? STRSAFE_ARENA_DEFAULT_CHUNK : cbChunk;
+
+    *ppArena = pArena;
+    return S_OK;
+}
+
+void StrSafeArenaReset(
+        STRSAFE_ARENA * pArena){
+    if(pArena == NULL){
+        return;
+    }
+
+    if(pArena->pFirst == NULL){
+        return;
+    }
+    strsafe_arena_use(pArena, pArena->pFirst);
+}
+
+void StrSafeArenaDestroy(
+        STRSAFE_ARENA * pArena){
+    strsafe_arena_chunk * pChunk;
+
+    if(pArena == NULL){
+        return;
+    }
+
+    pChunk = pArena->pFirst;
+    while(pChunk != NULL){
+        strsafe_arena_chunk * pNext = pChunk->pNext;
+        strsafe_free(pChunk);
+        pChunk = pNext;
+    }
+    strsafe_free(pArena);
+}
+
+static HRESULT strsafe_arena_dupn_a(
+        STRSAFE_ARENA * pArena,
+        LPSTR * ppszDest,
+        LPCSTR pszSrc,
+        size_t cchMaxCopy){
+    char * pszDest;
+    char * pszDestEnd;
+    size_t required;
+    HRESULT result;
+
+    if(pArena == NULL || ppszDest == NULL || pszSrc == NULL){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+
+    /* Copy into the free space of the current chunk. Only if the string
+     * does not fit there is it copied again, to where there is room for
+     * the length that strsafe_catn_a_required found. */
+    pszDest = strsafe_arena_reserve(pArena, 1, sizeof(char));
+    if(pszDest == NULL){
+        return STRSAFE_E_OUT_OF_MEMORY;
+    }
+    *pszDest = '\0';
+    result = strsafe_catn_a_required(pszDest,
+            strsafe_arena_space(pArena, pszDest, sizeof(char)), pszSrc,
+            cchMaxCopy, &pszDestEnd, NULL, 0, &required);
+    if(SUCCEEDED(result)){
+        strsafe_arena_commit(pArena, pszDest,
+                (size_t)(pszDestEnd - pszDest) + 1, sizeof(char));
+        *ppszDest = pszDest;
+        return S_OK;
+    }
+    if(result != STRSAFE_E_INSUFFICIENT_BUFFER){
+        return result;
+    }
+    if(required >= STRSAFE_MAX_CCH){
+        return STRSAFE_E_INSUFFICIENT_BUFFER;
+    }
+
+    pszDest = strsafe_arena_copy(pArena, pszSrc, required, sizeof(char));
+    if(pszDest == NULL){
+        return STRSAFE_E_OUT_OF_MEMORY;
+    }
+
+    *ppszDest = pszDest;
+    return S_OK;
+}
+
+HRESULT StringCchArenaDupA(
+        STRSAFE_ARENA * pArena,
+        LPSTR * ppszDest,
+        LPCSTR pszSrc){
+    return strsafe_arena_dupn_a(pArena, ppszDest, pszSrc, STRSAFE_MAX_CCH);
+}
+
+HRESULT StringCchArenaDupNA(
+        STRSAFE_ARENA * pArena,
+        LPSTR * ppszDest,
+        LPCSTR pszSrc,
+        size_t cchMaxCopy){
+    return strsafe_arena_dupn_a(pArena, ppszDest, pszSrc, cchMaxCopy);
+}
+
+HRESULT StringCchArenaCatA(
+        STRSAFE_ARENA * pArena,
+        LPSTR * ppszDest,
+        LPCSTR psz1,
+        LPCSTR psz2){
+    size_t length1;
+    size_t length2;
+    char * pszDest;
+
+    if(pArena == NULL || ppszDest == NULL || psz1 == NULL || psz2 == NULL){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+
+    length1 = strsafe_length_a(psz1, STRSAFE_MAX_CCH);
+    if(length1 == STRSAFE_MAX_CCH){
+        return STRSAFE_E_INSUFFICIENT_BUFFER;
+    }
+    length2 = strsafe_length_a(psz2, STRSAFE_MAX_CCH - length1);
+    if(length1 + length2 == STRSAFE_MAX_CCH){
+        return STRSAFE_E_INSUFFICIENT_BUFFER;
+    }
+
+    pszDest = strsafe_arena_cat(pArena, psz1, length1, psz2, length2,
+            sizeof(char));
+    if(pszDest == NULL){
+        return STRSAFE_E_OUT_OF_MEMORY;
+    }
+
+    *ppszDest = pszDest;
+    return S_OK;
+}
+
+static HRESULT strsafe_arena_vprintf_a(
+        STRSAFE_ARENA * pArena,
+        LPSTR * ppszDest,
+        LPCSTR pszFormat,
+        va_list argList){
+    char * pszDest;
+    size_t cchSpace;
+    int length;
+    va_list argCopy;
+
+    if(pArena == NULL || ppszDest == NULL || pszFormat == NULL){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+
+    /* Format into the free space of the current chunk. Only if the result
+     * does not fit is it formatted again, into space of the size vsnprintf
+     * asked for. */
+    pszDest = strsafe_arena_reserve(pArena, 1, sizeof(char));
+    if(pszDest == NULL){
+        return STRSAFE_E_OUT_OF_MEMORY;
+    }
+    cchSpace = strsafe_arena_space(pArena, pszDest, sizeof(char));
+    va_copy(argCopy, argList);
+    length = vsnprintf(pszDest, cchSpace, pszFormat, argCopy);
+    va_end(argCopy);
+    if(length < 0){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+    if((size_t)length >= STRSAFE_MAX_CCH){
+        return STRSAFE_E_INSUFFICIENT_BUFFER;
+    }
+
+    if((size_t)length >= cchSpace){
+        pszDest = strsafe_arena_reserve(pArena, (size_t)length + 1,
+                sizeof(char));
+        if(pszDest == NULL){
+            return STRSAFE_E_OUT_OF_MEMORY;
+        }
+        vsnprintf(pszDest, (size_t)length + 1, pszFormat, argList);
+    }
+    strsafe_arena_commit(pArena, pszDest, (size_t)length + 1,
+            sizeof(char));
+
+    *ppszDest = pszDest;
+    return S_OK;
+}
+
+HRESULT StringCchArenaVPrintfA(
+        STRSAFE_ARENA * pArena,
+        LPSTR * ppszDest,
+        LPCSTR pszFormat,
+        va_list argList){
+    return strsafe_arena_vprintf_a(pArena, ppszDest, pszFormat, argList);
+}
+
+HRESULT StringCchArenaPrintfA(
+        STRSAFE_ARENA * pArena,
+        LPSTR * ppszDest,
+        LPCSTR pszFormat,
+        ...){
+    va_list argList;
+    HRESULT result;
+
+    va_start(argList, pszFormat);
+    result = strsafe_arena_vprintf_a(pArena, ppszDest, pszFormat, argList);
+    va_end(argList);
+
+    return result;
+}
+
+static HRESULT strsafe_arena_dupn_w(
+        STRSAFE_ARENA * pArena,
+        LPWSTR * ppszDest,
+        LPCWSTR pszSrc,
+        size_t cchMaxCopy){
+    wchar_t * pszDest;
+    wchar_t * pszDestEnd;
+    size_t required;
+    HRESULT result;
+
+    if(pArena == NULL || ppszDest == NULL || pszSrc == NULL){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+
+    pszDest = strsafe_arena_reserve(pArena, 1, sizeof(wchar_t));
+    if(pszDest == NULL){
+        return STRSAFE_E_OUT_OF_MEMORY;
+    }
+    *pszDest = L'\0';
+    result = strsafe_catn_w_required(pszDest,
+            strsafe_arena_space(pArena, pszDest, sizeof(wchar_t)), pszSrc,
+            cchMaxCopy, &pszDestEnd, NULL, 0, &required);
+    if(SUCCEEDED(result)){
+        strsafe_arena_commit(pArena, pszDest,
+                (size_t)(pszDestEnd - pszDest) + 1, sizeof(wchar_t));
+        *ppszDest = pszDest;
+        return S_OK;
+    }
+    if(result != STRSAFE_E_INSUFFICIENT_BUFFER){
+        return result;
+    }
+    if(required >= STRSAFE_MAX_CCH){
+        return STRSAFE_E_INSUFFICIENT_BUFFER;
+    }
+
+    pszDest = strsafe_arena_copy(pArena, pszSrc, required, sizeof(wchar_t));
+    if(pszDest == NULL){
+        return STRSAFE_E_OUT_OF_MEMORY;
+    }
+
+    *ppszDest = pszDest;
+    return S_OK;
+}
+
+HRESULT StringCchArenaDupW(
+        STRSAFE_ARENA * pArena,
+        LPWSTR * ppszDest,
+        LPCWSTR pszSrc){
+    return strsafe_arena_dupn_w(pArena, ppszDest, pszSrc, STRSAFE_MAX_CCH);
+}
+
+HRESULT StringCchArenaDupNW(
+        STRSAFE_ARENA * pArena,
+        LPWSTR * ppszDest,
+        LPCWSTR pszSrc,
+        size_t cchMaxCopy){
+    return strsafe_arena_dupn_w(pArena, ppszDest, pszSrc, cchMaxCopy);
+}
+
+HRESULT StringCchArenaCatW(
+        STRSAFE_ARENA * pArena,
+        LPWSTR * ppszDest,
+        LPCWSTR psz1,
+        LPCWSTR psz2){
+    size_t length1;
+    size_t length2;
+    wchar_t * pszDest;
+
+    if(pArena == NULL || ppszDest == NULL || psz1 == NULL || psz2 == NULL){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+
+    length1 = strsafe_length_w(psz1, STRSAFE_MAX_CCH);
+    if(length1 == STRSAFE_MAX_CCH){
+        return STRSAFE_E_INSUFFICIENT_BUFFER;
+    }
+    length2 = strsafe_length_w(psz2, STRSAFE_MAX_CCH - length1);
+    if(length1 + length2 == STRSAFE_MAX_CCH){
+        return STRSAFE_E_INSUFFICIENT_BUFFER;
+    }
+
+    pszDest = strsafe_arena_cat(pArena, psz1, length1, psz2, length2,
+            sizeof(wchar_t));
+    if(pszDest == NULL){
+        return STRSAFE_E_OUT_OF_MEMORY;
+    }
+
+    *ppszDest = pszDest;
+    return S_OK;
+}
+
+static HRESULT strsafe_arena_vprintf_w(
+        STRSAFE_ARENA * pArena,
+        LPWSTR * ppszDest,
+        LPCWSTR pszFormat,
+        va_list argList){
+    wchar_t * pszDest;
+    wchar_t * pszBuffer;
+    wchar_t * pszScratch = NULL;
+    size_t cchBuffer;
+    int length;
+    HRESULT result = S_OK;
+
+    if(pArena == NULL || ppszDest == NULL || pszFormat == NULL){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+
+    pszDest = strsafe_arena_reserve(pArena, 1, sizeof(wchar_t));
+    if(pszDest == NULL){
+        return STRSAFE_E_OUT_OF_MEMORY;
+    }
+
+    /* Format into the free space of the current chunk first. vswprintf
+     * does not tell how much space it needs, so if the result does not
+     * fit, it is formatted into a scratch buffer that is doubled until it
+     * does, and only then copied to the arena. A result that does not fit
+     * fills the buffer, so a failure that leaves room in it is an error in
+     * the format or the arguments. */
+    pszBuffer = pszDest;
+    cchBuffer = strsafe_arena_space(pArena, pszDest, sizeof(wchar_t));
+    for(;;){
+        va_list argCopy;
+
+        errno = 0;
+        va_copy(argCopy, argList);
+        length = vswprintf(pszBuffer, cchBuffer, pszFormat, argCopy);
+        va_end(argCopy);
+        if(length >= 0 && (size_t)length < cchBuffer){
+            break;
+        }
+
+        if(strsafe_length_w(pszBuffer, cchBuffer) < cchBuffer - 1 ||
+                errno == EILSEQ){
+            result = STRSAFE_E_INVALID_PARAMETER;
+            break;
+        }
+        if(cchBuffer == STRSAFE_MAX_CCH){
+            result = STRSAFE_E_INSUFFICIENT_BUFFER;
+            break;
+        }
+        cchBuffer = cchBuffer > STRSAFE_MAX_CCH / 2 ?
+                STRSAFE_MAX_CCH : cchBuffer * 2;
+
+        /* The old contents are not needed, so the buffer is not
+         * reallocated. */
+        strsafe_free(pszScratch);
+        pszScratch = NULL;
+        if(cchBuffer <= SIZE_MAX / sizeof(wchar_t)){
+            pszScratch = strsafe_realloc(NULL, cchBuffer * sizeof(wchar_t));
+        }
+        if(pszScratch == NULL){
+            result = STRSAFE_E_OUT_OF_MEMORY;
+            break;
+        }
+        pszBuffer = pszScratch;
+    }
+
+    if(SUCCEEDED(result)){
+        if(pszScratch == NULL){
+            strsafe_arena_commit(pArena, pszDest, (size_t)length + 1,
+                    sizeof(wchar_t));
+        } else {
+            pszDest = strsafe_arena_copy(pArena, pszScratch, (size_t)length,
+                    sizeof(wchar_t));
+            if(pszDest == NULL){
+                result = STRSAFE_E_OUT_OF_MEMORY;
+            }
+        }
+    }
+    strsafe_free(pszScratch);
+
+    if(SUCCEEDED(result)){
+        *ppszDest = pszDest;
+    }
+    return result;
+}
+
+HRESULT StringCchArenaVPrintfW(
+        STRSAFE_ARENA * pArena,
+        LPWSTR * ppszDest,
+        LPCWSTR pszFormat,
+        va_list argList){
+    return strsafe_arena_vprintf_w(pArena, ppszDest, pszFormat, argList);
+}
+
+HRESULT StringCchArenaPrintfW(
+        STRSAFE_ARENA * pArena,
+        LPWSTR * ppszDest,
+        LPCWSTR pszFormat,
+        ...){
+    va_list argList;
+    HRESULT result;
+
+    va_start(argList, pszFormat);
+    result = strsafe_arena_vprintf_w(pArena, ppszDest, pszFormat, argList);
+    va_end(argList);
+
+    return result;
+}
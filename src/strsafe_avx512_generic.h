@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Internal header for generic implementation of the AVX-512 kernels.
+ * Besides STRSAFE_GENERIC_WIDE_CHAR, the including function must define
+ * STRSAFE_AVX512_LOAD(mask, p), which loads the characters at p that are
+ * selected by mask, and STRSAFE_AVX512_ZEROS(mask, vector), which returns
+ * the selected lanes of vector that hold a null character. If
+ * STRSAFE_AVX512_STORE(p, mask, vector) is defined as well, the kernel
+ * copies pszSrc to pszDest, otherwise it finds the length of psz.
+ */
+
+#ifndef STRSAFE_GENERIC_WIDE_CHAR
+#error "STRSAFE_GENERIC_WIDE_CHAR must be defined."
+#elif STRSAFE_GENERIC_WIDE_CHAR == 0
+#define STRSAFE_CHAR char
+#ifdef STRSAFE_AVX512_STORE
+#define STRSAFE_SCALAR strsafe_copy_a_scalar(pszDest, pszSrc, cchMax)
+#else
+#define STRSAFE_SCALAR strsafe_length_a_scalar(psz, cchMax)
+#endif
+#else
+#define STRSAFE_CHAR wchar_t
+#ifdef STRSAFE_AVX512_STORE
+#define STRSAFE_SCALAR strsafe_copy_w_scalar(pszDest, pszSrc, cchMax)
+#else
+#define STRSAFE_SCALAR strsafe_length_w_scalar(psz, cchMax)
+#endif
+#endif
+
+#ifdef STRSAFE_AVX512_STORE
+#define STRSAFE_SOURCE pszSrc
+#else
+#define STRSAFE_SOURCE psz
+#endif
+
+size_t length = 0;
+
+if((uintptr_t)STRSAFE_SOURCE % sizeof(STRSAFE_CHAR) != 0){
+    /* The lanes of the vectors would not line up with the characters. */
+    return STRSAFE_SCALAR;
+}
+
+/* A short string is handled by the first one or two iterations, without
+ * any separate code for the start or the end of it. */
+while(length < cchMax){
+    /* Select the lanes up to the next aligned vector, so that no load
+     * crosses a page boundary, and no further than cchMax. Lanes that are
+     * not selected are neither read nor written. */
+    size_t count = (64 - (size_t)((uintptr_t)(STRSAFE_SOURCE + length) % 64))
+            / sizeof(STRSAFE_CHAR);
+    uint64_t mask;
+    uint64_t zeros;
+    __m512i vector;
+
+    if(count > cchMax - length){
+        count = cchMax - length;
+    }
+    mask = count >= 64 ? ~UINT64_C(0) : (UINT64_C(1) << count) - 1;
+    vector = STRSAFE_AVX512_LOAD(mask, STRSAFE_SOURCE + length);
+    zeros = STRSAFE_AVX512_ZEROS(mask, vector);
+    if(zeros != 0){
+        count = (size_t)__builtin_ctzll(zeros);
+#ifdef STRSAFE_AVX512_STORE
+        STRSAFE_AVX512_STORE(pszDest + length,
+                (UINT64_C(1) << count) - 1, vector);
+#endif
+        return length + count;
+    }
+#ifdef STRSAFE_AVX512_STORE
+    STRSAFE_AVX512_STORE(pszDest + length, mask, vector);
+#endif
+    length += count;
+}
+
+return cchMax;
+
+#undef STRSAFE_CHAR
+#undef STRSAFE_SCALAR
+#undef STRSAFE_SOURCE
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+#include "strsafe.h"
+#include "../config.h"
+#ifdef HAVE_STDARG_H
+    #include <stdarg.h>
+#endif
+#ifdef HAVE_STRING_H
+    #include <string.h>
+#endif
+#ifdef HAVE_WCHAR_H
+    #include <wchar.h>
+#endif
+#include "strsafe_internal.h"
+
+/*
+ * The pieces are appended with the same functions as StringCchCatNEx and
+ * StringCchVPrintfEx use, given the end of the string as the buffer. The
+ * string there is empty, so finding its end costs nothing. Those functions
+ * only get STRSAFE_IGNORE_NULLS and STRSAFE_NO_TRUNCATION. The flags that
+ * change the whole buffer on failure are handled by strsafe_builder_update
+ * and STRSAFE_FILL_BEHIND_NULL is handled when the string is finished.
+ */
+
+static DWORD strsafe_builder_flags(
+        DWORD dwFlags){
+    DWORD flags = dwFlags & STRSAFE_IGNORE_NULLS;
+
+    if(dwFlags & (STRSAFE_NO_TRUNCATION | STRSAFE_NULL_ON_FAILURE |
+            STRSAFE_FILL_ON_FAILURE)){
+        /* A truncated piece would not be kept. */
+        flags |= STRSAFE_NO_TRUNCATION;
+    }
+
+    return flags;
+}
+
+static HRESULT strsafe_builder_update_a(
+        STRSAFE_BUILDER_A * pBuilder,
+        HRESULT result,
+        LPSTR pszEnd,
+        size_t cchRemaining){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #define STRSAFE_GENERIC_BUILDER_UPDATE 1
+    #include "strsafe_builder_generic.h"
+    #undef STRSAFE_GENERIC_BUILDER_UPDATE
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT StringCchBuilderInitA(
+        STRSAFE_BUILDER_A * pBuilder,
+        LPSTR pszDest,
+        size_t cchDest,
+        DWORD dwFlags){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #define STRSAFE_GENERIC_BUILDER_INIT 1
+    #include "strsafe_builder_generic.h"
+    #undef STRSAFE_GENERIC_BUILDER_INIT
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+static HRESULT strsafe_builder_catn_a(
+        STRSAFE_BUILDER_A * pBuilder,
+        LPCSTR pszSrc,
+        size_t cchMaxAppend){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #define STRSAFE_GENERIC_BUILDER_CATN 1
+    #include "strsafe_builder_generic.h"
+    #undef STRSAFE_GENERIC_BUILDER_CATN
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT StringCchBuilderAppendA(
+        STRSAFE_BUILDER_A * pBuilder,
+        LPCSTR pszSrc){
+    if(pBuilder == NULL){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+
+    return strsafe_builder_catn_a(pBuilder, pszSrc, pBuilder->cchRemaining);
+}
+
+HRESULT StringCchBuilderAppendNA(
+        STRSAFE_BUILDER_A * pBuilder,
+        LPCSTR pszSrc,
+        size_t cchMaxAppend){
+    return strsafe_builder_catn_a(pBuilder, pszSrc, cchMaxAppend);
+}
+
+HRESULT StringCchBuilderAppendCharA(
+        STRSAFE_BUILDER_A * pBuilder,
+        char ch){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #define STRSAFE_GENERIC_BUILDER_APPEND_CHAR 1
+    #include "strsafe_builder_generic.h"
+    #undef STRSAFE_GENERIC_BUILDER_APPEND_CHAR
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+static HRESULT strsafe_builder_vprintf_a(
+        STRSAFE_BUILDER_A * pBuilder,
+        LPCSTR pszFormat,
+        va_list argList){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #define STRSAFE_GENERIC_BUILDER_VPRINTF 1
+    #include "strsafe_builder_generic.h"
+    #undef STRSAFE_GENERIC_BUILDER_VPRINTF
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT StringCchBuilderVPrintfA(
+        STRSAFE_BUILDER_A * pBuilder,
+        LPCSTR pszFormat,
+        va_list argList){
+    return strsafe_builder_vprintf_a(pBuilder, pszFormat, argList);
+}
+
+HRESULT StringCchBuilderPrintfA(
+        STRSAFE_BUILDER_A * pBuilder,
+        LPCSTR pszFormat,
+        ...){
+    va_list argList;
+    HRESULT result;
+
+    va_start(argList, pszFormat);
+    result = strsafe_builder_vprintf_a(pBuilder, pszFormat, argList);
+    va_end(argList);
+
+    return result;
+}
+
+HRESULT StringCchBuilderFinishA(
+        STRSAFE_BUILDER_A * pBuilder,
+        size_t * pcchLength){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #define STRSAFE_GENERIC_BUILDER_FINISH 1
+    #include "strsafe_builder_generic.h"
+    #undef STRSAFE_GENERIC_BUILDER_FINISH
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+static HRESULT strsafe_builder_update_w(
+        STRSAFE_BUILDER_W * pBuilder,
+        HRESULT result,
+        LPWSTR pszEnd,
+        size_t cchRemaining){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #define STRSAFE_GENERIC_BUILDER_UPDATE 1
+    #include "strsafe_builder_generic.h"
+    #undef STRSAFE_GENERIC_BUILDER_UPDATE
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT StringCchBuilderInitW(
+        STRSAFE_BUILDER_W * pBuilder,
+        LPWSTR pszDest,
+        size_t cchDest,
+        DWORD dwFlags){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #define STRSAFE_GENERIC_BUILDER_INIT 1
+    #include "strsafe_builder_generic.h"
+    #undef STRSAFE_GENERIC_BUILDER_INIT
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+static HRESULT strsafe_builder_catn_w(
+        STRSAFE_BUILDER_W * pBuilder,
+        LPCWSTR pszSrc,
+        size_t cchMaxAppend){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #define STRSAFE_GENERIC_BUILDER_CATN 1
+    #include "strsafe_builder_generic.h"
+    #undef STRSAFE_GENERIC_BUILDER_CATN
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT StringCchBuilderAppendW(
+        STRSAFE_BUILDER_W * pBuilder,
+        LPCWSTR pszSrc){
+    if(pBuilder == NULL){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+
+    return strsafe_builder_catn_w(pBuilder, pszSrc, pBuilder->cchRemaining);
+}
+
+HRESULT StringCchBuilderAppendNW(
+        STRSAFE_BUILDER_W * pBuilder,
+        LPCWSTR pszSrc,
+        size_t cchMaxAppend){
+    return strsafe_builder_catn_w(pBuilder, pszSrc, cchMaxAppend);
+}
+
+HRESULT StringCchBuilderAppendCharW(
+        STRSAFE_BUILDER_W * pBuilder,
+        wchar_t ch){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #define STRSAFE_GENERIC_BUILDER_APPEND_CHAR 1
+    #include "strsafe_builder_generic.h"
+    #undef STRSAFE_GENERIC_BUILDER_APPEND_CHAR
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+static HRESULT strsafe_builder_vprintf_w(
+        STRSAFE_BUILDER_W * pBuilder,
+        LPCWSTR pszFormat,
+        va_list argList){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #define STRSAFE_GENERIC_BUILDER_VPRINTF 1
+    #include "strsafe_builder_generic.h"
+    #undef STRSAFE_GENERIC_BUILDER_VPRINTF
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT StringCchBuilderVPrintfW(
+        STRSAFE_BUILDER_W * pBuilder,
+        LPCWSTR pszFormat,
+        va_list argList){
+    return strsafe_builder_vprintf_w(pBuilder, pszFormat, argList);
+}
+
+HRESULT StringCchBuilderPrintfW(
+        STRSAFE_BUILDER_W * pBuilder,
+        LPCWSTR pszFormat,
+        ...){
+    va_list argList;
+    HRESULT result;
+
+    va_start(argList, pszFormat);
+    result = strsafe_builder_vprintf_w(pBuilder, pszFormat, argList);
+    va_end(argList);
+
+    return result;
+}
+
+HRESULT StringCchBuilderFinishW(
+        STRSAFE_BUILDER_W * pBuilder,
+        size_t * pcchLength){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #define STRSAFE_GENERIC_BUILDER_FINISH 1
+    #include "strsafe_builder_generic.h"
+    #undef STRSAFE_GENERIC_BUILDER_FINISH
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Internal header for generic implementation of the StringCchBuilder
+ * functions. Besides STRSAFE_GENERIC_WIDE_CHAR, the including function
+ * defines one of the following to pick the body it gets:
+ *
+ * STRSAFE_GENERIC_BUILDER_INIT: Sets up pBuilder for pszDest, cchDest and
+ * dwFlags.
+ * STRSAFE_GENERIC_BUILDER_UPDATE: Records the result of appending a piece
+ * at the end of the string, given pszEnd and cchRemaining as they are
+ * after the piece.
+ * STRSAFE_GENERIC_BUILDER_CATN: Appends at most cchMaxAppend characters of
+ * pszSrc.
+ * STRSAFE_GENERIC_BUILDER_APPEND_CHAR: Appends ch.
+ * STRSAFE_GENERIC_BUILDER_VPRINTF: Appends pszFormat formatted with
+ * argList.
+ * STRSAFE_GENERIC_BUILDER_FINISH: Stores the length of the string in
+ * pcchLength and applies STRSAFE_FILL_BEHIND_NULL.
+ */
+
+#ifndef STRSAFE_GENERIC_WIDE_CHAR
+#error "STRSAFE_GENERIC_WIDE_CHAR must be defined."
+#elif STRSAFE_GENERIC_WIDE_CHAR == 0
+#define STRSAFE_CHAR char
+#define STRSAFE_TEXT(c) c
+#define STRSAFE_BUILDER_UPDATE strsafe_builder_update_a
+#define STRSAFE_CATN strsafe_catn_a
+#define STRSAFE_VPRINTF strsafe_vprintf_a
+#else
+#define STRSAFE_CHAR wchar_t
+#define STRSAFE_TEXT(c) L##c
+#define STRSAFE_BUILDER_UPDATE strsafe_builder_update_w
+#define STRSAFE_CATN strsafe_catn_w
+#define STRSAFE_VPRINTF strsafe_vprintf_w
+#endif
+
+#if defined(STRSAFE_GENERIC_BUILDER_INIT)
+
+if(pBuilder == NULL){
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+
+pBuilder->dwFlags = dwFlags;
+if(pszDest == NULL || cchDest == 0 || cchDest > STRSAFE_MAX_CCH){
+    /* Invalid buffer, every later call fails. */
+    pBuilder->pszDest = NULL;
+    pBuilder->cchDest = 0;
+    pBuilder->pszEnd = NULL;
+    pBuilder->cchRemaining = 0;
+    pBuilder->result = STRSAFE_E_INVALID_PARAMETER;
+    pBuilder->discarded = 1;
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+
+*pszDest = STRSAFE_TEXT('\0');
+pBuilder->pszDest = pszDest;
+pBuilder->cchDest = cchDest;
+pBuilder->pszEnd = pszDest;
+pBuilder->cchRemaining = cchDest;
+pBuilder->result = S_OK;
+pBuilder->discarded = 0;
+
+return S_OK;
+
+#elif defined(STRSAFE_GENERIC_BUILDER_UPDATE)
+
+if(FAILED(result)){
+    if(pBuilder->result == S_OK){
+        pBuilder->result = result;
+    }
+    if(!(pBuilder->dwFlags & STRSAFE_NO_TRUNCATION)){
+        if(pBuilder->dwFlags & STRSAFE_NULL_ON_FAILURE){
+            /* The whole string should be set to the empty string. */
+            *pBuilder->pszDest = STRSAFE_TEXT('\0');
+            pBuilder->pszEnd = pBuilder->pszDest;
+            pBuilder->cchRemaining = pBuilder->cchDest;
+            pBuilder->discarded = 1;
+            return result;
+        }
+        if(pBuilder->dwFlags & STRSAFE_FILL_ON_FAILURE){
+            /* The whole buffer should be filled with the lower byte of
+             * dwFlags and null terminated. */
+            strsafe_fill(pBuilder->pszDest, pBuilder->dwFlags & 0xff,
+                    (pBuilder->cchDest - 1) * sizeof(STRSAFE_CHAR));
+            pBuilder->pszDest[pBuilder->cchDest - 1] = STRSAFE_TEXT('\0');
+            pBuilder->pszEnd = pBuilder->pszDest + pBuilder->cchDest - 1;
+            pBuilder->cchRemaining = 1;
+            pBuilder->discarded = 1;
+            return result;
+        }
+    }
+}
+
+pBuilder->pszEnd = pszEnd;
+pBuilder->cchRemaining = cchRemaining;
+
+return result;
+
+#elif defined(STRSAFE_GENERIC_BUILDER_CATN)
+
+STRSAFE_CHAR * pszEnd;
+size_t cchRemaining;
+HRESULT result;
+
+if(pBuilder == NULL){
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+if(pBuilder->discarded){
+    return pBuilder->result;
+}
+
+pszEnd = pBuilder->pszEnd;
+cchRemaining = pBuilder->cchRemaining;
+result = STRSAFE_CATN(pszEnd, cchRemaining, pszSrc, cchMaxAppend,
+        &pszEnd, &cchRemaining, strsafe_builder_flags(pBuilder->dwFlags));
+
+return STRSAFE_BUILDER_UPDATE(pBuilder, result, pszEnd, cchRemaining);
+
+#elif defined(STRSAFE_GENERIC_BUILDER_APPEND_CHAR)
+
+if(pBuilder == NULL){
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+if(pBuilder->discarded){
+    return pBuilder->result;
+}
+
+if(ch == STRSAFE_TEXT('\0')){
+    /* Appending a null character leaves the string as it is. */
+    return S_OK;
+}
+if(pBuilder->cchRemaining == 1){
+    /* No room left for the character. */
+    return STRSAFE_BUILDER_UPDATE(pBuilder, STRSAFE_E_INSUFFICIENT_BUFFER,
+            pBuilder->pszEnd, 1);
+}
+
+pBuilder->pszEnd[0] = ch;
+pBuilder->pszEnd[1] = STRSAFE_TEXT('\0');
+pBuilder->pszEnd++;
+pBuilder->cchRemaining--;
+
+return S_OK;
+
+#elif defined(STRSAFE_GENERIC_BUILDER_VPRINTF)
+
+STRSAFE_CHAR * pszEnd;
+size_t cchRemaining;
+HRESULT result;
+
+if(pBuilder == NULL){
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+if(pBuilder->discarded){
+    return pBuilder->result;
+}
+
+pszEnd = pBuilder->pszEnd;
+cchRemaining = pBuilder->cchRemaining;
+result = STRSAFE_VPRINTF(pszEnd, cchRemaining, &pszEnd, &cchRemaining,
+        strsafe_builder_flags(pBuilder->dwFlags), pszFormat, argList);
+
+return STRSAFE_BUILDER_UPDATE(pBuilder, result, pszEnd, cchRemaining);
+
+#elif defined(STRSAFE_GENERIC_BUILDER_FINISH)
+
+if(pBuilder == NULL){
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+
+if(pcchLength != NULL){
+    *pcchLength = pBuilder->cchDest - pBuilder->cchRemaining;
+}
+if((pBuilder->dwFlags & STRSAFE_FILL_BEHIND_NULL) &&
+        !pBuilder->discarded && pBuilder->cchRemaining > 1){
+    strsafe_fill(pBuilder->pszEnd + 1, pBuilder->dwFlags & 0xff,
+            (pBuilder->cchRemaining - 1) * sizeof(STRSAFE_CHAR));
+}
+
+return pBuilder->result;
+
+#else
+#error "The StringCchBuilder body to generate must be defined."
+#endif
+
+#undef STRSAFE_CHAR
+#undef STRSAFE_TEXT
+#undef STRSAFE_BUILDER_UPDATE
+#undef STRSAFE_CATN
+#undef STRSAFE_VPRINTF
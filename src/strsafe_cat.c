@@ -16,19 +16,22 @@
 #ifdef HAVE_WCHAR_H
     #include <wchar.h>
 #endif
+#include "strsafe_internal.h"
 
 HRESULT StringCchCatA(
         LPSTR pszDest,
         size_t cchDest,
         LPCSTR pszSrc){
-    return StringCchCatNA(pszDest, cchDest, pszSrc, cchDest);
+    return strsafe_catn_a_no_flags(pszDest, cchDest, pszSrc, cchDest, NULL,
+            NULL);
 }
 
 HRESULT StringCchCatW(
         LPWSTR pszDest,
         size_t cchDest,
         LPCWSTR pszSrc){
-    return StringCchCatNW(pszDest, cchDest, pszSrc, cchDest);
+    return strsafe_catn_w_no_flags(pszDest, cchDest, pszSrc, cchDest, NULL,
+            NULL);
 }
 
 HRESULT StringCchCatExA(
@@ -38,8 +41,8 @@ HRESULT StringCchCatExA(
         LPSTR * ppszDestEnd,
         size_t * pcchRemaining,
         DWORD dwFlags){
-    return StringCchCatNExA(pszDest, cchDest, pszSrc, cchDest,
-            ppszDestEnd, pcchRemaining, dwFlags);
+    return strsafe_catn_a(pszDest, cchDest, pszSrc, cchDest, ppszDestEnd,
+            pcchRemaining, dwFlags);
 }
 
 HRESULT StringCchCatExW(
@@ -49,22 +52,58 @@ HRESULT StringCchCatExW(
         LPWSTR * ppszDestEnd,
         size_t * pcchRemaining,
         DWORD dwFlags){
-    return StringCchCatNExW(pszDest, cchDest, pszSrc, cchDest,
-            ppszDestEnd, pcchRemaining, dwFlags);
+    return strsafe_catn_w(pszDest, cchDest, pszSrc, cchDest, ppszDestEnd,
+            pcchRemaining, dwFlags);
+}
+
+HRESULT StringCchCatEx2A(
+        LPSTR pszDest,
+        size_t cchDest,
+        LPCSTR pszSrc,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags,
+        size_t * pcchRequired){
+    if(pcchRequired == NULL){
+        return strsafe_catn_a(pszDest, cchDest, pszSrc, cchDest,
+                ppszDestEnd, pcchRemaining, dwFlags);
+    }
+    return strsafe_catn_a_required(pszDest, cchDest, pszSrc,
+            STRSAFE_MAX_CCH, ppszDestEnd, pcchRemaining, dwFlags,
+            pcchRequired);
+}
+
+HRESULT StringCchCatEx2W(
+        LPWSTR pszDest,
+        size_t cchDest,
+        LPCWSTR pszSrc,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags,
+        size_t * pcchRequired){
+    if(pcchRequired == NULL){
+        return strsafe_catn_w(pszDest, cchDest, pszSrc, cchDest,
+                ppszDestEnd, pcchRemaining, dwFlags);
+    }
+    return strsafe_catn_w_required(pszDest, cchDest, pszSrc,
+            STRSAFE_MAX_CCH, ppszDestEnd, pcchRemaining, dwFlags,
+            pcchRequired);
 }
 
 HRESULT StringCbCatA(
         LPSTR pszDest,
         size_t cbDest,
         LPCSTR pszSrc){
-    return StringCbCatNA(pszDest, cbDest, pszSrc, cbDest);
+    return strsafe_catn_a_no_flags(pszDest, cbDest, pszSrc, cbDest, NULL,
+            NULL);
 }
 
 HRESULT StringCbCatW(
         LPWSTR pszDest,
         size_t cbDest,
         LPCWSTR pszSrc){
-    return StringCbCatNW(pszDest, cbDest, pszSrc, cbDest);
+    return strsafe_catn_w_no_flags(pszDest, cbDest / sizeof(wchar_t), pszSrc,
+            cbDest / sizeof(wchar_t), NULL, NULL);
 }
 
 HRESULT StringCbCatExA(
@@ -74,8 +113,8 @@ HRESULT StringCbCatExA(
         LPSTR * ppszDestEnd,
         size_t * pcbRemaining,
         DWORD dwFlags){
-    return StringCbCatNExA(pszDest, cbDest, pszSrc, cbDest,
-            ppszDestEnd, pcbRemaining, dwFlags);
+    return strsafe_catn_a(pszDest, cbDest, pszSrc, cbDest, ppszDestEnd,
+            pcbRemaining, dwFlags);
 }
 
 HRESULT StringCbCatExW(
@@ -85,6 +124,10 @@ HRESULT StringCbCatExW(
         LPWSTR * ppszDestEnd,
         size_t * pcbRemaining,
         DWORD dwFlags){
-    return StringCbCatNExW(pszDest, cbDest, pszSrc, cbDest,
-            ppszDestEnd, pcbRemaining, dwFlags);
+    HRESULT result = strsafe_catn_w(pszDest, cbDest / sizeof(wchar_t), pszSrc,
+            cbDest / sizeof(wchar_t), ppszDestEnd, pcbRemaining, dwFlags);
+    if(pcbRemaining != NULL){
+        *pcbRemaining *= sizeof(wchar_t);
+    }
+    return result;
 }
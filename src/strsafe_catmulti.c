@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+#include "strsafe.h"
+#include "../config.h"
+#ifdef HAVE_STDARG_H
+    #include <stdarg.h>
+#endif
+#ifdef HAVE_STRING_H
+    #include <string.h>
+#endif
+#ifdef HAVE_WCHAR_H
+    #include <wchar.h>
+#endif
+#include "strsafe_kernel.h"
+
+/*
+ * The sources to concatenate come either from an array or from a list of
+ * arguments that ends with NULL. The generic implementation may go
+ * through them more than once, so the argument list is copied for each
+ * pass.
+ */
+
+typedef struct strsafe_sources_a {
+    /* Set if the sources are arguments, otherwise they are the cSrc
+     * elements of ppszSrc. */
+    int fromArgs;
+    LPCSTR * ppszSrc;
+    size_t cSrc;
+    size_t index;
+    va_list argList;
+    va_list current;
+} strsafe_sources_a;
+
+static void strsafe_sources_start_a(
+        strsafe_sources_a * pSources){
+    pSources->index = 0;
+    if(pSources->fromArgs){
+        va_copy(pSources->current, pSources->argList);
+    }
+}
+
+static int strsafe_sources_next_a(
+        strsafe_sources_a * pSources,
+        const char ** ppszSrc){
+    if(pSources->fromArgs){
+        *ppszSrc = va_arg(pSources->current, const char *);
+        return *ppszSrc != NULL;
+    }
+    if(pSources->index == pSources->cSrc){
+        return 0;
+    }
+    *ppszSrc = pSources->ppszSrc[pSources->index++];
+    return 1;
+}
+
+static void strsafe_sources_stop_a(
+        strsafe_sources_a * pSources){
+    if(pSources->fromArgs){
+        va_end(pSources->current);
+    }
+}
+
+static HRESULT strsafe_catmulti_a(
+        LPSTR pszDest,
+        size_t cchDest,
+        strsafe_sources_a * pSources,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #include "strsafe_catmulti_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT StringCchCatMultiExA(
+        LPSTR pszDest,
+        size_t cchDest,
+        LPCSTR * ppszSrc,
+        size_t cSrc,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    strsafe_sources_a sources;
+    size_t i;
+
+    if(ppszSrc == NULL && cSrc != 0){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+    if(!(dwFlags & STRSAFE_IGNORE_NULLS)){
+        for(i = 0; i < cSrc; i++){
+            if(ppszSrc[i] == NULL){
+                return STRSAFE_E_INVALID_PARAMETER;
+            }
+        }
+    }
+
+    sources.fromArgs = 0;
+    sources.ppszSrc = ppszSrc;
+    sources.cSrc = cSrc;
+    return strsafe_catmulti_a(pszDest, cchDest, &sources, ppszDestEnd,
+            pcchRemaining, dwFlags);
+}
+
+HRESULT StringCchCatMultiListExA(
+        LPSTR pszDest,
+        size_t cchDest,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags,
+        ...){
+    strsafe_sources_a sources;
+    HRESULT result;
+
+    sources.fromArgs = 1;
+    sources.ppszSrc = NULL;
+    sources.cSrc = 0;
+    va_start(sources.argList, dwFlags);
+    result = strsafe_catmulti_a(pszDest, cchDest, &sources, ppszDestEnd,
+            pcchRemaining, dwFlags);
+    va_end(sources.argList);
+
+    return result;
+}
+
+typedef struct strsafe_sources_w {
+    /* Set if the sources are arguments, otherwise they are the cSrc
+     * elements of ppszSrc. */
+    int fromArgs;
+    LPCWSTR * ppszSrc;
+    size_t cSrc;
+    size_t index;
+    va_list argList;
+    va_list current;
+} strsafe_sources_w;
+
+static void strsafe_sources_start_w(
+        strsafe_sources_w * pSources){
+    pSources->index = 0;
+    if(pSources->fromArgs){
+        va_copy(pSources->current, pSources->argList);
+    }
+}
+
+static int strsafe_sources_next_w(
+        strsafe_sources_w * pSources,
+        const wchar_t ** ppszSrc){
+    if(pSources->fromArgs){
+        *ppszSrc = va_arg(pSources->current, const wchar_t *);
+        return *ppszSrc != NULL;
+    }
+    if(pSources->index == pSources->cSrc){
+        return 0;
+    }
+    *ppszSrc = pSources->ppszSrc[pSources->index++];
+    return 1;
+}
+
+static void strsafe_sources_stop_w(
+        strsafe_sources_w * pSources){
+    if(pSources->fromArgs){
+        va_end(pSources->current);
+    }
+}
+
+static HRESULT strsafe_catmulti_w(
+        LPWSTR pszDest,
+        size_t cchDest,
+        strsafe_sources_w * pSources,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #include "strsafe_catmulti_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT StringCchCatMultiExW(
+        LPWSTR pszDest,
+        size_t cchDest,
+        LPCWSTR * ppszSrc,
+        size_t cSrc,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    strsafe_sources_w sources;
+    size_t i;
+
+    if(ppszSrc == NULL && cSrc != 0){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+    if(!(dwFlags & STRSAFE_IGNORE_NULLS)){
+        for(i = 0; i < cSrc; i++){
+            if(ppszSrc[i] == NULL){
+                return STRSAFE_E_INVALID_PARAMETER;
+            }
+        }
+    }
+
+    sources.fromArgs = 0;
+    sources.ppszSrc = ppszSrc;
+    sources.cSrc = cSrc;
+    return strsafe_catmulti_w(pszDest, cchDest, &sources, ppszDestEnd,
+            pcchRemaining, dwFlags);
+}
+
+HRESULT StringCchCatMultiListExW(
+        LPWSTR pszDest,
+        size_t cchDest,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags,
+        ...){
+    strsafe_sources_w sources;
+    HRESULT result;
+
+    sources.fromArgs = 1;
+    sources.ppszSrc = NULL;
+    sources.cSrc = 0;
+    va_start(sources.argList, dwFlags);
+    result = strsafe_catmulti_w(pszDest, cchDest, &sources, ppszDestEnd,
+            pcchRemaining, dwFlags);
+    va_end(sources.argList);
+
+    return result;
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Internal header for generic implementation of libstrsafe functions.
+ * The including function gets the sources to concatenate as pSources,
+ * which is read from the start with STRSAFE_SOURCES_START, one source at
+ * a time with STRSAFE_SOURCES_NEXT and released with STRSAFE_SOURCES_STOP.
+ * The caller has already checked that the sources contain no NULL
+ * pointers unless STRSAFE_IGNORE_NULLS is set.
+ */
+
+#ifndef STRSAFE_GENERIC_WIDE_CHAR
+#error "STRSAFE_GENERIC_WIDE_CHAR must be defined."
+#elif STRSAFE_GENERIC_WIDE_CHAR == 0
+#define STRSAFE_LENGTH_KERNEL strsafe_length_a
+#define STRSAFE_COPY_KERNEL strsafe_copy_a
+#define STRSAFE_SOURCES_START strsafe_sources_start_a
+#define STRSAFE_SOURCES_NEXT strsafe_sources_next_a
+#define STRSAFE_SOURCES_STOP strsafe_sources_stop_a
+#define STRSAFE_CHAR char
+#define STRSAFE_TEXT(c) c
+#else
+#define STRSAFE_LENGTH_KERNEL strsafe_length_w
+#define STRSAFE_COPY_KERNEL strsafe_copy_w
+#define STRSAFE_SOURCES_START strsafe_sources_start_w
+#define STRSAFE_SOURCES_NEXT strsafe_sources_next_w
+#define STRSAFE_SOURCES_STOP strsafe_sources_stop_w
+#define STRSAFE_CHAR wchar_t
+#define STRSAFE_TEXT(c) L##c
+#endif
+
+const STRSAFE_CHAR * pszSrc;
+size_t length;
+HRESULT result = S_OK;
+
+if(pszDest == NULL || cchDest == 0 || cchDest > STRSAFE_MAX_CCH){
+    /* Invalid value for pszDest or cchDest. */
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+
+length = STRSAFE_LENGTH_KERNEL(pszDest, cchDest);
+if(length == cchDest){
+    /* pszDest not null terminated. */
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+
+if(!(dwFlags & (STRSAFE_NO_TRUNCATION | STRSAFE_NULL_ON_FAILURE |
+        STRSAFE_FILL_ON_FAILURE))){
+    /* Copy each source while looking for its null termination, until
+     * pszDest is full. */
+    STRSAFE_SOURCES_START(pSources);
+    while(STRSAFE_SOURCES_NEXT(pSources, &pszSrc)){
+        size_t cchCopy = cchDest - 1 - length;
+        size_t srcLength;
+
+        if(pszSrc == NULL){
+            continue;
+        }
+        srcLength = STRSAFE_COPY_KERNEL(pszDest + length, pszSrc, cchCopy);
+        length += srcLength;
+        if(srcLength == cchCopy && pszSrc[cchCopy] != STRSAFE_TEXT('\0')){
+            /* The sources are too long, pszDest is full. */
+            result = STRSAFE_E_INSUFFICIENT_BUFFER;
+            break;
+        }
+    }
+    STRSAFE_SOURCES_STOP(pSources);
+} else {
+    /* A truncated result would be thrown away, so first make sure that
+     * all sources fit. No source is read further than the space left in
+     * pszDest. Only then are they copied, so on failure pszDest is left
+     * as it was. */
+    size_t totalLength = length;
+
+    STRSAFE_SOURCES_START(pSources);
+    while(STRSAFE_SOURCES_NEXT(pSources, &pszSrc)){
+        if(pszSrc == NULL){
+            continue;
+        }
+        totalLength += STRSAFE_LENGTH_KERNEL(pszSrc, cchDest - totalLength);
+        if(totalLength >= cchDest){
+            result = STRSAFE_E_INSUFFICIENT_BUFFER;
+            break;
+        }
+    }
+    STRSAFE_SOURCES_STOP(pSources);
+
+    if(FAILED(result)){
+        if(dwFlags & STRSAFE_NO_TRUNCATION){
+            /* pszDest should be left untouched. */
+            return result;
+        }
+        if(dwFlags & STRSAFE_NULL_ON_FAILURE){
+            /* pszDest should be set to the empty string. */
+            *pszDest = STRSAFE_TEXT('\0');
+            return result;
+        }
+        /* pszDest should be filled with the lower byte of dwFlags and
+         * null terminated. */
+        strsafe_fill(pszDest, dwFlags & 0xff,
+                (cchDest - 1) * sizeof(STRSAFE_CHAR));
+        pszDest[cchDest - 1] = STRSAFE_TEXT('\0');
+        return result;
+    }
+
+    STRSAFE_SOURCES_START(pSources);
+    while(STRSAFE_SOURCES_NEXT(pSources, &pszSrc)){
+        if(pszSrc != NULL){
+            length += STRSAFE_COPY_KERNEL(pszDest + length, pszSrc,
+                    totalLength - length);
+        }
+    }
+    STRSAFE_SOURCES_STOP(pSources);
+}
+
+pszDest[length] = STRSAFE_TEXT('\0');
+if(ppszDestEnd != NULL){
+    *ppszDestEnd = pszDest + length;
+}
+if(pcchRemaining != NULL){
+    *pcchRemaining = cchDest - length;
+}
+if((dwFlags & STRSAFE_FILL_BEHIND_NULL) && length + 1 < cchDest){
+    strsafe_fill(pszDest + length + 1, dwFlags & 0xff,
+            (cchDest - length - 1) * sizeof(STRSAFE_CHAR));
+}
+
+return result;
+
+#undef STRSAFE_LENGTH_KERNEL
+#undef STRSAFE_COPY_KERNEL
+#undef STRSAFE_SOURCES_START
+#undef STRSAFE_SOURCES_NEXT
+#undef STRSAFE_SOURCES_STOP
+#undef STRSAFE_CHAR
+#undef STRSAFE_TEXT
@@ -16,14 +16,209 @@
 #ifdef HAVE_WCHAR_H
     #include <wchar.h>
 #endif
+#include "strsafe_kernel.h"
+
+/* The generic implementation is compiled once for each of the most common
+ * values of dwFlags, so that the compiler can drop the code for the flags
+ * that are not set, and once for any other value. */
+
+HRESULT strsafe_catn_a_no_flags(
+        LPSTR pszDest,
+        size_t cchDest,
+        LPCSTR pszSrc,
+        size_t cchSrc,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #define STRSAFE_GENERIC_FLAGS 0
+    #include "strsafe_catn_generic.h"
+    #undef STRSAFE_GENERIC_FLAGS
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+static HRESULT strsafe_catn_a_ignore_nulls(
+        LPSTR pszDest,
+        size_t cchDest,
+        LPCSTR pszSrc,
+        size_t cchSrc,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #define STRSAFE_GENERIC_FLAGS STRSAFE_IGNORE_NULLS
+    #include "strsafe_catn_generic.h"
+    #undef STRSAFE_GENERIC_FLAGS
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+static HRESULT strsafe_catn_a_no_truncation(
+        LPSTR pszDest,
+        size_t cchDest,
+        LPCSTR pszSrc,
+        size_t cchSrc,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #define STRSAFE_GENERIC_FLAGS STRSAFE_NO_TRUNCATION
+    #include "strsafe_catn_generic.h"
+    #undef STRSAFE_GENERIC_FLAGS
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+static HRESULT strsafe_catn_a_any(
+        LPSTR pszDest,
+        size_t cchDest,
+        LPCSTR pszSrc,
+        size_t cchSrc,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #include "strsafe_catn_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT strsafe_catn_a_required(
+        LPSTR pszDest,
+        size_t cchDest,
+        LPCSTR pszSrc,
+        size_t cchSrc,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags,
+        size_t * pcchRequired){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #define STRSAFE_GENERIC_REQUIRED 1
+    #include "strsafe_catn_generic.h"
+    #undef STRSAFE_GENERIC_REQUIRED
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT strsafe_catn_w_no_flags(
+        LPWSTR pszDest,
+        size_t cchDest,
+        LPCWSTR pszSrc,
+        size_t cchSrc,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #define STRSAFE_GENERIC_FLAGS 0
+    #include "strsafe_catn_generic.h"
+    #undef STRSAFE_GENERIC_FLAGS
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+static HRESULT strsafe_catn_w_ignore_nulls(
+        LPWSTR pszDest,
+        size_t cchDest,
+        LPCWSTR pszSrc,
+        size_t cchSrc,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #define STRSAFE_GENERIC_FLAGS STRSAFE_IGNORE_NULLS
+    #include "strsafe_catn_generic.h"
+    #undef STRSAFE_GENERIC_FLAGS
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+static HRESULT strsafe_catn_w_no_truncation(
+        LPWSTR pszDest,
+        size_t cchDest,
+        LPCWSTR pszSrc,
+        size_t cchSrc,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #define STRSAFE_GENERIC_FLAGS STRSAFE_NO_TRUNCATION
+    #include "strsafe_catn_generic.h"
+    #undef STRSAFE_GENERIC_FLAGS
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+static HRESULT strsafe_catn_w_any(
+        LPWSTR pszDest,
+        size_t cchDest,
+        LPCWSTR pszSrc,
+        size_t cchSrc,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #include "strsafe_catn_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT strsafe_catn_w_required(
+        LPWSTR pszDest,
+        size_t cchDest,
+        LPCWSTR pszSrc,
+        size_t cchSrc,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags,
+        size_t * pcchRequired){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #define STRSAFE_GENERIC_REQUIRED 1
+    #include "strsafe_catn_generic.h"
+    #undef STRSAFE_GENERIC_REQUIRED
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT strsafe_catn_a(
+        LPSTR pszDest,
+        size_t cchDest,
+        LPCSTR pszSrc,
+        size_t cchSrc,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    switch(dwFlags){
+        case 0:
+            return strsafe_catn_a_no_flags(pszDest, cchDest, pszSrc,
+                    cchSrc, ppszDestEnd, pcchRemaining);
+        case STRSAFE_IGNORE_NULLS:
+            return strsafe_catn_a_ignore_nulls(pszDest, cchDest, pszSrc,
+                    cchSrc, ppszDestEnd, pcchRemaining);
+        case STRSAFE_NO_TRUNCATION:
+            return strsafe_catn_a_no_truncation(pszDest, cchDest, pszSrc,
+                    cchSrc, ppszDestEnd, pcchRemaining);
+        default:
+            return strsafe_catn_a_any(pszDest, cchDest, pszSrc, cchSrc,
+                    ppszDestEnd, pcchRemaining, dwFlags);
+    }
+}
+
+HRESULT strsafe_catn_w(
+        LPWSTR pszDest,
+        size_t cchDest,
+        LPCWSTR pszSrc,
+        size_t cchSrc,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    switch(dwFlags){
+        case 0:
+            return strsafe_catn_w_no_flags(pszDest, cchDest, pszSrc,
+                    cchSrc, ppszDestEnd, pcchRemaining);
+        case STRSAFE_IGNORE_NULLS:
+            return strsafe_catn_w_ignore_nulls(pszDest, cchDest, pszSrc,
+                    cchSrc, ppszDestEnd, pcchRemaining);
+        case STRSAFE_NO_TRUNCATION:
+            return strsafe_catn_w_no_truncation(pszDest, cchDest, pszSrc,
+                    cchSrc, ppszDestEnd, pcchRemaining);
+        default:
+            return strsafe_catn_w_any(pszDest, cchDest, pszSrc, cchSrc,
+                    ppszDestEnd, pcchRemaining, dwFlags);
+    }
+}
 
 HRESULT StringCchCatNA(
         LPSTR pszDest,
         size_t cchDest,
         LPCSTR pszSrc,
         size_t cchSrc){
-    return StringCchCatNExA(pszDest, cchDest, pszSrc, cchSrc,
-            NULL, NULL, 0);
+    return strsafe_catn_a_no_flags(pszDest, cchDest, pszSrc, cchSrc,
+            NULL, NULL);
 }
 
 HRESULT StringCchCatNW(
@@ -31,8 +226,8 @@ HRESULT StringCchCatNW(
         size_t cchDest,
         LPCWSTR pszSrc,
         size_t cchSrc){
-    return StringCchCatNExW(pszDest, cchDest, pszSrc, cchSrc,
-            NULL, NULL, 0);
+    return strsafe_catn_w_no_flags(pszDest, cchDest, pszSrc, cchSrc,
+            NULL, NULL);
 }
 
 HRESULT StringCchCatNExA(
@@ -43,11 +238,8 @@ HRESULT StringCchCatNExA(
         LPSTR * ppszDestEnd,
         size_t * pcchRemaining,
         DWORD dwFlags){
-    /* This function has a generic implementation in
-     * strsafe_catn_generic.h. */
-    #define STRSAFE_GENERIC_WIDE_CHAR 0
-    #include "strsafe_catn_generic.h"
-    #undef STRSAFE_GENERIC_WIDE_CHAR
+    return strsafe_catn_a(pszDest, cchDest, pszSrc, cchSrc,
+            ppszDestEnd, pcchRemaining, dwFlags);
 }
 
 HRESULT StringCchCatNExW(
@@ -58,11 +250,8 @@ HRESULT StringCchCatNExW(
         LPWSTR * ppszDestEnd,
         size_t * pcchRemaining,
         DWORD dwFlags){
-    /* This function has a generic implementation in
-     * strsafe_catn_generic.h. */
-    #define STRSAFE_GENERIC_WIDE_CHAR 1
-    #include "strsafe_catn_generic.h"
-    #undef STRSAFE_GENERIC_WIDE_CHAR
+    return strsafe_catn_w(pszDest, cchDest, pszSrc, cchSrc,
+            ppszDestEnd, pcchRemaining, dwFlags);
 }
 
 HRESULT StringCbCatNA(
@@ -70,8 +259,8 @@ HRESULT StringCbCatNA(
         size_t cbDest,
         LPCSTR pszSrc,
         size_t cbSrc){
-    return StringCbCatNExA(pszDest, cbDest, pszSrc, cbSrc,
-            NULL, NULL, 0);
+    return strsafe_catn_a_no_flags(pszDest, cbDest, pszSrc, cbSrc,
+            NULL, NULL);
 }
 
 HRESULT StringCbCatNW(
@@ -79,8 +268,8 @@ HRESULT StringCbCatNW(
         size_t cbDest,
         LPCWSTR pszSrc,
         size_t cbSrc){
-    return StringCbCatNExW(pszDest, cbDest, pszSrc, cbSrc,
-            NULL, NULL, 0);
+    return strsafe_catn_w_no_flags(pszDest, cbDest / sizeof(wchar_t),
+            pszSrc, cbSrc / sizeof(wchar_t), NULL, NULL);
 }
 
 HRESULT StringCbCatNExA(
@@ -91,7 +280,7 @@ HRESULT StringCbCatNExA(
         LPSTR * ppszDestEnd,
         size_t * pcbRemaining,
         DWORD dwFlags){
-    return StringCchCatNExA(pszDest, cbDest, pszSrc, cbSrc,
+    return strsafe_catn_a(pszDest, cbDest, pszSrc, cbSrc,
             ppszDestEnd, pcbRemaining, dwFlags);
 }
 
@@ -103,7 +292,7 @@ HRESULT StringCbCatNExW(
         LPWSTR * ppszDestEnd,
         size_t * pcbRemaining,
         DWORD dwFlags){
-    HRESULT result = StringCchCatNExW(pszDest, cbDest / sizeof(wchar_t),
+    HRESULT result = strsafe_catn_w(pszDest, cbDest / sizeof(wchar_t),
             pszSrc, cbSrc / sizeof(wchar_t),
             ppszDestEnd, pcbRemaining, dwFlags);
     if(pcbRemaining != NULL){
@@ -7,24 +7,37 @@
 
 /*
  * Internal header for generic implementation of libstrsafe functions.
+ * If the including function defines STRSAFE_GENERIC_FLAGS, that value is
+ * used for dwFlags instead of a parameter, which lets the compiler remove
+ * the code for the flags that are not set. If it defines
+ * STRSAFE_GENERIC_REQUIRED, the length of the whole result is stored in
+ * *pcchRequired, which must not be NULL.
  */
 
 #ifndef STRSAFE_GENERIC_WIDE_CHAR
 #error "STRSAFE_GENERIC_WIDE_CHAR must be defined."
 #elif STRSAFE_GENERIC_WIDE_CHAR == 0
-#define STRSAFE_LENGTH StringCchLengthA
+#define STRSAFE_LENGTH strsafe_length_cch_a
+#define STRSAFE_LENGTH_KERNEL strsafe_length_a
+#define STRSAFE_COPY_KERNEL strsafe_copy_a
 #define STRSAFE_CHAR char
 #define STRSAFE_TEXT(c) c
 #else
-#define STRSAFE_LENGTH StringCchLengthW
+#define STRSAFE_LENGTH strsafe_length_cch_w
+#define STRSAFE_LENGTH_KERNEL strsafe_length_w
+#define STRSAFE_COPY_KERNEL strsafe_copy_w
 #define STRSAFE_CHAR wchar_t
 #define STRSAFE_TEXT(c) L##c
 #endif
 
+#ifdef STRSAFE_GENERIC_FLAGS
+const DWORD dwFlags = STRSAFE_GENERIC_FLAGS;
+#endif
 size_t srcLength;
 size_t destLength;
 size_t destCapacity;
 size_t length;
+int copied = 0;
 HRESULT result = S_OK;
 
 if(cchDest == 0 || cchDest > STRSAFE_MAX_CCH){
@@ -41,22 +54,57 @@ if(pszDest == NULL && (dwFlags & STRSAFE_IGNORE_NULLS)){
     }
 }
 
+destCapacity = cchDest - destLength;
+
 if(pszSrc == NULL && (dwFlags & STRSAFE_IGNORE_NULLS)){
     srcLength = 0;
+} else if(pszSrc != NULL && !(dwFlags & (STRSAFE_NO_TRUNCATION |
+        STRSAFE_NULL_ON_FAILURE | STRSAFE_FILL_ON_FAILURE))){
+    /* Copy pszSrc while looking for its null termination. The copy
+     * stops where pszDest is full, so pszSrc is only read once. */
+    size_t cchCopy = cchSrc < destCapacity ? cchSrc : destCapacity - 1;
+    srcLength = STRSAFE_COPY_KERNEL(pszDest + destLength, pszSrc, cchCopy);
+    if(srcLength == cchCopy && cchCopy < cchSrc &&
+            pszSrc[cchCopy] != STRSAFE_TEXT('\0')){
+        /* pszSrc too long, the first destCapacity - 1 characters
+         * were copied. */
+        result = STRSAFE_E_INSUFFICIENT_BUFFER;
+    }
+    copied = 1;
 } else {
-    if(FAILED(STRSAFE_LENGTH(pszSrc, cchSrc, &srcLength))){
+    /* A truncated copy would be thrown away, so only look for the null
+     * termination. pszSrc does not fit if there is none among its first
+     * destCapacity characters, so the rest of it is never read. */
+    size_t cchScan = cchSrc < destCapacity ? cchSrc : destCapacity;
+    if(FAILED(STRSAFE_LENGTH(pszSrc, cchScan, &srcLength))){
         /* pszSrc longer than length required. */
-        srcLength = cchSrc;
+        srcLength = cchScan;
+    }
+    if(srcLength >= destCapacity){
+        /* pszSrc too long, copy first destCapacity - 1 characters. */
+        srcLength = destCapacity - 1;
+        result = STRSAFE_E_INSUFFICIENT_BUFFER;
     }
 }
 
-destCapacity = cchDest - destLength;
-
-if(srcLength >= destCapacity){
-    /* pszSrc too long, copy first destCapacity - 1 characters. */
-    srcLength = destCapacity - 1;
-    result = STRSAFE_E_INSUFFICIENT_BUFFER;
+#ifdef STRSAFE_GENERIC_REQUIRED
+if(FAILED(result) && pszSrc != NULL){
+    /* The first destCapacity - 1 characters of pszSrc are known not to
+     * be null, so the scan for the rest of the length picks up there. The
+     * result can be at most STRSAFE_MAX_CCH characters long. */
+    size_t cchKnown = destCapacity - 1;
+    size_t cchLimit = STRSAFE_MAX_CCH - destLength;
+    if(cchSrc < cchLimit){
+        cchLimit = cchSrc;
+    }
+    *pcchRequired = destLength + cchKnown +
+            STRSAFE_LENGTH_KERNEL(pszSrc + cchKnown, cchLimit - cchKnown);
+} else {
+    /* A NULL pszSrc without STRSAFE_IGNORE_NULLS has no length to scan
+     * for and is treated as filling pszDest. */
+    *pcchRequired = destLength + srcLength;
 }
+#endif
 
 length = destLength + srcLength;
 
@@ -73,14 +121,16 @@ if(FAILED(result)){
     if(dwFlags & STRSAFE_FILL_ON_FAILURE){
         /* pszDest should be filled with the lower byte of dwFlags
          * and null terminated. */
-        memset(pszDest, dwFlags & 0xff,
+        strsafe_fill(pszDest, dwFlags & 0xff,
                 (cchDest - 1) * sizeof(STRSAFE_CHAR));
         pszDest[cchDest - 1] = STRSAFE_TEXT('\0');
         return result;
     }
 }
 
-memcpy(pszDest + destLength, pszSrc, srcLength * sizeof(STRSAFE_CHAR));
+if(!copied){
+    memcpy(pszDest + destLength, pszSrc, srcLength * sizeof(STRSAFE_CHAR));
+}
 pszDest[length] = STRSAFE_TEXT('\0');
 if(ppszDestEnd != NULL){
     *ppszDestEnd = pszDest + length;
@@ -89,12 +139,14 @@ if(pcchRemaining != NULL){
     *pcchRemaining = cchDest - length;
 }
 if((dwFlags & STRSAFE_FILL_BEHIND_NULL) && length + 1 < cchDest){
-    memset(pszDest + length + 1, dwFlags & 0xff,
+    strsafe_fill(pszDest + length + 1, dwFlags & 0xff,
             (cchDest - length - 1) * sizeof(STRSAFE_CHAR));
 }
 
 return result;
 
 #undef STRSAFE_LENGTH
+#undef STRSAFE_LENGTH_KERNEL
+#undef STRSAFE_COPY_KERNEL
 #undef STRSAFE_CHAR
 #undef STRSAFE_TEXT
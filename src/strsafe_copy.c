@@ -16,19 +16,28 @@
 #ifdef HAVE_WCHAR_H
     #include <wchar.h>
 #endif
+#include "strsafe_internal.h"
 
 HRESULT StringCchCopyA(
         LPSTR pszDest,
         size_t cchDest,
         LPCSTR pszSrc){
-    return StringCchCopyNA(pszDest, cchDest, pszSrc, cchDest);
+    if(pszDest != NULL){
+        *pszDest = '\0';
+    }
+    return strsafe_catn_a_no_flags(pszDest, cchDest, pszSrc, cchDest, NULL,
+            NULL);
 }
 
 HRESULT StringCchCopyW(
         LPWSTR pszDest,
         size_t cchDest,
         LPCWSTR pszSrc){
-    return StringCchCopyNW(pszDest, cchDest, pszSrc, cchDest);
+    if(pszDest != NULL){
+        *pszDest = L'\0';
+    }
+    return strsafe_catn_w_no_flags(pszDest, cchDest, pszSrc, cchDest, NULL,
+            NULL);
 }
 
 HRESULT StringCchCopyExA(
@@ -38,8 +47,11 @@ HRESULT StringCchCopyExA(
         LPSTR *ppszDestEnd,
         size_t * pcchRemaining,
         DWORD dwFlags){
-    return StringCchCopyNExA(pszDest, cchDest, pszSrc, cchDest,
-            ppszDestEnd, pcchRemaining, dwFlags);
+    if(pszDest != NULL){
+        *pszDest = '\0';
+    }
+    return strsafe_catn_a(pszDest, cchDest, pszSrc, cchDest, ppszDestEnd,
+            pcchRemaining, dwFlags);
 }
 
 HRESULT StringCchCopyExW(
@@ -49,22 +61,73 @@ HRESULT StringCchCopyExW(
         LPWSTR *ppszDestEnd,
         size_t * pcchRemaining,
         DWORD dwFlags){
-    return StringCchCopyNExW(pszDest, cchDest, pszSrc, cchDest,
-            ppszDestEnd, pcchRemaining, dwFlags);
+    if(pszDest != NULL){
+        *pszDest = L'\0';
+    }
+    return strsafe_catn_w(pszDest, cchDest, pszSrc, cchDest, ppszDestEnd,
+            pcchRemaining, dwFlags);
+}
+
+HRESULT StringCchCopyEx2A(
+        LPSTR pszDest,
+        size_t cchDest,
+        LPCSTR pszSrc,
+        LPSTR *ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags,
+        size_t * pcchRequired){
+    if(pszDest != NULL){
+        *pszDest = '\0';
+    }
+    if(pcchRequired == NULL){
+        return strsafe_catn_a(pszDest, cchDest, pszSrc, cchDest,
+                ppszDestEnd, pcchRemaining, dwFlags);
+    }
+    return strsafe_catn_a_required(pszDest, cchDest, pszSrc,
+            STRSAFE_MAX_CCH, ppszDestEnd, pcchRemaining, dwFlags,
+            pcchRequired);
+}
+
+HRESULT StringCchCopyEx2W(
+        LPWSTR pszDest,
+        size_t cchDest,
+        LPCWSTR pszSrc,
+        LPWSTR *ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags,
+        size_t * pcchRequired){
+    if(pszDest != NULL){
+        *pszDest = L'\0';
+    }
+    if(pcchRequired == NULL){
+        return strsafe_catn_w(pszDest, cchDest, pszSrc, cchDest,
+                ppszDestEnd, pcchRemaining, dwFlags);
+    }
+    return strsafe_catn_w_required(pszDest, cchDest, pszSrc,
+            STRSAFE_MAX_CCH, ppszDestEnd, pcchRemaining, dwFlags,
+            pcchRequired);
 }
 
 HRESULT StringCbCopyA(
         LPSTR pszDest,
         size_t cbDest,
         LPCSTR pszSrc){
-    return StringCbCopyNA(pszDest, cbDest, pszSrc, cbDest);
+    if(pszDest != NULL){
+        *pszDest = '\0';
+    }
+    return strsafe_catn_a_no_flags(pszDest, cbDest, pszSrc, cbDest, NULL,
+            NULL);
 }
 
 HRESULT StringCbCopyW(
         LPWSTR pszDest,
         size_t cbDest,
         LPCWSTR pszSrc){
-    return StringCbCopyNW(pszDest, cbDest, pszSrc, cbDest);
+    if(pszDest != NULL){
+        *pszDest = L'\0';
+    }
+    return strsafe_catn_w_no_flags(pszDest, cbDest / sizeof(wchar_t), pszSrc,
+            cbDest / sizeof(wchar_t), NULL, NULL);
 }
 
 HRESULT StringCbCopyExA(
@@ -74,8 +137,11 @@ HRESULT StringCbCopyExA(
         LPSTR *ppszDestEnd,
         size_t * pcbRemaining,
         DWORD dwFlags){
-    return StringCbCopyNExA(pszDest, cbDest, pszSrc, cbDest,
-            ppszDestEnd, pcbRemaining, dwFlags);
+    if(pszDest != NULL){
+        *pszDest = '\0';
+    }
+    return strsafe_catn_a(pszDest, cbDest, pszSrc, cbDest, ppszDestEnd,
+            pcbRemaining, dwFlags);
 }
 
 HRESULT StringCbCopyExW(
@@ -85,6 +151,15 @@ HRESULT StringCbCopyExW(
         LPWSTR * ppszDestEnd,
         size_t * pcbRemaining,
         DWORD dwFlags){
-    return StringCbCopyNExW(pszDest, cbDest, pszSrc, cbDest,
-            ppszDestEnd, pcbRemaining, dwFlags);
+    HRESULT result;
+
+    if(pszDest != NULL){
+        *pszDest = L'\0';
+    }
+    result = strsafe_catn_w(pszDest, cbDest / sizeof(wchar_t), pszSrc,
+            cbDest / sizeof(wchar_t), ppszDestEnd, pcbRemaining, dwFlags);
+    if(pcbRemaining != NULL){
+        *pcbRemaining *= sizeof(wchar_t);
+    }
+    return result;
 }
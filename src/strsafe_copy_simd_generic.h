@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Internal header for generic implementation of the vectorized copy
+ * kernels. Besides STRSAFE_GENERIC_WIDE_CHAR and the macros needed by
+ * strsafe_length_simd_generic.h, the including function must define
+ * STRSAFE_SIMD_COPY(dest, block), which copies the aligned vector at block
+ * to the possibly unaligned address dest.
+ */
+
+#ifndef STRSAFE_GENERIC_WIDE_CHAR
+#error "STRSAFE_GENERIC_WIDE_CHAR must be defined."
+#elif STRSAFE_GENERIC_WIDE_CHAR == 0
+#define STRSAFE_CHAR char
+#define STRSAFE_COPY_SCALAR strsafe_copy_a_scalar
+#else
+#define STRSAFE_CHAR wchar_t
+#define STRSAFE_COPY_SCALAR strsafe_copy_w_scalar
+#endif
+
+const char * block;
+size_t offset;
+size_t length = 0;
+size_t count;
+unsigned int mask;
+
+if(cchMax == 0){
+    return 0;
+}
+if((uintptr_t)pszSrc % sizeof(STRSAFE_CHAR) != 0){
+    /* The lanes of the vectors would not line up with the characters. */
+    return STRSAFE_COPY_SCALAR(pszDest, pszSrc, cchMax);
+}
+
+/* The source is read in aligned vectors, like in the length kernels, and
+ * each vector is checked for a null character before it is copied. Only
+ * whole vectors are stored with vector instructions, so nothing is
+ * written beyond the copied characters. */
+offset = (size_t)((uintptr_t)pszSrc & (STRSAFE_SIMD_SIZE - 1));
+block = (const char *)pszSrc - offset;
+mask = STRSAFE_SIMD_ZEROS(block) >> offset;
+count = (STRSAFE_SIMD_SIZE - offset) / sizeof(STRSAFE_CHAR);
+
+for(;;){
+    if(count > cchMax - length){
+        count = cchMax - length;
+    }
+    if(mask != 0 &&
+            (size_t)__builtin_ctz(mask) / sizeof(STRSAFE_CHAR) < count){
+        count = (size_t)__builtin_ctz(mask) / sizeof(STRSAFE_CHAR);
+        memcpy(pszDest + length, pszSrc + length,
+                count * sizeof(STRSAFE_CHAR));
+        return length + count;
+    }
+    if(count == STRSAFE_SIMD_SIZE / sizeof(STRSAFE_CHAR)){
+        STRSAFE_SIMD_COPY(pszDest + length, block);
+    } else {
+        memcpy(pszDest + length, pszSrc + length,
+                count * sizeof(STRSAFE_CHAR));
+    }
+    length += count;
+    if(length == cchMax){
+        return length;
+    }
+    block += STRSAFE_SIMD_SIZE;
+    mask = STRSAFE_SIMD_ZEROS(block);
+    count = STRSAFE_SIMD_SIZE / sizeof(STRSAFE_CHAR);
+}
+
+#undef STRSAFE_CHAR
+#undef STRSAFE_COPY_SCALAR
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Internal header for generic implementation of the word-at-a-time
+ * copy kernels.
+ */
+
+#ifndef STRSAFE_GENERIC_WIDE_CHAR
+#error "STRSAFE_GENERIC_WIDE_CHAR must be defined."
+#elif STRSAFE_GENERIC_WIDE_CHAR == 0
+#define STRSAFE_CHAR char
+#define STRSAFE_TEXT(c) c
+#define STRSAFE_COPY_SCALAR strsafe_copy_a_scalar
+#else
+#define STRSAFE_CHAR wchar_t
+#define STRSAFE_TEXT(c) L##c
+#define STRSAFE_COPY_SCALAR strsafe_copy_w_scalar
+#endif
+
+size_t length = 0;
+uint64_t word;
+
+if((uintptr_t)pszSrc % sizeof(STRSAFE_CHAR) != 0){
+    /* The lanes of the words would not line up with the characters. */
+    return STRSAFE_COPY_SCALAR(pszDest, pszSrc, cchMax);
+}
+
+/* Copy one character at a time until pszSrc + length is aligned. */
+while((uintptr_t)(pszSrc + length) % sizeof(uint64_t) != 0){
+    if(length == cchMax || pszSrc[length] == STRSAFE_TEXT('\0')){
+        return length;
+    }
+    pszDest[length] = pszSrc[length];
+    length++;
+}
+
+/* Copy whole words as long as they are within cchMax and hold no null
+ * character. Only the loads need to be aligned. */
+while(cchMax - length >= sizeof(word) / sizeof(STRSAFE_CHAR)){
+    memcpy(&word, pszSrc + length, sizeof(word));
+    if(STRSAFE_SWAR_HAS_ZERO(STRSAFE_CHAR, word)){
+        break;
+    }
+    memcpy(pszDest + length, &word, sizeof(word));
+    length += sizeof(word) / sizeof(STRSAFE_CHAR);
+}
+
+/* Copy the rest of the last word. */
+while(length < cchMax && pszSrc[length] != STRSAFE_TEXT('\0')){
+    pszDest[length] = pszSrc[length];
+    length++;
+}
+
+return length;
+
+#undef STRSAFE_CHAR
+#undef STRSAFE_TEXT
+#undef STRSAFE_COPY_SCALAR
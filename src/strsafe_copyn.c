@@ -16,13 +16,18 @@
 #ifdef HAVE_WCHAR_H
     #include <wchar.h>
 #endif
+#include "strsafe_internal.h"
+
 HRESULT StringCchCopyNA(
         LPSTR pszDest,
         size_t cchDest,
         LPCSTR pszSrc,
         size_t cchSrc){
-    return StringCchCopyNExA(pszDest, cchDest, pszSrc, cchSrc,
-            NULL, NULL, 0);
+    if(pszDest != NULL){
+        *pszDest = '\0';
+    }
+    return strsafe_catn_a_no_flags(pszDest, cchDest, pszSrc, cchSrc, NULL,
+            NULL);
 }
 
 HRESULT StringCchCopyNW(
@@ -30,8 +35,11 @@ HRESULT StringCchCopyNW(
         size_t cchDest,
         LPCWSTR pszSrc,
         size_t cchSrc){
-    return StringCchCopyNExW(pszDest, cchDest, pszSrc, cchSrc,
-            NULL, NULL, 0);
+    if(pszDest != NULL){
+        *pszDest = L'\0';
+    }
+    return strsafe_catn_w_no_flags(pszDest, cchDest, pszSrc, cchSrc, NULL,
+            NULL);
 }
 
 HRESULT StringCchCopyNExA(
@@ -45,8 +53,8 @@ HRESULT StringCchCopyNExA(
     if(pszDest != NULL){
         *pszDest = '\0';
     }
-    return StringCchCatNExA(pszDest, cchDest, pszSrc, cchSrc,
-            ppszDestEnd, pcchRemaining, dwFlags);
+    return strsafe_catn_a(pszDest, cchDest, pszSrc, cchSrc, ppszDestEnd,
+            pcchRemaining, dwFlags);
 }
 
 HRESULT StringCchCopyNExW(
@@ -60,8 +68,8 @@ HRESULT StringCchCopyNExW(
     if(pszDest != NULL){
         *pszDest = L'\0';
     }
-    return StringCchCatNExW(pszDest, cchDest, pszSrc, cchSrc,
-            ppszDestEnd, pcchRemaining, dwFlags);
+    return strsafe_catn_w(pszDest, cchDest, pszSrc, cchSrc, ppszDestEnd,
+            pcchRemaining, dwFlags);
 }
 
 HRESULT StringCbCopyNA(
@@ -69,8 +77,10 @@ HRESULT StringCbCopyNA(
         size_t cbDest,
         LPCSTR pszSrc,
         size_t cbSrc){
-    return StringCbCopyNExA(pszDest, cbDest, pszSrc, cbSrc,
-            NULL, NULL, 0);
+    if(pszDest != NULL){
+        *pszDest = '\0';
+    }
+    return strsafe_catn_a_no_flags(pszDest, cbDest, pszSrc, cbSrc, NULL, NULL);
 }
 
 HRESULT StringCbCopyNW(
@@ -78,8 +88,11 @@ HRESULT StringCbCopyNW(
         size_t cbDest,
         LPCWSTR pszSrc,
         size_t cbSrc){
-    return StringCbCopyNExW(pszDest, cbDest, pszSrc, cbSrc,
-            NULL, NULL, 0);
+    if(pszDest != NULL){
+        *pszDest = L'\0';
+    }
+    return strsafe_catn_w_no_flags(pszDest, cbDest / sizeof(wchar_t), pszSrc,
+            cbSrc / sizeof(wchar_t), NULL, NULL);
 }
 
 HRESULT StringCbCopyNExA(
@@ -93,8 +106,8 @@ HRESULT StringCbCopyNExA(
     if(pszDest != NULL){
         *pszDest = '\0';
     }
-    return StringCbCatNExA(pszDest, cbDest, pszSrc, cbSrc,
-            ppszDestEnd, pcbRemaining, dwFlags);
+    return strsafe_catn_a(pszDest, cbDest, pszSrc, cbSrc, ppszDestEnd,
+            pcbRemaining, dwFlags);
 }
 
 HRESULT StringCbCopyNExW(
@@ -105,9 +118,15 @@ HRESULT StringCbCopyNExW(
         LPWSTR *ppszDestEnd,
         size_t * pcbRemaining,
         DWORD dwFlags){
+    HRESULT result;
+
     if(pszDest != NULL){
         *pszDest = L'\0';
     }
-    return StringCbCatNExW(pszDest, cbDest, pszSrc, cbSrc,
-            ppszDestEnd, pcbRemaining, dwFlags);
+    result = strsafe_catn_w(pszDest, cbDest / sizeof(wchar_t), pszSrc,
+            cbSrc / sizeof(wchar_t), ppszDestEnd, pcbRemaining, dwFlags);
+    if(pcbRemaining != NULL){
+        *pcbRemaining *= sizeof(wchar_t);
+    }
+    return result;
 }
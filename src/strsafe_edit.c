@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+#include "strsafe.h"
+#include "../config.h"
+#ifdef HAVE_STRING_H
+    #include <string.h>
+#endif
+#ifdef HAVE_WCHAR_H
+    #include <wchar.h>
+#endif
+#include "strsafe_internal.h"
+
+static HRESULT strsafe_replace_range_a(
+        LPSTR pszDest,
+        size_t cchDest,
+        size_t cchOffset,
+        size_t cchCount,
+        LPCSTR pszSrc,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #include "strsafe_edit_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+static HRESULT strsafe_replace_range_w(
+        LPWSTR pszDest,
+        size_t cchDest,
+        size_t cchOffset,
+        size_t cchCount,
+        LPCWSTR pszSrc,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #include "strsafe_edit_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT StringCchInsertExA(
+        LPSTR pszDest,
+        size_t cchDest,
+        size_t cchOffset,
+        LPCSTR pszSrc,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    return strsafe_replace_range_a(pszDest, cchDest, cchOffset, 0, pszSrc,
+            ppszDestEnd, pcchRemaining, dwFlags);
+}
+
+HRESULT StringCchInsertExW(
+        LPWSTR pszDest,
+        size_t cchDest,
+        size_t cchOffset,
+        LPCWSTR pszSrc,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    return strsafe_replace_range_w(pszDest, cchDest, cchOffset, 0, pszSrc,
+            ppszDestEnd, pcchRemaining, dwFlags);
+}
+
+HRESULT StringCchDeleteA(
+        LPSTR pszDest,
+        size_t cchDest,
+        size_t cchOffset,
+        size_t cchCount,
+        LPSTR * ppszDestEnd){
+    return strsafe_replace_range_a(pszDest, cchDest, cchOffset, cchCount,
+            NULL, ppszDestEnd, NULL, STRSAFE_IGNORE_NULLS);
+}
+
+HRESULT StringCchDeleteW(
+        LPWSTR pszDest,
+        size_t cchDest,
+        size_t cchOffset,
+        size_t cchCount,
+        LPWSTR * ppszDestEnd){
+    return strsafe_replace_range_w(pszDest, cchDest, cchOffset, cchCount,
+            NULL, ppszDestEnd, NULL, STRSAFE_IGNORE_NULLS);
+}
+
+HRESULT StringCchReplaceRangeExA(
+        LPSTR pszDest,
+        size_t cchDest,
+        size_t cchOffset,
+        size_t cchCount,
+        LPCSTR pszSrc,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    return strsafe_replace_range_a(pszDest, cchDest, cchOffset, cchCount,
+            pszSrc, ppszDestEnd, pcchRemaining, dwFlags);
+}
+
+HRESULT StringCchReplaceRangeExW(
+        LPWSTR pszDest,
+        size_t cchDest,
+        size_t cchOffset,
+        size_t cchCount,
+        LPCWSTR pszSrc,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    return strsafe_replace_range_w(pszDest, cchDest, cchOffset, cchCount,
+            pszSrc, ppszDestEnd, pcchRemaining, dwFlags);
+}
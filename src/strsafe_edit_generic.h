@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Internal header for generic implementation of libstrsafe functions.
+ * Replaces the cchCount characters at cchOffset in pszDest with pszSrc.
+ * The part of pszDest behind the replaced range is moved to its new place
+ * with one memmove before pszSrc is copied in front of it, so no temporary
+ * buffer is needed. Only as much of pszSrc is read as can fit.
+ */
+
+#ifndef STRSAFE_GENERIC_WIDE_CHAR
+#error "STRSAFE_GENERIC_WIDE_CHAR must be defined."
+#elif STRSAFE_GENERIC_WIDE_CHAR == 0
+#define STRSAFE_LENGTH strsafe_length_cch_a
+#define STRSAFE_CHAR char
+#define STRSAFE_TEXT(c) c
+#else
+#define STRSAFE_LENGTH strsafe_length_cch_w
+#define STRSAFE_CHAR wchar_t
+#define STRSAFE_TEXT(c) L##c
+#endif
+
+size_t destLength;
+size_t tailLength;
+size_t srcLength;
+size_t cchSpace;
+size_t length;
+HRESULT result = S_OK;
+
+if(pszDest == NULL || cchDest == 0 || cchDest > STRSAFE_MAX_CCH){
+    /* Invalid value for pszDest or cchDest. */
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+if(FAILED(STRSAFE_LENGTH(pszDest, cchDest, &destLength))){
+    /* pszDest not null terminated. */
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+if(cchOffset > destLength){
+    /* The range starts behind the end of pszDest. */
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+if(pszSrc == NULL && !(dwFlags & STRSAFE_IGNORE_NULLS)){
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+
+if(cchCount > destLength - cchOffset){
+    /* The range ends at the end of pszDest. */
+    cchCount = destLength - cchOffset;
+}
+tailLength = destLength - cchOffset - cchCount;
+
+/* At most cchDest - 1 - cchOffset characters of pszSrc can be kept, so
+ * the rest of it is never read. */
+cchSpace = cchDest - 1 - cchOffset - tailLength;
+if(pszSrc == NULL){
+    srcLength = 0;
+} else if(FAILED(STRSAFE_LENGTH(pszSrc, cchDest - cchOffset, &srcLength))){
+    srcLength = cchDest - cchOffset;
+}
+if(srcLength > cchSpace){
+    if(dwFlags & STRSAFE_NO_TRUNCATION){
+        /* pszDest should be left untouched. */
+        return STRSAFE_E_INSUFFICIENT_BUFFER;
+    }
+    if(dwFlags & STRSAFE_NULL_ON_FAILURE){
+        /* pszDest should be set to the empty string. */
+        *pszDest = STRSAFE_TEXT('\0');
+        return STRSAFE_E_INSUFFICIENT_BUFFER;
+    }
+    if(dwFlags & STRSAFE_FILL_ON_FAILURE){
+        /* pszDest should be filled with the lower byte of dwFlags
+         * and null terminated. */
+        strsafe_fill(pszDest, dwFlags & 0xff,
+                (cchDest - 1) * sizeof(STRSAFE_CHAR));
+        pszDest[cchDest - 1] = STRSAFE_TEXT('\0');
+        return STRSAFE_E_INSUFFICIENT_BUFFER;
+    }
+    /* Keep the first cchDest - 1 characters of the result. The part of
+     * pszSrc that fits goes first, then as much of the tail as fits. */
+    if(srcLength > cchDest - 1 - cchOffset){
+        srcLength = cchDest - 1 - cchOffset;
+    }
+    tailLength = cchDest - 1 - cchOffset - srcLength;
+    result = STRSAFE_E_INSUFFICIENT_BUFFER;
+}
+
+if(srcLength != cchCount){
+    memmove(pszDest + cchOffset + srcLength, pszDest + cchOffset + cchCount,
+            tailLength * sizeof(STRSAFE_CHAR));
+}
+if(srcLength > 0){
+    memcpy(pszDest + cchOffset, pszSrc, srcLength * sizeof(STRSAFE_CHAR));
+}
+length = cchOffset + srcLength + tailLength;
+
+pszDest[length] = STRSAFE_TEXT('\0');
+if(ppszDestEnd != NULL){
+    *ppszDestEnd = pszDest + length;
+}
+if(pcchRemaining != NULL){
+    *pcchRemaining = cchDest - length;
+}
+if((dwFlags & STRSAFE_FILL_BEHIND_NULL) && length + 1 < cchDest){
+    strsafe_fill(pszDest + length + 1, dwFlags & 0xff,
+            (cchDest - length - 1) * sizeof(STRSAFE_CHAR));
+}
+
+return result;
+
+#undef STRSAFE_LENGTH
+#undef STRSAFE_CHAR
+#undef STRSAFE_TEXT
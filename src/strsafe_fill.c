@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Fills the buffers of the functions called with STRSAFE_FILL_BEHIND_NULL
+ * or STRSAFE_FILL_ON_FAILURE. Small fills are left to memset, which uses
+ * vector stores. Large fills would push everything else out of the caches
+ * that way, so they are done with non-temporal stores, which go straight
+ * to memory, when the processor has them.
+ */
+
+#include "strsafe.h"
+#include "../config.h"
+#ifdef HAVE_STDLIB_H
+    #include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+    #include <string.h>
+#endif
+#include "strsafe_kernel.h"
+
+/* The default fill size in bytes from which non-temporal stores are used.
+ * Fills this large would take up most of the first level data cache. */
+#define STRSAFE_FILL_THRESHOLD_DEFAULT 32768
+
+/* Other threads may be filling buffers while the threshold is changed, so
+ * it is read and written atomically where the compiler allows. Nothing
+ * else depends on it, so relaxed ordering is enough. */
+static size_t strsafe_fill_threshold = STRSAFE_FILL_THRESHOLD_DEFAULT;
+
+#ifdef __GNUC__
+    #define STRSAFE_FILL_THRESHOLD_LOAD() \
+            __atomic_load_n(&strsafe_fill_threshold, __ATOMIC_RELAXED)
+    #define STRSAFE_FILL_THRESHOLD_STORE(cb) \
+            __atomic_store_n(&strsafe_fill_threshold, (cb), __ATOMIC_RELAXED)
+#else
+    #define STRSAFE_FILL_THRESHOLD_LOAD() strsafe_fill_threshold
+    #define STRSAFE_FILL_THRESHOLD_STORE(cb) (strsafe_fill_threshold = (cb))
+#endif
+
+/* Fills with non-temporal stores, or NULL if the processor cannot. Set
+ * when the library is loaded. */
+static void (*strsafe_fill_stream)(void * pv, int c, size_t cb) = NULL;
+
+#ifdef __GNUC__
+static void strsafe_fill_init(void) __attribute__((constructor));
+#endif
+
+static void strsafe_fill_init(void){
+    const char * threshold = getenv("STRSAFE_FILL_THRESHOLD");
+
+    if(threshold != NULL && *threshold != '\0'){
+        char * end;
+        unsigned long value = strtoul(threshold, &end, 0);
+        if(*end == '\0'){
+            STRSAFE_FILL_THRESHOLD_STORE((size_t)value);
+        }
+    }
+
+#ifdef HAVE_X86_SIMD_KERNELS
+    if(strsafe_supported_sse2()){
+        strsafe_fill_stream = strsafe_fill_stream_sse2;
+    }
+#endif
+}
+
+void strsafe_fill(
+        void * pv,
+        int c,
+        size_t cb){
+    if(cb >= STRSAFE_FILL_THRESHOLD_LOAD() && strsafe_fill_stream != NULL){
+        strsafe_fill_stream(pv, c, cb);
+    } else {
+        memset(pv, c, cb);
+    }
+}
+
+HRESULT StrSafeSetFillThreshold(
+        size_t cbThreshold){
+    STRSAFE_FILL_THRESHOLD_STORE(cbThreshold);
+    return S_OK;
+}
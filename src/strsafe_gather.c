@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+#include "strsafe.h"
+#include "../config.h"
+#ifdef HAVE_STRING_H
+    #include <string.h>
+#endif
+#ifdef HAVE_WCHAR_H
+    #include <wchar.h>
+#endif
+#include "strsafe_kernel.h"
+
+static HRESULT strsafe_gather_a(
+        LPSTR pszDest,
+        size_t cchDest,
+        const STRSAFE_SEGMENT_A * pSegments,
+        size_t cSegments,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #include "strsafe_gather_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+static HRESULT strsafe_gather_w(
+        LPWSTR pszDest,
+        size_t cchDest,
+        const STRSAFE_SEGMENT_W * pSegments,
+        size_t cSegments,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #include "strsafe_gather_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT StringCchCopyGatherExA(
+        LPSTR pszDest,
+        size_t cchDest,
+        const STRSAFE_SEGMENT_A * pSegments,
+        size_t cSegments,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    if(pszDest != NULL && cchDest != 0){
+        *pszDest = '\0';
+    }
+    return strsafe_gather_a(pszDest, cchDest, pSegments, cSegments,
+            ppszDestEnd, pcchRemaining, dwFlags);
+}
+
+HRESULT StringCchCopyGatherExW(
+        LPWSTR pszDest,
+        size_t cchDest,
+        const STRSAFE_SEGMENT_W * pSegments,
+        size_t cSegments,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    if(pszDest != NULL && cchDest != 0){
+        *pszDest = L'\0';
+    }
+    return strsafe_gather_w(pszDest, cchDest, pSegments, cSegments,
+            ppszDestEnd, pcchRemaining, dwFlags);
+}
+
+HRESULT StringCchCatGatherExA(
+        LPSTR pszDest,
+        size_t cchDest,
+        const STRSAFE_SEGMENT_A * pSegments,
+        size_t cSegments,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    return strsafe_gather_a(pszDest, cchDest, pSegments, cSegments,
+            ppszDestEnd, pcchRemaining, dwFlags);
+}
+
+HRESULT StringCchCatGatherExW(
+        LPWSTR pszDest,
+        size_t cchDest,
+        const STRSAFE_SEGMENT_W * pSegments,
+        size_t cSegments,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    return strsafe_gather_w(pszDest, cchDest, pSegments, cSegments,
+            ppszDestEnd, pcchRemaining, dwFlags);
+}
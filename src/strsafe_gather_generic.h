@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Internal header for generic implementation of libstrsafe functions.
+ * The segments are copied as they are, without looking for null
+ * characters in them.
+ */
+
+#ifndef STRSAFE_GENERIC_WIDE_CHAR
+#error "STRSAFE_GENERIC_WIDE_CHAR must be defined."
+#elif STRSAFE_GENERIC_WIDE_CHAR == 0
+#define STRSAFE_LENGTH_KERNEL strsafe_length_a
+#define STRSAFE_CHAR char
+#define STRSAFE_TEXT(c) c
+#else
+#define STRSAFE_LENGTH_KERNEL strsafe_length_w
+#define STRSAFE_CHAR wchar_t
+#define STRSAFE_TEXT(c) L##c
+#endif
+
+size_t destLength;
+size_t length;
+size_t position;
+size_t i;
+HRESULT result = S_OK;
+
+if(pszDest == NULL || cchDest == 0 || cchDest > STRSAFE_MAX_CCH){
+    /* Invalid value for pszDest or cchDest. */
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+if(pSegments == NULL && cSegments != 0){
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+
+destLength = STRSAFE_LENGTH_KERNEL(pszDest, cchDest);
+if(destLength == cchDest){
+    /* pszDest not null terminated. */
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+
+/* The lengths of the segments are known, so the length of the result is
+ * found without reading any of them. */
+length = destLength;
+for(i = 0; i < cSegments; i++){
+    if(pSegments[i].pch == NULL){
+        if(pSegments[i].cch != 0 && !(dwFlags & STRSAFE_IGNORE_NULLS)){
+            return STRSAFE_E_INVALID_PARAMETER;
+        }
+        continue;
+    }
+    if(pSegments[i].cch >= cchDest - length){
+        /* The segments do not fit in pszDest. */
+        result = STRSAFE_E_INSUFFICIENT_BUFFER;
+        break;
+    }
+    length += pSegments[i].cch;
+}
+
+if(FAILED(result)){
+    if(dwFlags & STRSAFE_NO_TRUNCATION){
+        /* pszDest should be left untouched. */
+        return result;
+    }
+    if(dwFlags & STRSAFE_NULL_ON_FAILURE){
+        /* pszDest should be set to the empty string. */
+        *pszDest = STRSAFE_TEXT('\0');
+        return result;
+    }
+    if(dwFlags & STRSAFE_FILL_ON_FAILURE){
+        /* pszDest should be filled with the lower byte of dwFlags
+         * and null terminated. */
+        strsafe_fill(pszDest, dwFlags & 0xff,
+                (cchDest - 1) * sizeof(STRSAFE_CHAR));
+        pszDest[cchDest - 1] = STRSAFE_TEXT('\0');
+        return result;
+    }
+    /* Copy as much as fits. */
+    length = cchDest - 1;
+}
+
+position = destLength;
+for(i = 0; position < length; i++){
+    size_t cchCopy = pSegments[i].cch;
+
+    if(pSegments[i].pch == NULL){
+        continue;
+    }
+    if(cchCopy > length - position){
+        cchCopy = length - position;
+    }
+    memcpy(pszDest + position, pSegments[i].pch,
+            cchCopy * sizeof(STRSAFE_CHAR));
+    position += cchCopy;
+}
+
+pszDest[length] = STRSAFE_TEXT('\0');
+if(ppszDestEnd != NULL){
+    *ppszDestEnd = pszDest + length;
+}
+if(pcchRemaining != NULL){
+    *pcchRemaining = cchDest - length;
+}
+if((dwFlags & STRSAFE_FILL_BEHIND_NULL) && length + 1 < cchDest){
+    strsafe_fill(pszDest + length + 1, dwFlags & 0xff,
+            (cchDest - length - 1) * sizeof(STRSAFE_CHAR));
+}
+
+return result;
+
+#undef STRSAFE_LENGTH_KERNEL
+#undef STRSAFE_CHAR
+#undef STRSAFE_TEXT
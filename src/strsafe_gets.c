@@ -5,6 +5,8 @@
  * details, see the LICENSE file.
  */
 
+/* getwc_unlocked is a GNU extension. */
+#define _GNU_SOURCE
 #include "strsafe.h"
 #include "../config.h"
 #ifdef HAVE_STDIO_H
@@ -16,17 +18,46 @@
 #ifdef HAVE_WCHAR_H
     #include <wchar.h>
 #endif
+#include "strsafe_internal.h"
+
+HRESULT strsafe_fgets_a(
+        LPSTR pszDest,
+        size_t cchDest,
+        FILE * pStream,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    /* This function has a generic implementation in
+     * strsafe_gets_generic.h. */
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #include "strsafe_gets_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT strsafe_fgets_w(
+        LPWSTR pszDest,
+        size_t cchDest,
+        FILE * pStream,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    /* This function has a generic implementation in
+     * strsafe_gets_generic.h. */
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #include "strsafe_gets_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
 
 HRESULT StringCchGetsA(
         LPSTR pszDest,
         size_t cchDest){
-    return StringCchGetsExA(pszDest, cchDest, NULL, NULL, 0);
+    return strsafe_fgets_a(pszDest, cchDest, stdin, NULL, NULL, 0);
 }
 
 HRESULT StringCchGetsW(
         LPWSTR pszDest,
         size_t cchDest){
-    return StringCchGetsExW(pszDest, cchDest, NULL, NULL, 0);
+    return strsafe_fgets_w(pszDest, cchDest, stdin, NULL, NULL, 0);
 }
 
 HRESULT StringCchGetsExA(
@@ -35,11 +66,8 @@ HRESULT StringCchGetsExA(
         LPSTR * ppszDestEnd,
         size_t * pcchRemaining,
         DWORD dwFlags){
-    /* This function has a generic implementation in
-     * strsafe_gets_generic.h. */
-    #define STRSAFE_GENERIC_WIDE_CHAR 0
-    #include "strsafe_gets_generic.h"
-    #undef STRSAFE_GENERIC_WIDE_CHAR
+    return strsafe_fgets_a(pszDest, cchDest, stdin, ppszDestEnd,
+            pcchRemaining, dwFlags);
 }
 
 HRESULT StringCchGetsExW(
@@ -48,23 +76,21 @@ HRESULT StringCchGetsExW(
         LPWSTR * ppszDestEnd,
         size_t * pcchRemaining,
         DWORD dwFlags){
-    /* This function has a generic implementation in
-     * strsafe_gets_generic.h. */
-    #define STRSAFE_GENERIC_WIDE_CHAR 1
-    #include "strsafe_gets_generic.h"
-    #undef STRSAFE_GENERIC_WIDE_CHAR
+    return strsafe_fgets_w(pszDest, cchDest, stdin, ppszDestEnd,
+            pcchRemaining, dwFlags);
 }
 
 HRESULT StringCbGetsA(
         LPSTR pszDest,
         size_t cbDest){
-    return StringCbGetsExA(pszDest, cbDest, NULL, NULL, 0);
+    return strsafe_fgets_a(pszDest, cbDest, stdin, NULL, NULL, 0);
 }
 
 HRESULT StringCbGetsW(
         LPWSTR pszDest,
         size_t cbDest){
-    return StringCbGetsExW(pszDest, cbDest, NULL, NULL, 0);
+    return strsafe_fgets_w(pszDest, cbDest / sizeof(wchar_t), stdin,
+            NULL, NULL, 0);
 }
 
 HRESULT StringCbGetsExA(
@@ -73,7 +99,7 @@ HRESULT StringCbGetsExA(
         LPSTR * ppszDestEnd,
         size_t * pcbRemaining,
         DWORD dwFlags){
-    return StringCchGetsExA(pszDest, cbDest,
+    return strsafe_fgets_a(pszDest, cbDest, stdin,
             ppszDestEnd, pcbRemaining, dwFlags);
 }
 
@@ -83,8 +109,56 @@ HRESULT StringCbGetsExW(
         LPWSTR * ppszDestEnd,
         size_t * pcbRemaining,
         DWORD dwFlags){
-    HRESULT result = StringCchGetsExW(pszDest, cbDest / sizeof(wchar_t),
+    HRESULT result = strsafe_fgets_w(pszDest, cbDest / sizeof(wchar_t),
+            stdin, ppszDestEnd, pcbRemaining, dwFlags);
+    if(pcbRemaining != NULL){
+        *pcbRemaining *= sizeof(wchar_t);
+    }
+    return result;
+}
+
+HRESULT StringCchFGetsExA(
+        LPSTR pszDest,
+        size_t cchDest,
+        FILE * pStream,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    return strsafe_fgets_a(pszDest, cchDest, pStream, ppszDestEnd,
+            pcchRemaining, dwFlags);
+}
+
+HRESULT StringCchFGetsExW(
+        LPWSTR pszDest,
+        size_t cchDest,
+        FILE * pStream,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    return strsafe_fgets_w(pszDest, cchDest, pStream, ppszDestEnd,
+            pcchRemaining, dwFlags);
+}
+
+HRESULT StringCbFGetsExA(
+        LPSTR pszDest,
+        size_t cbDest,
+        FILE * pStream,
+        LPSTR * ppszDestEnd,
+        size_t * pcbRemaining,
+        DWORD dwFlags){
+    return strsafe_fgets_a(pszDest, cbDest, pStream,
             ppszDestEnd, pcbRemaining, dwFlags);
+}
+
+HRESULT StringCbFGetsExW(
+        LPWSTR pszDest,
+        size_t cbDest,
+        FILE * pStream,
+        LPWSTR * ppszDestEnd,
+        size_t * pcbRemaining,
+        DWORD dwFlags){
+    HRESULT result = strsafe_fgets_w(pszDest, cbDest / sizeof(wchar_t),
+            pStream, ppszDestEnd, pcbRemaining, dwFlags);
     if(pcbRemaining != NULL){
         *pcbRemaining *= sizeof(wchar_t);
     }
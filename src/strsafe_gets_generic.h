@@ -7,19 +7,29 @@
 
 /*
  * Internal header for generic implementation of libstrsafe functions.
+ * pStream is locked once for the whole line, and the characters are then
+ * read from its buffer without locking it again for each of them.
  */
 
 #ifndef STRSAFE_GENERIC_WIDE_CHAR
 #error "STRSAFE_GENERIC_WIDE_CHAR must be defined."
 #elif STRSAFE_GENERIC_WIDE_CHAR == 0
 #define STRSAFE_CHAR_INT int
-#define STRSAFE_GETCHAR getchar
+#if defined(HAVE_FLOCKFILE) && defined(HAVE_GETC_UNLOCKED)
+    #define STRSAFE_GETC getc_unlocked
+#else
+    #define STRSAFE_GETC getc
+#endif
 #define STRSAFE_EOF EOF
 #define STRSAFE_CHAR char
 #define STRSAFE_TEXT(c) c
 #else
 #define STRSAFE_CHAR_INT wint_t
-#define STRSAFE_GETCHAR getwchar
+#if defined(HAVE_FLOCKFILE) && defined(HAVE_GETWC_UNLOCKED)
+    #define STRSAFE_GETC getwc_unlocked
+#else
+    #define STRSAFE_GETC getwc
+#endif
 #define STRSAFE_EOF WEOF
 #define STRSAFE_CHAR wchar_t
 #define STRSAFE_TEXT(c) L##c
@@ -28,6 +38,9 @@
 size_t length = 0;
 HRESULT result = S_OK;
 
+if(pStream == NULL){
+    return STRSAFE_E_INVALID_PARAMETER;
+}
 if(cchDest < 2){
     if(cchDest == 1){
         *pszDest = STRSAFE_TEXT('\0');
@@ -38,9 +51,13 @@ if(cchDest > STRSAFE_MAX_CCH){
     return STRSAFE_E_INVALID_PARAMETER;
 }
 
+#ifdef HAVE_FLOCKFILE
+flockfile(pStream);
+#endif
 /* If loop condition fails, the buffer was too small. */
 while(length < cchDest - 1){
-    STRSAFE_CHAR_INT c = STRSAFE_GETCHAR();
+    STRSAFE_CHAR_INT c;
+    c = STRSAFE_GETC(pStream);
     if(c == STRSAFE_EOF){
         if(length == 0){
             result = STRSAFE_E_END_OF_FILE;
@@ -53,10 +70,14 @@ while(length < cchDest - 1){
     }
     pszDest[length++] = (STRSAFE_CHAR)c;
 }
+#ifdef HAVE_FLOCKFILE
+funlockfile(pStream);
+#endif
 
 if((dwFlags & STRSAFE_FILL_ON_FAILURE) && FAILED(result)){
     /* Fill entire buffer with lower byte of dwFlags and null terminate. */
-    memset(pszDest, dwFlags & 0xff, (cchDest - 1) * sizeof(STRSAFE_CHAR));
+    strsafe_fill(pszDest, dwFlags & 0xff,
+            (cchDest - 1) * sizeof(STRSAFE_CHAR));
     length = cchDest - 1;
 }else if((dwFlags & (STRSAFE_NULL_ON_FAILURE | STRSAFE_NO_TRUNCATION))
         && FAILED(result)){
@@ -75,14 +96,14 @@ if(pcchRemaining != NULL){
 }
 
 if(dwFlags & STRSAFE_FILL_BEHIND_NULL){
-    memset(pszDest + length + 1, dwFlags & 0xff,
+    strsafe_fill(pszDest + length + 1, dwFlags & 0xff,
             (cchDest - length - 1) * sizeof(STRSAFE_CHAR));
 }
 
 return result;
 
 #undef STRSAFE_CHAR_INT
-#undef STRSAFE_GETCHAR
+#undef STRSAFE_GETC
 #undef STRSAFE_EOF
 #undef STRSAFE_CHAR
 #undef STRSAFE_TEXT
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Internal header for the functions that implement the libstrsafe
+ * functions. The public functions call these directly instead of calling
+ * each other, so calls within the shared library do not go through the
+ * PLT and the compiler is free to inline them. They take the same
+ * parameters as the public Cch functions of the same name.
+ */
+
+#ifndef STRSAFE_INTERNAL_H
+#define STRSAFE_INTERNAL_H
+
+#include "strsafe.h"
+
+#if defined(__GNUC__) && !defined(_WIN32)
+    #define STRSAFE_HIDDEN __attribute__((visibility("hidden")))
+#else
+    #define STRSAFE_HIDDEN
+#endif
+
+/**
+ * Implements StringCchLengthA and StringCchLengthW.
+ */
+STRSAFE_HIDDEN HRESULT strsafe_length_cch_a(
+    LPCSTR psz,
+    size_t cchMax,
+    size_t * pcch
+);
+STRSAFE_HIDDEN HRESULT strsafe_length_cch_w(
+    LPCWSTR psz,
+    size_t cchMax,
+    size_t * pcch
+);
+
+/**
+ * Implements StringCchCatNExA and StringCchCatNExW, which all the
+ * functions that concatenate or copy strings end up in. The versions
+ * without dwFlags are the same as with dwFlags set to 0, only faster.
+ */
+STRSAFE_HIDDEN HRESULT strsafe_catn_a(
+    LPSTR pszDest,
+    size_t cchDest,
+    LPCSTR pszSrc,
+    size_t cchSrc,
+    LPSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+STRSAFE_HIDDEN HRESULT strsafe_catn_w(
+    LPWSTR pszDest,
+    size_t cchDest,
+    LPCWSTR pszSrc,
+    size_t cchSrc,
+    LPWSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+STRSAFE_HIDDEN HRESULT strsafe_catn_a_no_flags(
+    LPSTR pszDest,
+    size_t cchDest,
+    LPCSTR pszSrc,
+    size_t cchSrc,
+    LPSTR * ppszDestEnd,
+    size_t * pcchRemaining
+);
+STRSAFE_HIDDEN HRESULT strsafe_catn_w_no_flags(
+    LPWSTR pszDest,
+    size_t cchDest,
+    LPCWSTR pszSrc,
+    size_t cchSrc,
+    LPWSTR * ppszDestEnd,
+    size_t * pcchRemaining
+);
+
+/**
+ * Implements StringCchCatNExA and StringCchCatNExW for the Ex2 functions,
+ * which also get the length of the whole result in *pcchRequired. It is
+ * only used when the caller asks for that length, since finding it means
+ * reading all of pszSrc even if it does not fit.
+ */
+STRSAFE_HIDDEN HRESULT strsafe_catn_a_required(
+    LPSTR pszDest,
+    size_t cchDest,
+    LPCSTR pszSrc,
+    size_t cchSrc,
+    LPSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags,
+    size_t * pcchRequired
+);
+STRSAFE_HIDDEN HRESULT strsafe_catn_w_required(
+    LPWSTR pszDest,
+    size_t cchDest,
+    LPCWSTR pszSrc,
+    size_t cchSrc,
+    LPWSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags,
+    size_t * pcchRequired
+);
+
+/**
+ * Implements StringCchVPrintfExA and StringCchVPrintfExW, with versions
+ * for dwFlags set to 0 like for strsafe_catn_a.
+ */
+STRSAFE_HIDDEN HRESULT strsafe_vprintf_a(
+    LPSTR pszDest,
+    size_t cchDest,
+    LPSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags,
+    LPCSTR pszFormat,
+    va_list argList
+);
+STRSAFE_HIDDEN HRESULT strsafe_vprintf_w(
+    LPWSTR pszDest,
+    size_t cchDest,
+    LPWSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags,
+    LPCWSTR pszFormat,
+    va_list argList
+);
+STRSAFE_HIDDEN HRESULT strsafe_vprintf_a_no_flags(
+    LPSTR pszDest,
+    size_t cchDest,
+    LPSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    LPCSTR pszFormat,
+    va_list argList
+);
+STRSAFE_HIDDEN HRESULT strsafe_vprintf_w_no_flags(
+    LPWSTR pszDest,
+    size_t cchDest,
+    LPWSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    LPCWSTR pszFormat,
+    va_list argList
+);
+
+/**
+ * Implements StringCchFGetsExA and StringCchFGetsExW. The Gets functions
+ * call them with stdin.
+ */
+STRSAFE_HIDDEN HRESULT strsafe_fgets_a(
+    LPSTR pszDest,
+    size_t cchDest,
+    FILE * pStream,
+    LPSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+STRSAFE_HIDDEN HRESULT strsafe_fgets_w(
+    LPWSTR pszDest,
+    size_t cchDest,
+    FILE * pStream,
+    LPWSTR * ppszDestEnd,
+    size_t * pcchRemaining,
+    DWORD dwFlags
+);
+
+/**
+ * Allocate and free memory with the allocator set by StrSafeSetAllocator.
+ */
+STRSAFE_HIDDEN void * strsafe_realloc(
+    void * pv,
+    size_t cb
+);
+STRSAFE_HIDDEN void strsafe_free(
+    void * pv
+);
+
+/**
+ * Fills a buffer for STRSAFE_FILL_BEHIND_NULL and STRSAFE_FILL_ON_FAILURE.
+ * Works like memset, but fills of at least the size set by
+ * StrSafeSetFillThreshold bypass the caches.
+ */
+STRSAFE_HIDDEN void strsafe_fill(
+    void * pv,
+    int c,
+    size_t cb
+);
+
+#endif /* STRSAFE_INTERNAL_H */
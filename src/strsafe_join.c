@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+#include "strsafe.h"
+#include "../config.h"
+#ifdef HAVE_STRING_H
+    #include <string.h>
+#endif
+#ifdef HAVE_WCHAR_H
+    #include <wchar.h>
+#endif
+#include "strsafe_kernel.h"
+
+/**
+ * Copies a segment, or as much of it as fits.
+ *
+ * @param pvDest The buffer to copy to.
+ * @param pvSrc The segment.
+ * @param cch The length of the segment in characters.
+ * @param cchMax The maximum number of characters to copy.
+ * @param cbChar The size of a character in bytes.
+ *
+ * @return The number of characters copied.
+ */
+static size_t strsafe_join_copy(
+        void * pvDest,
+        const void * pvSrc,
+        size_t cch,
+        size_t cchMax,
+        size_t cbChar){
+    if(cch > cchMax){
+        cch = cchMax;
+    }
+    memcpy(pvDest, pvSrc, cch * cbChar);
+
+    return cch;
+}
+
+HRESULT StringCchJoinExA(
+        LPSTR pszDest,
+        size_t cchDest,
+        LPCSTR * pItems,
+        size_t cItems,
+        LPCSTR pszSeparator,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #include "strsafe_join_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT StringCchJoinExW(
+        LPWSTR pszDest,
+        size_t cchDest,
+        LPCWSTR * pItems,
+        size_t cItems,
+        LPCWSTR pszSeparator,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #include "strsafe_join_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT StringCchJoinGatherExA(
+        LPSTR pszDest,
+        size_t cchDest,
+        const STRSAFE_SEGMENT_A * pItems,
+        size_t cItems,
+        LPCSTR pszSeparator,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #define STRSAFE_GENERIC_SEGMENTS 1
+    #include "strsafe_join_generic.h"
+    #undef STRSAFE_GENERIC_SEGMENTS
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT StringCchJoinGatherExW(
+        LPWSTR pszDest,
+        size_t cchDest,
+        const STRSAFE_SEGMENT_W * pItems,
+        size_t cItems,
+        LPCWSTR pszSeparator,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #define STRSAFE_GENERIC_SEGMENTS 1
+    #include "strsafe_join_generic.h"
+    #undef STRSAFE_GENERIC_SEGMENTS
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
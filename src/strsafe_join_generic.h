@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Internal header for generic implementation of libstrsafe functions.
+ * The items to join are the cItems strings at pItems, or segments if the
+ * including function defines STRSAFE_GENERIC_SEGMENTS. The separator is
+ * measured once and then copied like a segment.
+ */
+
+#ifndef STRSAFE_GENERIC_WIDE_CHAR
+#error "STRSAFE_GENERIC_WIDE_CHAR must be defined."
+#elif STRSAFE_GENERIC_WIDE_CHAR == 0
+#define STRSAFE_LENGTH_KERNEL strsafe_length_a
+#define STRSAFE_COPY_KERNEL strsafe_copy_a
+#define STRSAFE_CHAR char
+#define STRSAFE_TEXT(c) c
+#else
+#define STRSAFE_LENGTH_KERNEL strsafe_length_w
+#define STRSAFE_COPY_KERNEL strsafe_copy_w
+#define STRSAFE_CHAR wchar_t
+#define STRSAFE_TEXT(c) L##c
+#endif
+
+/* STRSAFE_ITEM(i) is the start of item i and STRSAFE_ITEM_LENGTH(i, cchMax)
+ * its length, or cchMax if it is longer than that. STRSAFE_ITEM_COPY(dest,
+ * i, cchMax) copies at most cchMax characters of it and returns the number
+ * copied, and STRSAFE_ITEM_LONGER(i, cchKnown) tells whether there is more
+ * to it after the first cchKnown characters. */
+#ifdef STRSAFE_GENERIC_SEGMENTS
+#define STRSAFE_ITEM(i) pItems[i].pch
+#define STRSAFE_ITEM_LENGTH(i, cchMax) \
+        (pItems[i].cch < (cchMax) ? pItems[i].cch : (cchMax))
+#define STRSAFE_ITEM_COPY(dest, i, cchMax) \
+        strsafe_join_copy(dest, pItems[i].pch, pItems[i].cch, cchMax, \
+                sizeof(STRSAFE_CHAR))
+#define STRSAFE_ITEM_LONGER(i, cchKnown) (pItems[i].cch > (cchKnown))
+#else
+#define STRSAFE_ITEM(i) pItems[i]
+#define STRSAFE_ITEM_LENGTH(i, cchMax) \
+        STRSAFE_LENGTH_KERNEL(pItems[i], cchMax)
+#define STRSAFE_ITEM_COPY(dest, i, cchMax) \
+        STRSAFE_COPY_KERNEL(dest, pItems[i], cchMax)
+#define STRSAFE_ITEM_LONGER(i, cchKnown) \
+        (pItems[i][cchKnown] != STRSAFE_TEXT('\0'))
+#endif
+
+size_t separatorLength = 0;
+size_t length;
+size_t i;
+HRESULT result = S_OK;
+
+if(pszDest == NULL || cchDest == 0 || cchDest > STRSAFE_MAX_CCH){
+    /* Invalid value for pszDest or cchDest. */
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+if(pItems == NULL && cItems != 0){
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+if(pszSeparator == NULL && !(dwFlags & STRSAFE_IGNORE_NULLS)){
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+for(i = 0; i < cItems; i++){
+#ifdef STRSAFE_GENERIC_SEGMENTS
+    if(pItems[i].pch == NULL && pItems[i].cch != 0 &&
+            !(dwFlags & STRSAFE_IGNORE_NULLS)){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+#else
+    if(pItems[i] == NULL && !(dwFlags & STRSAFE_IGNORE_NULLS)){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+#endif
+}
+
+length = STRSAFE_LENGTH_KERNEL(pszDest, cchDest);
+if(length == cchDest){
+    /* pszDest not null terminated. */
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+
+/* A separator of cchDest characters or more never fits, so there is no
+ * need to look any further for its end. */
+if(pszSeparator != NULL && cItems > 1){
+    separatorLength = STRSAFE_LENGTH_KERNEL(pszSeparator, cchDest);
+}
+
+if(!(dwFlags & (STRSAFE_NO_TRUNCATION | STRSAFE_NULL_ON_FAILURE |
+        STRSAFE_FILL_ON_FAILURE))){
+    /* Copy the separators and items while looking for the null
+     * terminations of the items, until pszDest is full. */
+    for(i = 0; i < cItems; i++){
+        size_t cchCopy;
+        size_t copied;
+
+        if(i > 0 && separatorLength != 0){
+            cchCopy = cchDest - 1 - length;
+            if(separatorLength > cchCopy){
+                memcpy(pszDest + length, pszSeparator,
+                        cchCopy * sizeof(STRSAFE_CHAR));
+                length += cchCopy;
+                result = STRSAFE_E_INSUFFICIENT_BUFFER;
+                break;
+            }
+            memcpy(pszDest + length, pszSeparator,
+                    separatorLength * sizeof(STRSAFE_CHAR));
+            length += separatorLength;
+        }
+
+        if(STRSAFE_ITEM(i) == NULL){
+            continue;
+        }
+        cchCopy = cchDest - 1 - length;
+        copied = STRSAFE_ITEM_COPY(pszDest + length, i, cchCopy);
+        length += copied;
+        if(copied == cchCopy && STRSAFE_ITEM_LONGER(i, cchCopy)){
+            /* The items are too long, pszDest is full. */
+            result = STRSAFE_E_INSUFFICIENT_BUFFER;
+            break;
+        }
+    }
+} else {
+    /* A truncated result would be thrown away, so first find the length
+     * of the result. No item is read further than the space left in
+     * pszDest. Only then is the result written, in one pass, so on
+     * failure pszDest is left as it was. */
+    size_t totalLength = length;
+
+    for(i = 0; i < cItems; i++){
+        if(i > 0 && separatorLength != 0){
+            if(separatorLength >= cchDest - totalLength){
+                result = STRSAFE_E_INSUFFICIENT_BUFFER;
+                break;
+            }
+            totalLength += separatorLength;
+        }
+        if(STRSAFE_ITEM(i) == NULL){
+            continue;
+        }
+        totalLength += STRSAFE_ITEM_LENGTH(i, cchDest - totalLength);
+        if(totalLength >= cchDest){
+            result = STRSAFE_E_INSUFFICIENT_BUFFER;
+            break;
+        }
+    }
+
+    if(FAILED(result)){
+        if(dwFlags & STRSAFE_NO_TRUNCATION){
+            /* pszDest should be left untouched. */
+            return result;
+        }
+        if(dwFlags & STRSAFE_NULL_ON_FAILURE){
+            /* pszDest should be set to the empty string. */
+            *pszDest = STRSAFE_TEXT('\0');
+            return result;
+        }
+        /* pszDest should be filled with the lower byte of dwFlags and
+         * null terminated. */
+        strsafe_fill(pszDest, dwFlags & 0xff,
+                (cchDest - 1) * sizeof(STRSAFE_CHAR));
+        pszDest[cchDest - 1] = STRSAFE_TEXT('\0');
+        return result;
+    }
+
+    for(i = 0; i < cItems; i++){
+        if(i > 0 && separatorLength != 0){
+            memcpy(pszDest + length, pszSeparator,
+                    separatorLength * sizeof(STRSAFE_CHAR));
+            length += separatorLength;
+        }
+        if(STRSAFE_ITEM(i) != NULL){
+            length += STRSAFE_ITEM_COPY(pszDest + length, i,
+                    totalLength - length);
+        }
+    }
+}
+
+pszDest[length] = STRSAFE_TEXT('\0');
+if(ppszDestEnd != NULL){
+    *ppszDestEnd = pszDest + length;
+}
+if(pcchRemaining != NULL){
+    *pcchRemaining = cchDest - length;
+}
+if((dwFlags & STRSAFE_FILL_BEHIND_NULL) && length + 1 < cchDest){
+    strsafe_fill(pszDest + length + 1, dwFlags & 0xff,
+            (cchDest - length - 1) * sizeof(STRSAFE_CHAR));
+}
+
+return result;
+
+#undef STRSAFE_ITEM
+#undef STRSAFE_ITEM_LENGTH
+#undef STRSAFE_ITEM_COPY
+#undef STRSAFE_ITEM_LONGER
+#undef STRSAFE_LENGTH_KERNEL
+#undef STRSAFE_COPY_KERNEL
+#undef STRSAFE_CHAR
+#undef STRSAFE_TEXT
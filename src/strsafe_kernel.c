@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+#include "strsafe.h"
+#include "../config.h"
+#ifdef HAVE_STDLIB_H
+    #include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+    #include <string.h>
+#endif
+#include "strsafe_kernel.h"
+
+static int strsafe_supported_always(void){
+    return 1;
+}
+
+size_t strsafe_length_a_scalar(
+        const char * psz,
+        size_t cchMax){
+    size_t length;
+
+    for(length = 0; length < cchMax; length++){
+        if(psz[length] == '\0'){
+            break;
+        }
+    }
+
+    return length;
+}
+
+size_t strsafe_length_w_scalar(
+        const wchar_t * psz,
+        size_t cchMax){
+    size_t length;
+
+    for(length = 0; length < cchMax; length++){
+        if(psz[length] == L'\0'){
+            break;
+        }
+    }
+
+    return length;
+}
+
+size_t strsafe_copy_a_scalar(
+        char * pszDest,
+        const char * pszSrc,
+        size_t cchMax){
+    size_t length;
+
+    for(length = 0; length < cchMax; length++){
+        if(pszSrc[length] == '\0'){
+            break;
+        }
+        pszDest[length] = pszSrc[length];
+    }
+
+    return length;
+}
+
+size_t strsafe_copy_w_scalar(
+        wchar_t * pszDest,
+        const wchar_t * pszSrc,
+        size_t cchMax){
+    size_t length;
+
+    for(length = 0; length < cchMax; length++){
+        if(pszSrc[length] == L'\0'){
+            break;
+        }
+        pszDest[length] = pszSrc[length];
+    }
+
+    return length;
+}
+
+/* All kernel sets, with the preferred ones first. The last two sets are
+ * supported everywhere, the scalar set is only used when asked for. */
+static const strsafe_kernel_table strsafe_kernel_tables[] = {
+#ifdef HAVE_X86_AVX512_KERNELS
+    {
+        "avx512",
+        strsafe_supported_avx512,
+        strsafe_length_a_avx512,
+        strsafe_length_w_avx512,
+        strsafe_copy_a_avx512,
+        strsafe_copy_w_avx512
+    },
+#endif
+#ifdef HAVE_X86_SIMD_KERNELS
+    {
+        "avx2",
+        strsafe_supported_avx2,
+        strsafe_length_a_avx2,
+        strsafe_length_w_avx2,
+        strsafe_copy_a_avx2,
+        strsafe_copy_w_avx2
+    },
+    {
+        "sse2",
+        strsafe_supported_sse2,
+        strsafe_length_a_sse2,
+        strsafe_length_w_sse2,
+        strsafe_copy_a_sse2,
+        strsafe_copy_w_sse2
+    },
+#endif
+    {
+        "swar",
+        strsafe_supported_always,
+        strsafe_length_a_swar,
+        strsafe_length_w_swar,
+        strsafe_copy_a_swar,
+        strsafe_copy_w_swar
+    },
+    {
+        "scalar",
+        strsafe_supported_always,
+        strsafe_length_a_scalar,
+        strsafe_length_w_scalar,
+        strsafe_copy_a_scalar,
+        strsafe_copy_w_scalar
+    }
+};
+
+/* Start out with the portable kernels so that the library is usable even
+ * before strsafe_kernel_init has run. */
+strsafe_kernel_table strsafe_kernels = {
+    "scalar",
+    strsafe_supported_always,
+    strsafe_length_a_scalar,
+    strsafe_length_w_scalar,
+    strsafe_copy_a_scalar,
+    strsafe_copy_w_scalar
+};
+
+/* The names reported by StrSafeGetKernelInfo. */
+static STRSAFE_KERNEL_INFO strsafe_kernel_info = {
+    "scalar",
+    "scalar",
+    "scalar",
+    "scalar",
+    "table"
+};
+
+static int strsafe_provides_length_a(const strsafe_kernel_table * table){
+    return table->length_a != NULL;
+}
+
+static int strsafe_provides_length_w(const strsafe_kernel_table * table){
+    return table->length_w != NULL;
+}
+
+static int strsafe_provides_copy_a(const strsafe_kernel_table * table){
+    return table->copy_a != NULL;
+}
+
+static int strsafe_provides_copy_w(const strsafe_kernel_table * table){
+    return table->copy_w != NULL;
+}
+
+/**
+ * Picks the set to take a kernel from. This is the named set if it is
+ * supported and otherwise the best supported set. If that set does not
+ * provide the kernel, the next supported set that does is picked.
+ *
+ * @param name The name of the set to use, or NULL for the best one.
+ * @param provides Checks whether a set provides the kernel.
+ *
+ * @return The set to take the kernel from.
+ */
+static const strsafe_kernel_table * strsafe_kernel_choose(
+        const char * name,
+        int (*provides)(const strsafe_kernel_table * table)){
+    const size_t count =
+            sizeof(strsafe_kernel_tables) / sizeof(strsafe_kernel_tables[0]);
+    size_t first = 0;
+    size_t i;
+
+    if(name != NULL){
+        for(i = 0; i < count; i++){
+            if(strcmp(name, strsafe_kernel_tables[i].name) == 0 &&
+                    strsafe_kernel_tables[i].supported()){
+                first = i;
+                break;
+            }
+        }
+    }
+
+    for(i = first; i < count; i++){
+        if(provides(&strsafe_kernel_tables[i]) &&
+                strsafe_kernel_tables[i].supported()){
+            return &strsafe_kernel_tables[i];
+        }
+    }
+
+    /* Not reached, the scalar set provides every kernel. */
+    return &strsafe_kernel_tables[count - 1];
+}
+
+#ifdef STRSAFE_KERNEL_IFUNC
+/*
+ * The resolvers run while the dynamic linker is still relocating the
+ * library, when the C library may not be usable yet. They therefore pick
+ * the kernels from what the processor supports only, and STRSAFE_KERNEL
+ * is not used.
+ */
+
+static size_t (*strsafe_resolve_length_a(void))(const char *, size_t){
+    return strsafe_kernel_choose(NULL, strsafe_provides_length_a)->length_a;
+}
+
+static size_t (*strsafe_resolve_length_w(void))(const wchar_t *, size_t){
+    return strsafe_kernel_choose(NULL, strsafe_provides_length_w)->length_w;
+}
+
+static size_t (*strsafe_resolve_copy_a(void))(char *, const char *,
+        size_t){
+    return strsafe_kernel_choose(NULL, strsafe_provides_copy_a)->copy_a;
+}
+
+static size_t (*strsafe_resolve_copy_w(void))(wchar_t *, const wchar_t *,
+        size_t){
+    return strsafe_kernel_choose(NULL, strsafe_provides_copy_w)->copy_w;
+}
+
+size_t strsafe_length_a(const char * psz, size_t cchMax)
+        __attribute__((ifunc("strsafe_resolve_length_a")));
+size_t strsafe_length_w(const wchar_t * psz, size_t cchMax)
+        __attribute__((ifunc("strsafe_resolve_length_w")));
+size_t strsafe_copy_a(char * pszDest, const char * pszSrc, size_t cchMax)
+        __attribute__((ifunc("strsafe_resolve_copy_a")));
+size_t strsafe_copy_w(wchar_t * pszDest, const wchar_t * pszSrc,
+        size_t cchMax)
+        __attribute__((ifunc("strsafe_resolve_copy_w")));
+#endif /* STRSAFE_KERNEL_IFUNC */
+
+#ifdef __GNUC__
+static void strsafe_kernel_init(void) __attribute__((constructor));
+#endif
+
+static void strsafe_kernel_init(void){
+#ifdef STRSAFE_KERNEL_IFUNC
+    /* Report the kernels that the resolvers bound. */
+    const char * name = NULL;
+#else
+    const char * name = getenv("STRSAFE_KERNEL");
+#endif
+    const strsafe_kernel_table * table;
+
+    table = strsafe_kernel_choose(name, strsafe_provides_length_a);
+    strsafe_kernels.length_a = table->length_a;
+    strsafe_kernel_info.pszLengthA = table->name;
+    table = strsafe_kernel_choose(name, strsafe_provides_length_w);
+    strsafe_kernels.length_w = table->length_w;
+    strsafe_kernel_info.pszLengthW = table->name;
+    table = strsafe_kernel_choose(name, strsafe_provides_copy_a);
+    strsafe_kernels.copy_a = table->copy_a;
+    strsafe_kernel_info.pszCopyA = table->name;
+    table = strsafe_kernel_choose(name, strsafe_provides_copy_w);
+    strsafe_kernels.copy_w = table->copy_w;
+    strsafe_kernel_info.pszCopyW = table->name;
+
+#ifdef STRSAFE_KERNEL_IFUNC
+    strsafe_kernel_info.pszDispatch = "ifunc";
+#endif
+}
+
+HRESULT StrSafeGetKernelInfo(
+        STRSAFE_KERNEL_INFO * pInfo){
+    if(pInfo == NULL){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+
+    *pInfo = strsafe_kernel_info;
+    return S_OK;
+}
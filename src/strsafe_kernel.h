@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Internal header for the kernels that scan strings on behalf of the
+ * libstrsafe functions. Each kernel has a portable implementation and
+ * optionally a number of implementations for specific instruction sets.
+ * The implementations to use are picked once, when the library is loaded.
+ *
+ * The kernels are called as strsafe_length_a, strsafe_length_w,
+ * strsafe_copy_a and strsafe_copy_w. In the shared library, these are GNU
+ * indirect functions that the dynamic linker binds to the best
+ * implementations for the processor. Otherwise they call through the
+ * strsafe_kernels table, and the STRSAFE_KERNEL environment variable can
+ * name the set to use instead of the best one.
+ */
+
+#ifndef STRSAFE_KERNEL_H
+#define STRSAFE_KERNEL_H
+
+#include <stddef.h>
+#include "strsafe_internal.h"
+
+/* Libtool defines PIC when compiling the objects for the shared library.
+ * Indirect functions in a static library would be resolved before the C
+ * library is set up in static programs, so the table is used there. */
+#if defined(HAVE_GNU_IFUNC) && defined(PIC)
+    #define STRSAFE_KERNEL_IFUNC 1
+#endif
+
+/**
+ * A set of kernel implementations.
+ */
+typedef struct strsafe_kernel_table {
+    /**
+     * The name of the instruction set the kernels are written for.
+     */
+    const char * name;
+
+    /**
+     * Checks that the kernels can be run on the current processor.
+     *
+     * @return Non-zero if the kernels are supported and zero otherwise.
+     */
+    int (*supported)(void);
+
+    /*
+     * The kernels of a set may be NULL, in which case the kernel of the
+     * next set in order of preference is used.
+     */
+
+    /**
+     * Finds the length of a string. Never reads psz[cchMax] or
+     * anything beyond it that is on a different page.
+     *
+     * @param psz The string to scan. It must not be NULL.
+     * @param cchMax The maximum number of characters to scan.
+     *
+     * @return The number of characters before the null termination, or
+     *         cchMax if the first cchMax characters contain no null
+     *         termination.
+     */
+    size_t (*length_a)(const char * psz, size_t cchMax);
+    size_t (*length_w)(const wchar_t * psz, size_t cchMax);
+
+    /**
+     * Copies a string without its null termination. The copy stops at
+     * the null termination of pszSrc or after cchMax characters,
+     * whichever comes first. Reads of pszSrc follow the same rules as
+     * for the length kernels and pszDest[cchMax] and beyond is never
+     * written.
+     *
+     * @param pszDest The buffer to copy to.
+     * @param pszSrc The string to copy. It must not be NULL.
+     * @param cchMax The maximum number of characters to copy.
+     *
+     * @return The number of characters copied. This is the same as the
+     *         length kernels would return for pszSrc and cchMax.
+     */
+    size_t (*copy_a)(char * pszDest, const char * pszSrc, size_t cchMax);
+    size_t (*copy_w)(wchar_t * pszDest, const wchar_t * pszSrc,
+            size_t cchMax);
+} strsafe_kernel_table;
+
+/**
+ * The kernels selected for the current processor. The kernels may come
+ * from different sets, so the name and supported members are not used.
+ * Unless the kernels are bound as indirect functions, all calls go
+ * through this table.
+ */
+extern STRSAFE_HIDDEN strsafe_kernel_table strsafe_kernels;
+
+#ifdef STRSAFE_KERNEL_IFUNC
+STRSAFE_HIDDEN size_t strsafe_length_a(const char * psz, size_t cchMax);
+STRSAFE_HIDDEN size_t strsafe_length_w(const wchar_t * psz, size_t cchMax);
+STRSAFE_HIDDEN size_t strsafe_copy_a(char * pszDest, const char * pszSrc,
+        size_t cchMax);
+STRSAFE_HIDDEN size_t strsafe_copy_w(wchar_t * pszDest,
+        const wchar_t * pszSrc, size_t cchMax);
+#else
+    #define strsafe_length_a strsafe_kernels.length_a
+    #define strsafe_length_w strsafe_kernels.length_w
+    #define strsafe_copy_a strsafe_kernels.copy_a
+    #define strsafe_copy_w strsafe_kernels.copy_w
+#endif
+
+STRSAFE_HIDDEN size_t strsafe_length_a_scalar(const char * psz,
+        size_t cchMax);
+STRSAFE_HIDDEN size_t strsafe_length_w_scalar(const wchar_t * psz,
+        size_t cchMax);
+STRSAFE_HIDDEN size_t strsafe_copy_a_scalar(char * pszDest,
+        const char * pszSrc, size_t cchMax);
+STRSAFE_HIDDEN size_t strsafe_copy_w_scalar(wchar_t * pszDest,
+        const wchar_t * pszSrc, size_t cchMax);
+
+STRSAFE_HIDDEN size_t strsafe_length_a_swar(const char * psz,
+        size_t cchMax);
+STRSAFE_HIDDEN size_t strsafe_length_w_swar(const wchar_t * psz,
+        size_t cchMax);
+STRSAFE_HIDDEN size_t strsafe_copy_a_swar(char * pszDest,
+        const char * pszSrc, size_t cchMax);
+STRSAFE_HIDDEN size_t strsafe_copy_w_swar(wchar_t * pszDest,
+        const wchar_t * pszSrc, size_t cchMax);
+
+#ifdef HAVE_X86_SIMD_KERNELS
+STRSAFE_HIDDEN int strsafe_supported_sse2(void);
+STRSAFE_HIDDEN int strsafe_supported_avx2(void);
+STRSAFE_HIDDEN size_t strsafe_length_a_sse2(const char * psz,
+        size_t cchMax);
+STRSAFE_HIDDEN size_t strsafe_length_a_avx2(const char * psz,
+        size_t cchMax);
+STRSAFE_HIDDEN size_t strsafe_length_w_sse2(const wchar_t * psz,
+        size_t cchMax);
+STRSAFE_HIDDEN size_t strsafe_length_w_avx2(const wchar_t * psz,
+        size_t cchMax);
+STRSAFE_HIDDEN size_t strsafe_copy_a_sse2(char * pszDest,
+        const char * pszSrc, size_t cchMax);
+STRSAFE_HIDDEN size_t strsafe_copy_a_avx2(char * pszDest,
+        const char * pszSrc, size_t cchMax);
+STRSAFE_HIDDEN size_t strsafe_copy_w_sse2(wchar_t * pszDest,
+        const wchar_t * pszSrc, size_t cchMax);
+STRSAFE_HIDDEN size_t strsafe_copy_w_avx2(wchar_t * pszDest,
+        const wchar_t * pszSrc, size_t cchMax);
+
+/**
+ * Works like memset, but with non-temporal stores that do not bring the
+ * buffer into the caches. Used by strsafe_fill for large fills.
+ */
+STRSAFE_HIDDEN void strsafe_fill_stream_sse2(void * pv, int c, size_t cb);
+#endif
+
+#ifdef HAVE_X86_AVX512_KERNELS
+STRSAFE_HIDDEN int strsafe_supported_avx512(void);
+STRSAFE_HIDDEN size_t strsafe_length_a_avx512(const char * psz,
+        size_t cchMax);
+STRSAFE_HIDDEN size_t strsafe_length_w_avx512(const wchar_t * psz,
+        size_t cchMax);
+STRSAFE_HIDDEN size_t strsafe_copy_a_avx512(char * pszDest,
+        const char * pszSrc, size_t cchMax);
+STRSAFE_HIDDEN size_t strsafe_copy_w_avx512(wchar_t * pszDest,
+        const wchar_t * pszSrc, size_t cchMax);
+#endif
+
+#endif /* STRSAFE_KERNEL_H */
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Word-at-a-time kernels. They work on 64-bit words with plain integer
+ * arithmetic, so they can be used on any processor.
+ */
+
+#include "strsafe.h"
+#include "../config.h"
+#ifdef HAVE_STRING_H
+    #include <string.h>
+#endif
+#include "strsafe_kernel.h"
+
+/* A word with the lowest bit of every lane set, for lanes of the size of
+ * type. */
+#define STRSAFE_SWAR_ONES(type) \
+    (sizeof(type) == 1 ? UINT64_C(0x0101010101010101) : \
+     sizeof(type) == 2 ? UINT64_C(0x0001000100010001) : \
+                         UINT64_C(0x0000000100000001))
+
+/* Checks whether any lane of word is zero. The lowest set bit of the
+ * result is always in the first zero lane, but lanes above it can give
+ * false positives, so the result is only used as a yes or no answer. */
+#define STRSAFE_SWAR_HAS_ZERO(type, word) \
+    ((((word) - STRSAFE_SWAR_ONES(type)) & ~(word) & \
+      (STRSAFE_SWAR_ONES(type) << (sizeof(type) * 8 - 1))) != 0)
+
+size_t strsafe_length_a_swar(
+        const char * psz,
+        size_t cchMax){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #include "strsafe_length_swar_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+size_t strsafe_length_w_swar(
+        const wchar_t * psz,
+        size_t cchMax){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #include "strsafe_length_swar_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+size_t strsafe_copy_a_swar(
+        char * pszDest,
+        const char * pszSrc,
+        size_t cchMax){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #include "strsafe_copy_swar_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+size_t strsafe_copy_w_swar(
+        wchar_t * pszDest,
+        const wchar_t * pszSrc,
+        size_t cchMax){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #include "strsafe_copy_swar_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
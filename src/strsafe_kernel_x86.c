@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Kernels for x86 processors. Every function is compiled for the
+ * instruction set it needs through a target attribute, so the rest of the
+ * library can be compiled for the baseline processor. This file is only
+ * built when HAVE_X86_SIMD_KERNELS is defined.
+ */
+
+#include "strsafe.h"
+#include "../config.h"
+#ifdef HAVE_STRING_H
+    #include <string.h>
+#endif
+#include "strsafe_kernel.h"
+
+#include <immintrin.h>
+
+#define STRSAFE_LOAD_SSE2(block) \
+    _mm_load_si128((const __m128i *)(const void *)(block))
+#define STRSAFE_LOAD_AVX2(block) \
+    _mm256_load_si256((const __m256i *)(const void *)(block))
+
+#define STRSAFE_COPY_SSE2(dest, block) \
+    _mm_storeu_si128((__m128i *)(void *)(dest), STRSAFE_LOAD_SSE2(block))
+#define STRSAFE_COPY_AVX2(dest, block) \
+    _mm256_storeu_si256((__m256i *)(void *)(dest), STRSAFE_LOAD_AVX2(block))
+
+#define STRSAFE_ZEROS_A_SSE2(block) \
+    (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8( \
+            STRSAFE_LOAD_SSE2(block), _mm_setzero_si128()))
+#define STRSAFE_ZEROS_A_AVX2(block) \
+    (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8( \
+            STRSAFE_LOAD_AVX2(block), _mm256_setzero_si256()))
+
+/* Wide characters are compared a whole lane at a time, which sets all the
+ * mask bits for the bytes of a null character. */
+#if __SIZEOF_WCHAR_T__ == 4
+    #define STRSAFE_ZEROS_W_SSE2(block) \
+        (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi32( \
+                STRSAFE_LOAD_SSE2(block), _mm_setzero_si128()))
+    #define STRSAFE_ZEROS_W_AVX2(block) \
+        (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi32( \
+                STRSAFE_LOAD_AVX2(block), _mm256_setzero_si256()))
+#else
+    #define STRSAFE_ZEROS_W_SSE2(block) \
+        (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi16( \
+                STRSAFE_LOAD_SSE2(block), _mm_setzero_si128()))
+    #define STRSAFE_ZEROS_W_AVX2(block) \
+        (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi16( \
+                STRSAFE_LOAD_AVX2(block), _mm256_setzero_si256()))
+#endif
+
+#ifdef HAVE_X86_AVX512_KERNELS
+    #define STRSAFE_LOAD_A_AVX512(mask, p) \
+        _mm512_maskz_loadu_epi8((__mmask64)(mask), (p))
+    #define STRSAFE_ZEROS_A_AVX512(mask, vector) \
+        (uint64_t)_mm512_mask_cmpeq_epi8_mask((__mmask64)(mask), \
+                (vector), _mm512_setzero_si512())
+    #define STRSAFE_STORE_A_AVX512(p, mask, vector) \
+        _mm512_mask_storeu_epi8((p), (__mmask64)(mask), (vector))
+    #if __SIZEOF_WCHAR_T__ == 4
+        #define STRSAFE_LOAD_W_AVX512(mask, p) \
+            _mm512_maskz_loadu_epi32((__mmask16)(mask), (p))
+        #define STRSAFE_ZEROS_W_AVX512(mask, vector) \
+            (uint64_t)_mm512_mask_cmpeq_epi32_mask((__mmask16)(mask), \
+                    (vector), _mm512_setzero_si512())
+        #define STRSAFE_STORE_W_AVX512(p, mask, vector) \
+            _mm512_mask_storeu_epi32((p), (__mmask16)(mask), (vector))
+    #else
+        #define STRSAFE_LOAD_W_AVX512(mask, p) \
+            _mm512_maskz_loadu_epi16((__mmask32)(mask), (p))
+        #define STRSAFE_ZEROS_W_AVX512(mask, vector) \
+            (uint64_t)_mm512_mask_cmpeq_epi16_mask((__mmask32)(mask), \
+                    (vector), _mm512_setzero_si512())
+        #define STRSAFE_STORE_W_AVX512(p, mask, vector) \
+            _mm512_mask_storeu_epi16((p), (__mmask32)(mask), (vector))
+    #endif
+#endif
+
+int strsafe_supported_sse2(void){
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+}
+
+int strsafe_supported_avx2(void){
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+#ifdef HAVE_X86_AVX512_KERNELS
+int strsafe_supported_avx512(void){
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f") &&
+            __builtin_cpu_supports("avx512bw");
+}
+#endif
+
+__attribute__((target("sse2")))
+size_t strsafe_length_a_sse2(
+        const char * psz,
+        size_t cchMax){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #define STRSAFE_SIMD_SIZE 16
+    #define STRSAFE_SIMD_ZEROS STRSAFE_ZEROS_A_SSE2
+    #include "strsafe_length_simd_generic.h"
+    #undef STRSAFE_SIMD_ZEROS
+    #undef STRSAFE_SIMD_SIZE
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+__attribute__((target("avx2")))
+size_t strsafe_length_a_avx2(
+        const char * psz,
+        size_t cchMax){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #define STRSAFE_SIMD_SIZE 32
+    #define STRSAFE_SIMD_ZEROS STRSAFE_ZEROS_A_AVX2
+    #include "strsafe_length_simd_generic.h"
+    #undef STRSAFE_SIMD_ZEROS
+    #undef STRSAFE_SIMD_SIZE
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+__attribute__((target("sse2")))
+size_t strsafe_length_w_sse2(
+        const wchar_t * psz,
+        size_t cchMax){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #define STRSAFE_SIMD_SIZE 16
+    #define STRSAFE_SIMD_ZEROS STRSAFE_ZEROS_W_SSE2
+    #include "strsafe_length_simd_generic.h"
+    #undef STRSAFE_SIMD_ZEROS
+    #undef STRSAFE_SIMD_SIZE
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+__attribute__((target("avx2")))
+size_t strsafe_length_w_avx2(
+        const wchar_t * psz,
+        size_t cchMax){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #define STRSAFE_SIMD_SIZE 32
+    #define STRSAFE_SIMD_ZEROS STRSAFE_ZEROS_W_AVX2
+    #include "strsafe_length_simd_generic.h"
+    #undef STRSAFE_SIMD_ZEROS
+    #undef STRSAFE_SIMD_SIZE
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+__attribute__((target("sse2")))
+size_t strsafe_copy_a_sse2(
+        char * pszDest,
+        const char * pszSrc,
+        size_t cchMax){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #define STRSAFE_SIMD_SIZE 16
+    #define STRSAFE_SIMD_ZEROS STRSAFE_ZEROS_A_SSE2
+    #define STRSAFE_SIMD_COPY STRSAFE_COPY_SSE2
+    #include "strsafe_copy_simd_generic.h"
+    #undef STRSAFE_SIMD_COPY
+    #undef STRSAFE_SIMD_ZEROS
+    #undef STRSAFE_SIMD_SIZE
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+__attribute__((target("sse2")))
+size_t strsafe_copy_w_sse2(
+        wchar_t * pszDest,
+        const wchar_t * pszSrc,
+        size_t cchMax){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #define STRSAFE_SIMD_SIZE 16
+    #define STRSAFE_SIMD_ZEROS STRSAFE_ZEROS_W_SSE2
+    #define STRSAFE_SIMD_COPY STRSAFE_COPY_SSE2
+    #include "strsafe_copy_simd_generic.h"
+    #undef STRSAFE_SIMD_COPY
+    #undef STRSAFE_SIMD_ZEROS
+    #undef STRSAFE_SIMD_SIZE
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+__attribute__((target("avx2")))
+size_t strsafe_copy_a_avx2(
+        char * pszDest,
+        const char * pszSrc,
+        size_t cchMax){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #define STRSAFE_SIMD_SIZE 32
+    #define STRSAFE_SIMD_ZEROS STRSAFE_ZEROS_A_AVX2
+    #define STRSAFE_SIMD_COPY STRSAFE_COPY_AVX2
+    #include "strsafe_copy_simd_generic.h"
+    #undef STRSAFE_SIMD_COPY
+    #undef STRSAFE_SIMD_ZEROS
+    #undef STRSAFE_SIMD_SIZE
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+__attribute__((target("avx2")))
+size_t strsafe_copy_w_avx2(
+        wchar_t * pszDest,
+        const wchar_t * pszSrc,
+        size_t cchMax){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #define STRSAFE_SIMD_SIZE 32
+    #define STRSAFE_SIMD_ZEROS STRSAFE_ZEROS_W_AVX2
+    #define STRSAFE_SIMD_COPY STRSAFE_COPY_AVX2
+    #include "strsafe_copy_simd_generic.h"
+    #undef STRSAFE_SIMD_COPY
+    #undef STRSAFE_SIMD_ZEROS
+    #undef STRSAFE_SIMD_SIZE
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+#ifdef HAVE_X86_AVX512_KERNELS
+__attribute__((target("avx512f,avx512bw")))
+size_t strsafe_length_a_avx512(
+        const char * psz,
+        size_t cchMax){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #define STRSAFE_AVX512_LOAD STRSAFE_LOAD_A_AVX512
+    #define STRSAFE_AVX512_ZEROS STRSAFE_ZEROS_A_AVX512
+    #include "strsafe_avx512_generic.h"
+    #undef STRSAFE_AVX512_ZEROS
+    #undef STRSAFE_AVX512_LOAD
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+__attribute__((target("avx512f,avx512bw")))
+size_t strsafe_length_w_avx512(
+        const wchar_t * psz,
+        size_t cchMax){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #define STRSAFE_AVX512_LOAD STRSAFE_LOAD_W_AVX512
+    #define STRSAFE_AVX512_ZEROS STRSAFE_ZEROS_W_AVX512
+    #include "strsafe_avx512_generic.h"
+    #undef STRSAFE_AVX512_ZEROS
+    #undef STRSAFE_AVX512_LOAD
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+__attribute__((target("avx512f,avx512bw")))
+size_t strsafe_copy_a_avx512(
+        char * pszDest,
+        const char * pszSrc,
+        size_t cchMax){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #define STRSAFE_AVX512_LOAD STRSAFE_LOAD_A_AVX512
+    #define STRSAFE_AVX512_ZEROS STRSAFE_ZEROS_A_AVX512
+    #define STRSAFE_AVX512_STORE STRSAFE_STORE_A_AVX512
+    #include "strsafe_avx512_generic.h"
+    #undef STRSAFE_AVX512_STORE
+    #undef STRSAFE_AVX512_ZEROS
+    #undef STRSAFE_AVX512_LOAD
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+__attribute__((target("avx512f,avx512bw")))
+size_t strsafe_copy_w_avx512(
+        wchar_t * pszDest,
+        const wchar_t * pszSrc,
+        size_t cchMax){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #define STRSAFE_AVX512_LOAD STRSAFE_LOAD_W_AVX512
+    #define STRSAFE_AVX512_ZEROS STRSAFE_ZEROS_W_AVX512
+    #define STRSAFE_AVX512_STORE STRSAFE_STORE_W_AVX512
+    #include "strsafe_avx512_generic.h"
+    #undef STRSAFE_AVX512_STORE
+    #undef STRSAFE_AVX512_ZEROS
+    #undef STRSAFE_AVX512_LOAD
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+#endif /* HAVE_X86_AVX512_KERNELS */
+
+__attribute__((target("sse2")))
+void strsafe_fill_stream_sse2(
+        void * pv,
+        int c,
+        size_t cb){
+    unsigned char * pb = pv;
+    const __m128i vector = _mm_set1_epi8((char)c);
+    /* Non-temporal stores have to be aligned. */
+    size_t cbHead = (size_t)(-(uintptr_t)pb & 15);
+
+    if(cbHead > cb){
+        cbHead = cb;
+    }
+    memset(pb, c, cbHead);
+    pb += cbHead;
+    cb -= cbHead;
+
+    while(cb >= 64){
+        _mm_stream_si128((__m128i *)(void *)pb, vector);
+        _mm_stream_si128((__m128i *)(void *)(pb + 16), vector);
+        _mm_stream_si128((__m128i *)(void *)(pb + 32), vector);
+        _mm_stream_si128((__m128i *)(void *)(pb + 48), vector);
+        pb += 64;
+        cb -= 64;
+    }
+    while(cb >= 16){
+        _mm_stream_si128((__m128i *)(void *)pb, vector);
+        pb += 16;
+        cb -= 16;
+    }
+    /* Make the stores visible to other threads in order with the ones
+     * that follow. */
+    _mm_sfence();
+    memset(pb, c, cb);
+}
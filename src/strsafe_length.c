@@ -16,8 +16,9 @@
 #ifdef HAVE_WCHAR_H
     #include <wchar.h>
 #endif
+#include "strsafe_kernel.h"
 
-HRESULT StringCchLengthA(
+HRESULT strsafe_length_cch_a(
         LPCSTR psz,
         size_t cchMax,
         size_t *pcch){
@@ -28,7 +29,7 @@ HRESULT StringCchLengthA(
     #undef STRSAFE_GENERIC_WIDE_CHAR
 }
 
-HRESULT StringCchLengthW(
+HRESULT strsafe_length_cch_w(
         LPCWSTR psz,
         size_t cchMax,
         size_t *pcch){
@@ -39,19 +40,34 @@ HRESULT StringCchLengthW(
     #undef STRSAFE_GENERIC_WIDE_CHAR
 }
 
+HRESULT StringCchLengthA(
+        LPCSTR psz,
+        size_t cchMax,
+        size_t *pcch){
+    return strsafe_length_cch_a(psz, cchMax, pcch);
+}
+
+HRESULT StringCchLengthW(
+        LPCWSTR psz,
+        size_t cchMax,
+        size_t *pcch){
+    return strsafe_length_cch_w(psz, cchMax, pcch);
+}
+
 HRESULT StringCbLengthA(
         LPCSTR psz,
         size_t cbMax,
         size_t *pcb){
-    return StringCchLengthA(psz, cbMax, pcb);
+    return strsafe_length_cch_a(psz, cbMax, pcb);
 }
 
 HRESULT StringCbLengthW(
         LPCWSTR psz,
         size_t cbMax,
         size_t *pcb){
-    size_t pcch;
-    HRESULT result = StringCchLengthW(psz, cbMax / sizeof(wchar_t), &pcch);
+    size_t pcch = 0;
+    HRESULT result = strsafe_length_cch_w(psz, cbMax / sizeof(wchar_t),
+            &pcch);
     *pcb = pcch * sizeof(wchar_t);
     return result;
 }
@@ -8,9 +8,9 @@
 #ifndef STRSAFE_GENERIC_WIDE_CHAR
 #error "STRSAFE_GENERIC_WIDE_CHAR must be defined."
 #elif STRSAFE_GENERIC_WIDE_CHAR == 0
-#define STRSAFE_TEXT(c) c
+#define STRSAFE_LENGTH_KERNEL strsafe_length_a
 #else
-#define STRSAFE_TEXT(c) L##c
+#define STRSAFE_LENGTH_KERNEL strsafe_length_w
 #endif
 
 if(psz == NULL || cchMax > STRSAFE_MAX_CCH){
@@ -18,18 +18,13 @@ if(psz == NULL || cchMax > STRSAFE_MAX_CCH){
     return STRSAFE_E_INVALID_PARAMETER;
 }
 
-/* This might be a good target for optimization. */
-for(*pcch = 0; *pcch < cchMax; ){
-    if(psz[*pcch] == STRSAFE_TEXT('\0')){
-        break;
-    }
-    (*pcch)++;
-}
+/* The kernel was selected for the current processor in strsafe_kernel.c. */
+*pcch = STRSAFE_LENGTH_KERNEL(psz, cchMax);
 
-/* If *pcch was incremented to cchMax, the first cchMax characters
- * did not contain a null termination. */
+/* If *pcch is cchMax, the first cchMax characters did not contain
+ * a null termination. */
 if(*pcch == cchMax) return STRSAFE_E_INVALID_PARAMETER;
 
 return S_OK;
 
-#undef STRSAFE_TEXT
+#undef STRSAFE_LENGTH_KERNEL
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Internal header for generic implementation of the vectorized length
+ * kernels. Besides STRSAFE_GENERIC_WIDE_CHAR, the including function must
+ * define STRSAFE_SIMD_SIZE, the size of a vector in bytes, and
+ * STRSAFE_SIMD_ZEROS(block), which returns a bit mask with one bit set for
+ * each byte of the aligned vector at block that is part of a null
+ * character.
+ */
+
+#ifndef STRSAFE_GENERIC_WIDE_CHAR
+#error "STRSAFE_GENERIC_WIDE_CHAR must be defined."
+#elif STRSAFE_GENERIC_WIDE_CHAR == 0
+#define STRSAFE_CHAR char
+#define STRSAFE_LENGTH_SCALAR strsafe_length_a_scalar
+#else
+#define STRSAFE_CHAR wchar_t
+#define STRSAFE_LENGTH_SCALAR strsafe_length_w_scalar
+#endif
+
+const char * block;
+size_t offset;
+size_t length = 0;
+unsigned int mask;
+
+if(cchMax == 0){
+    return 0;
+}
+if((uintptr_t)psz % sizeof(STRSAFE_CHAR) != 0){
+    /* The lanes of the vectors would not line up with the characters. */
+    return STRSAFE_LENGTH_SCALAR(psz, cchMax);
+}
+
+/* An aligned vector never crosses a page boundary, so reading the whole
+ * vector holding psz[0] is safe even if the string ends before the end
+ * of it. Bits for the bytes in front of psz are shifted out of the mask. */
+offset = (size_t)((uintptr_t)psz & (STRSAFE_SIMD_SIZE - 1));
+block = (const char *)psz - offset;
+mask = STRSAFE_SIMD_ZEROS(block) >> offset;
+
+for(;;){
+    if(mask != 0){
+        length += (size_t)__builtin_ctz(mask) / sizeof(STRSAFE_CHAR);
+        return length < cchMax ? length : cchMax;
+    }
+    length += (STRSAFE_SIMD_SIZE - offset) / sizeof(STRSAFE_CHAR);
+    if(length >= cchMax){
+        /* The next vector starts at or beyond psz[cchMax]. */
+        return cchMax;
+    }
+    block += STRSAFE_SIMD_SIZE;
+    offset = 0;
+    mask = STRSAFE_SIMD_ZEROS(block);
+}
+
+#undef STRSAFE_CHAR
+#undef STRSAFE_LENGTH_SCALAR
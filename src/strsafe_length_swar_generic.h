@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Internal header for generic implementation of the word-at-a-time
+ * length kernels.
+ */
+
+#ifndef STRSAFE_GENERIC_WIDE_CHAR
+#error "STRSAFE_GENERIC_WIDE_CHAR must be defined."
+#elif STRSAFE_GENERIC_WIDE_CHAR == 0
+#define STRSAFE_CHAR char
+#define STRSAFE_TEXT(c) c
+#define STRSAFE_LENGTH_SCALAR strsafe_length_a_scalar
+#else
+#define STRSAFE_CHAR wchar_t
+#define STRSAFE_TEXT(c) L##c
+#define STRSAFE_LENGTH_SCALAR strsafe_length_w_scalar
+#endif
+
+size_t length = 0;
+uint64_t word;
+
+if((uintptr_t)psz % sizeof(STRSAFE_CHAR) != 0){
+    /* The lanes of the words would not line up with the characters. */
+    return STRSAFE_LENGTH_SCALAR(psz, cchMax);
+}
+
+/* Check one character at a time until psz + length is aligned. */
+while((uintptr_t)(psz + length) % sizeof(uint64_t) != 0){
+    if(length == cchMax || psz[length] == STRSAFE_TEXT('\0')){
+        return length;
+    }
+    length++;
+}
+
+/* An aligned word never crosses a page boundary, so the last word may be
+ * read even if it extends beyond psz[cchMax - 1]. */
+while(length < cchMax){
+    memcpy(&word, psz + length, sizeof(word));
+    if(STRSAFE_SWAR_HAS_ZERO(STRSAFE_CHAR, word)){
+        break;
+    }
+    length += sizeof(word) / sizeof(STRSAFE_CHAR);
+}
+
+/* Find the null termination within the last word. */
+while(length < cchMax && psz[length] != STRSAFE_TEXT('\0')){
+    length++;
+}
+
+return length < cchMax ? length : cchMax;
+
+#undef STRSAFE_CHAR
+#undef STRSAFE_TEXT
+#undef STRSAFE_LENGTH_SCALAR
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+#include "strsafe.h"
+#include "../config.h"
+#ifdef HAVE_STRING_H
+    #include <string.h>
+#endif
+#ifdef HAVE_WCHAR_H
+    #include <wchar.h>
+#endif
+#include "strsafe_internal.h"
+
+static HRESULT strsafe_path_combine_a(
+        LPSTR pszDest,
+        size_t cchDest,
+        LPCSTR pszDir,
+        LPCSTR pszFile,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #include "strsafe_path_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+static HRESULT strsafe_path_combine_w(
+        LPWSTR pszDest,
+        size_t cchDest,
+        LPCWSTR pszDir,
+        LPCWSTR pszFile,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #include "strsafe_path_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT StringCchPathCombineA(
+        LPSTR pszDest,
+        size_t cchDest,
+        LPCSTR pszDir,
+        LPCSTR pszFile){
+    return strsafe_path_combine_a(pszDest, cchDest, pszDir, pszFile, NULL,
+            NULL, 0);
+}
+
+HRESULT StringCchPathCombineW(
+        LPWSTR pszDest,
+        size_t cchDest,
+        LPCWSTR pszDir,
+        LPCWSTR pszFile){
+    return strsafe_path_combine_w(pszDest, cchDest, pszDir, pszFile, NULL,
+            NULL, 0);
+}
+
+HRESULT StringCchPathCombineExA(
+        LPSTR pszDest,
+        size_t cchDest,
+        LPCSTR pszDir,
+        LPCSTR pszFile,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    return strsafe_path_combine_a(pszDest, cchDest, pszDir, pszFile,
+            ppszDestEnd, pcchRemaining, dwFlags);
+}
+
+HRESULT StringCchPathCombineExW(
+        LPWSTR pszDest,
+        size_t cchDest,
+        LPCWSTR pszDir,
+        LPCWSTR pszFile,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    return strsafe_path_combine_w(pszDest, cchDest, pszDir, pszFile,
+            ppszDestEnd, pcchRemaining, dwFlags);
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * Internal header for generic implementation of libstrsafe functions.
+ * The paths are read one component at a time and each component is
+ * written to pszDest as soon as it has been read, so pszDest always holds
+ * the normalized path so far. A ".." component takes back the component
+ * written last, which is found by looking back in pszDest.
+ */
+
+#ifndef STRSAFE_GENERIC_WIDE_CHAR
+#error "STRSAFE_GENERIC_WIDE_CHAR must be defined."
+#elif STRSAFE_GENERIC_WIDE_CHAR == 0
+#define STRSAFE_CHAR char
+#define STRSAFE_TEXT(c) c
+#else
+#define STRSAFE_CHAR wchar_t
+#define STRSAFE_TEXT(c) L##c
+#endif
+
+const STRSAFE_CHAR * paths[2];
+size_t cPaths = 0;
+/* The part of pszDest that is never taken back. This is the root of an
+ * absolute path and any leading ".." components of a relative path. */
+size_t fixedLength = 0;
+size_t length = 0;
+size_t i;
+int absolute;
+HRESULT result = S_OK;
+
+if(pszDest == NULL || cchDest == 0 || cchDest > STRSAFE_MAX_CCH){
+    /* Invalid value for pszDest or cchDest. */
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+if((pszDir == NULL || pszFile == NULL) &&
+        !(dwFlags & STRSAFE_IGNORE_NULLS)){
+    return STRSAFE_E_INVALID_PARAMETER;
+}
+
+/* An absolute pszFile replaces pszDir. */
+if(pszFile != NULL && pszFile[0] == STRSAFE_TEXT('/')){
+    paths[cPaths++] = pszFile;
+} else {
+    if(pszDir != NULL){
+        paths[cPaths++] = pszDir;
+    }
+    if(pszFile != NULL){
+        paths[cPaths++] = pszFile;
+    }
+}
+absolute = cPaths > 0 && paths[0][0] == STRSAFE_TEXT('/');
+
+if(absolute){
+    if(cchDest < 2){
+        result = STRSAFE_E_INSUFFICIENT_BUFFER;
+    } else {
+        pszDest[0] = STRSAFE_TEXT('/');
+        length = fixedLength = 1;
+    }
+}
+
+for(i = 0; i < cPaths && SUCCEEDED(result); i++){
+    const STRSAFE_CHAR * pch = paths[i];
+
+    for(;;){
+        const STRSAFE_CHAR * pchEnd;
+        size_t cchComponent;
+        size_t cchSeparator;
+        int parent;
+
+        while(*pch == STRSAFE_TEXT('/')){
+            pch++;
+        }
+        if(*pch == STRSAFE_TEXT('\0')){
+            break;
+        }
+        for(pchEnd = pch + 1; *pchEnd != STRSAFE_TEXT('\0') &&
+                *pchEnd != STRSAFE_TEXT('/'); pchEnd++){
+        }
+        cchComponent = (size_t)(pchEnd - pch);
+
+        if(cchComponent == 1 && pch[0] == STRSAFE_TEXT('.')){
+            /* "." names the directory it is in. */
+            pch = pchEnd;
+            continue;
+        }
+        parent = cchComponent == 2 && pch[0] == STRSAFE_TEXT('.') &&
+                pch[1] == STRSAFE_TEXT('.');
+        if(parent && length > fixedLength){
+            /* Take back the last component along with the separator in
+             * front of it. */
+            while(length > fixedLength &&
+                    pszDest[length - 1] != STRSAFE_TEXT('/')){
+                length--;
+            }
+            if(length > fixedLength){
+                length--;
+            }
+            pch = pchEnd;
+            continue;
+        }
+        if(parent && absolute){
+            /* The parent of the root is the root. */
+            pch = pchEnd;
+            continue;
+        }
+
+        cchSeparator = length > 0 && pszDest[length - 1] !=
+                STRSAFE_TEXT('/') ? 1 : 0;
+        if(cchSeparator + cchComponent > cchDest - 1 - length){
+            /* The path does not fit, copy as much as does. */
+            if(cchSeparator == 1 && length < cchDest - 1){
+                pszDest[length++] = STRSAFE_TEXT('/');
+            }
+            memcpy(pszDest + length, pch,
+                    (cchDest - 1 - length) * sizeof(STRSAFE_CHAR));
+            length = cchDest - 1;
+            result = STRSAFE_E_INSUFFICIENT_BUFFER;
+            break;
+        }
+        if(cchSeparator == 1){
+            pszDest[length++] = STRSAFE_TEXT('/');
+        }
+        memcpy(pszDest + length, pch, cchComponent * sizeof(STRSAFE_CHAR));
+        length += cchComponent;
+        if(parent){
+            /* There is nothing to take back, so the ".." stays. */
+            fixedLength = length;
+        }
+        pch = pchEnd;
+    }
+}
+
+if(SUCCEEDED(result) && length == 0){
+    /* The path names the current directory. */
+    if(cchDest < 2){
+        result = STRSAFE_E_INSUFFICIENT_BUFFER;
+    } else {
+        pszDest[length++] = STRSAFE_TEXT('.');
+    }
+}
+
+if(FAILED(result)){
+    if(dwFlags & (STRSAFE_NO_TRUNCATION | STRSAFE_NULL_ON_FAILURE)){
+        /* pszDest should be set to the empty string. */
+        *pszDest = STRSAFE_TEXT('\0');
+        return result;
+    }
+    if(dwFlags & STRSAFE_FILL_ON_FAILURE){
+        /* pszDest should be filled with the lower byte of dwFlags
+         * and null terminated. */
+        strsafe_fill(pszDest, dwFlags & 0xff,
+                (cchDest - 1) * sizeof(STRSAFE_CHAR));
+        pszDest[cchDest - 1] = STRSAFE_TEXT('\0');
+        return result;
+    }
+}
+
+pszDest[length] = STRSAFE_TEXT('\0');
+if(ppszDestEnd != NULL){
+    *ppszDestEnd = pszDest + length;
+}
+if(pcchRemaining != NULL){
+    *pcchRemaining = cchDest - length;
+}
+if((dwFlags & STRSAFE_FILL_BEHIND_NULL) && length + 1 < cchDest){
+    strsafe_fill(pszDest + length + 1, dwFlags & 0xff,
+            (cchDest - length - 1) * sizeof(STRSAFE_CHAR));
+}
+
+return result;
+
+#undef STRSAFE_CHAR
+#undef STRSAFE_TEXT
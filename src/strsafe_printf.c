@@ -16,6 +16,7 @@
 #ifdef HAVE_WCHAR_H
     #include <wchar.h>
 #endif
+#include "strsafe_internal.h"
 
 HRESULT StringCchPrintfA(
         LPSTR pszDest,
@@ -26,7 +27,8 @@ HRESULT StringCchPrintfA(
     HRESULT result;
     
     va_start(argList, pszFormat);
-    result = StringCchVPrintfA(pszDest, cchDest, pszFormat, argList);
+    result = strsafe_vprintf_a_no_flags(pszDest, cchDest, NULL, NULL,
+            pszFormat, argList);
     va_end(argList);
 
     return result;
@@ -41,7 +43,8 @@ HRESULT StringCchPrintfW(
     HRESULT result;
 
     va_start(argList, pszFormat);
-    result = StringCchVPrintfW(pszDest, cchDest, pszFormat, argList);
+    result = strsafe_vprintf_w_no_flags(pszDest, cchDest, NULL, NULL,
+            pszFormat, argList);
     va_end(argList);
 
     return result;
@@ -59,7 +62,7 @@ HRESULT StringCchPrintfExA(
     HRESULT result;
 
     va_start(argList, pszFormat);
-    result = StringCchVPrintfExA(pszDest, cchDest, ppszDestEnd,
+    result = strsafe_vprintf_a(pszDest, cchDest, ppszDestEnd,
             pcchRemaining, dwFlags, pszFormat, argList);
     va_end(argList);
 
@@ -79,7 +82,7 @@ HRESULT StringCchPrintfExW(
     HRESULT result;
 
     va_start(argList, pszFormat);
-    result = StringCchVPrintfExW(pszDest, cchDest, ppszDestEnd,
+    result = strsafe_vprintf_w(pszDest, cchDest, ppszDestEnd,
             pcchRemaining, dwFlags, pszFormat, argList);
     va_end(argList);
 
@@ -95,7 +98,8 @@ HRESULT StringCbPrintfA(
     HRESULT result;
     
     va_start(argList, pszFormat);
-    result = StringCbVPrintfA(pszDest, cbDest, pszFormat, argList);
+    result = strsafe_vprintf_a_no_flags(pszDest, cbDest, NULL, NULL,
+            pszFormat, argList);
     va_end(argList);
 
     return result;
@@ -110,7 +114,8 @@ HRESULT StringCbPrintfW(
     HRESULT result;
 
     va_start(argList, pszFormat);
-    result = StringCbVPrintfW(pszDest, cbDest, pszFormat, argList);
+    result = strsafe_vprintf_w_no_flags(pszDest, cbDest / sizeof(wchar_t),
+            NULL, NULL, pszFormat, argList);
     va_end(argList);
 
     return result;
@@ -128,7 +133,7 @@ HRESULT StringCbPrintfExA(
     HRESULT result;
 
     va_start(argList, pszFormat);
-    result = StringCbVPrintfExA(pszDest, cbDest, ppszDestEnd,
+    result = strsafe_vprintf_a(pszDest, cbDest, ppszDestEnd,
             pcbRemaining, dwFlags, pszFormat, argList);
     va_end(argList);
 
@@ -147,9 +152,12 @@ HRESULT StringCbPrintfExW(
     HRESULT result;
 
     va_start(argList, pszFormat);
-    result = StringCbVPrintfExW(pszDest, cbDest, ppszDestEnd,
-            pcbRemaining, dwFlags, pszFormat, argList);
+    result = strsafe_vprintf_w(pszDest, cbDest / sizeof(wchar_t),
+            ppszDestEnd, pcbRemaining, dwFlags, pszFormat, argList);
     va_end(argList);
+    if(pcbRemaining != NULL){
+        *pcbRemaining *= sizeof(wchar_t);
+    }
 
     return result;
 }
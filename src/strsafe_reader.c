@@ -0,0 +1,361 @@
+/*
+ * Copyright (c) 2010, Jonas Sundberg <jsund@jsund.com>
+ *
+ * This software has been released under the terms of the ISC license. For
+ * details, see the LICENSE file.
+ */
+
+/*
+ * A line reader that works on a file descriptor. Data is read into the
+ * buffer of the reader in large blocks, the line breaks are found with
+ * memchr, which the C library implements with vector instructions, and
+ * each span of a line is copied to pszDest once. StringCchPeekLineA does
+ * not copy the line at all, it returns where the line is in the buffer.
+ * A reader created by StrSafeReaderCreateMapped for a regular file maps
+ * the file instead, and the mapping then takes the place of the buffer.
+ */
+
+#include "strsafe.h"
+#include "../config.h"
+#ifdef HAVE_ERRNO_H
+    #include <errno.h>
+#endif
+#ifdef HAVE_STDINT_H
+    #include <stdint.h>
+#endif
+#ifdef HAVE_STRING_H
+    #include <string.h>
+#endif
+#ifdef HAVE_SYS_STAT_H
+    #include <sys/stat.h>
+#endif
+#ifdef HAVE_UNISTD_H
+    #include <unistd.h>
+#endif
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_MMAP)
+    #include <sys/mman.h>
+    #define STRSAFE_READER_MAP 1
+#endif
+#include "strsafe_kernel.h"
+
+/* The size of the buffer when the caller does not pick one, in bytes. */
+#define STRSAFE_READER_DEFAULT_BUFFER 65536
+
+struct STRSAFE_READER {
+    /**
+     * The file descriptor to read from.
+     */
+    int fd;
+
+    /**
+     * The buffer and its size in bytes. The buffer follows right after the
+     * reader.
+     */
+    char * pBuffer;
+    size_t cbBuffer;
+
+    /**
+     * The data in the buffer that has not been returned yet.
+     */
+    char * pNext;
+    char * pEnd;
+
+    /**
+     * The mapping of the file and its size in bytes, or NULL if the file
+     * is read into the buffer.
+     */
+    void * pvMapping;
+    size_t cbMapping;
+};
+
+/**
+ * Reads the next block into the buffer of a reader. The data that has not
+ * been returned yet is first moved to the start of the buffer, so a line
+ * that is split between two blocks ends up in one piece. Interrupted reads
+ * are restarted.
+ *
+ * @param pReader The reader, whose buffer must not be full.
+ *
+ * @return Non-zero if data was read, or zero at the end of the file or on
+ *         an error.
+ */
+static int strsafe_reader_fill(
+        STRSAFE_READER * pReader){
+    size_t cbUnread = (size_t)(pReader->pEnd - pReader->pNext);
+    ssize_t count;
+
+    if(pReader->pvMapping != NULL){
+        /* The whole file is already there. */
+        return 0;
+    }
+    if(pReader->pNext != pReader->pBuffer){
+        memmove(pReader->pBuffer, pReader->pNext, cbUnread);
+        pReader->pNext = pReader->pBuffer;
+        pReader->pEnd = pReader->pBuffer + cbUnread;
+    }
+
+    do {
+        count = read(pReader->fd, pReader->pEnd,
+                pReader->cbBuffer - cbUnread);
+    } while(count < 0 && errno == EINTR);
+
+    if(count <= 0){
+        return 0;
+    }
+    pReader->pEnd += count;
+    return 1;
+}
+
+/**
+ * Allocates a reader along with its buffer.
+ *
+ * @param ppReader Receives the reader.
+ * @param fd The file descriptor to read from.
+ * @param cbBuffer The size of the buffer in bytes, which may be 0.
+ *
+ * @return S_OK or STRSAFE_E_OUT_OF_MEMORY.
+ */
+static HRESULT strsafe_reader_create(
+        STRSAFE_READER ** ppReader,
+        int fd,
+        size_t cbBuffer){
+    STRSAFE_READER * pReader;
+
+    if(cbBuffer > SIZE_MAX - sizeof(STRSAFE_READER)){
+        return STRSAFE_E_OUT_OF_MEMORY;
+    }
+
+    pReader = strsafe_realloc(NULL, sizeof(STRSAFE_READER) + cbBuffer);
+    if(pReader == NULL){
+        return STRSAFE_E_OUT_OF_MEMORY;
+    }
+    pReader->fd = fd;
+    pReader->pBuffer = (char *)(pReader + 1);
+    pReader->cbBuffer = cbBuffer;
+    pReader->pNext = pReader->pBuffer;
+    pReader->pEnd = pReader->pBuffer;
+    pReader->pvMapping = NULL;
+    pReader->cbMapping = 0;
+
+    *ppReader = pReader;
+    return S_OK;
+}
+
+HRESULT StrSafeReaderCreate(
+        STRSAFE_READER ** ppReader,
+        int fd,
+        size_t cbBuffer){
+    if(ppReader == NULL || fd < 0){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+    if(cbBuffer == 0){
+        cbBuffer = STRSAFE_READER_DEFAULT_BUFFER;
+    }
+
+    return strsafe_reader_create(ppReader, fd, cbBuffer);
+}
+
+HRESULT StrSafeReaderCreateMapped(
+        STRSAFE_READER ** ppReader,
+        int fd,
+        size_t cbBuffer){
+#ifdef STRSAFE_READER_MAP
+    struct stat status;
+    off_t offset;
+    off_t start;
+    long cbPage;
+    void * pvMapping;
+    HRESULT result;
+#endif
+
+    if(ppReader == NULL || fd < 0){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+    if(cbBuffer == 0){
+        cbBuffer = STRSAFE_READER_DEFAULT_BUFFER;
+    }
+
+#ifdef STRSAFE_READER_MAP
+    /* Only the rest of a regular file that is not empty can be mapped,
+     * anything else is read into a buffer. */
+    offset = lseek(fd, 0, SEEK_CUR);
+    cbPage = sysconf(_SC_PAGESIZE);
+    if(offset < 0 || cbPage <= 0 || fstat(fd, &status) != 0 ||
+            !S_ISREG(status.st_mode) || status.st_size <= offset ||
+            (unsigned long long)status.st_size > SIZE_MAX){
+        return strsafe_reader_create(ppReader, fd, cbBuffer);
+    }
+
+    /* The mapping has to start at a page boundary. */
+    start = offset - offset % cbPage;
+    pvMapping = mmap(NULL, (size_t)(status.st_size - start), PROT_READ,
+            MAP_PRIVATE, fd, start);
+    if(pvMapping == MAP_FAILED){
+        return strsafe_reader_create(ppReader, fd, cbBuffer);
+    }
+#ifdef HAVE_MADVISE
+    /* The file is read once from start to end. */
+    madvise(pvMapping, (size_t)(status.st_size - start), MADV_SEQUENTIAL);
+#endif
+
+    result = strsafe_reader_create(ppReader, fd, 0);
+    if(FAILED(result)){
+        munmap(pvMapping, (size_t)(status.st_size - start));
+        return result;
+    }
+    (*ppReader)->pvMapping = pvMapping;
+    (*ppReader)->cbMapping = (size_t)(status.st_size - start);
+    (*ppReader)->pNext = (char *)pvMapping + (offset - start);
+    (*ppReader)->pEnd = (char *)pvMapping + (*ppReader)->cbMapping;
+    return S_OK;
+#else
+    return strsafe_reader_create(ppReader, fd, cbBuffer);
+#endif
+}
+
+void StrSafeReaderDestroy(
+        STRSAFE_READER * pReader){
+#ifdef STRSAFE_READER_MAP
+    if(pReader != NULL && pReader->pvMapping != NULL){
+        munmap(pReader->pvMapping, pReader->cbMapping);
+    }
+#endif
+    strsafe_free(pReader);
+}
+
+HRESULT StringCchReadLineExA(
+        STRSAFE_READER * pReader,
+        LPSTR pszDest,
+        size_t cchDest,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags){
+    size_t length = 0;
+    HRESULT result = S_OK;
+
+    if(pReader == NULL){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+    if(cchDest < 2){
+        if(cchDest == 1){
+            *pszDest = '\0';
+        }
+        return STRSAFE_E_INSUFFICIENT_BUFFER;
+    }
+    if(cchDest > STRSAFE_MAX_CCH){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+
+    /* If loop condition fails, the buffer was too small. */
+    while(length < cchDest - 1){
+        size_t cchSpan;
+        const char * pchNewline;
+
+        if(pReader->pNext == pReader->pEnd &&
+                !strsafe_reader_fill(pReader)){
+            if(length == 0){
+                result = STRSAFE_E_END_OF_FILE;
+            }
+            break;
+        }
+
+        /* Copy the data in the buffer up to the line break or as much as
+         * fits. */
+        cchSpan = (size_t)(pReader->pEnd - pReader->pNext);
+        if(cchSpan > cchDest - 1 - length){
+            cchSpan = cchDest - 1 - length;
+        }
+        pchNewline = memchr(pReader->pNext, '\n', cchSpan);
+        if(pchNewline != NULL){
+            cchSpan = (size_t)(pchNewline - pReader->pNext);
+        }
+        memcpy(pszDest + length, pReader->pNext, cchSpan);
+        length += cchSpan;
+        pReader->pNext += cchSpan;
+        if(pchNewline != NULL){
+            /* The line break is read but not stored. */
+            pReader->pNext++;
+            break;
+        }
+    }
+
+    if((dwFlags & STRSAFE_FILL_ON_FAILURE) && FAILED(result)){
+        /* Fill entire buffer with lower byte of dwFlags and null
+         * terminate. */
+        strsafe_fill(pszDest, dwFlags & 0xff, cchDest - 1);
+        length = cchDest - 1;
+    } else if((dwFlags & (STRSAFE_NULL_ON_FAILURE | STRSAFE_NO_TRUNCATION))
+            && FAILED(result)){
+        /* Set the result to the empty string. */
+        length = 0;
+    }
+
+    pszDest[length] = '\0';
+    if(ppszDestEnd != NULL){
+        *ppszDestEnd = pszDest + length;
+    }
+    if(pcchRemaining != NULL){
+        *pcchRemaining = cchDest - length;
+    }
+    if(dwFlags & STRSAFE_FILL_BEHIND_NULL){
+        strsafe_fill(pszDest + length + 1, dwFlags & 0xff,
+                cchDest - length - 1);
+    }
+
+    return result;
+}
+
+HRESULT StringCchPeekLineA(
+        STRSAFE_READER * pReader,
+        size_t cchMax,
+        STRSAFE_SEGMENT_A * pLine){
+    size_t cchLimit;
+    size_t cchSearched = 0;
+
+    if(pReader == NULL || pLine == NULL || cchMax > STRSAFE_MAX_CCH){
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+    /* The line break has to fit in the buffer along with the line. A
+     * mapped file does not limit the length of the line. */
+    cchLimit = pReader->pvMapping != NULL ||
+            cchMax < pReader->cbBuffer - 1 ? cchMax : pReader->cbBuffer - 1;
+    if(cchLimit == 0){
+        /* No line but an empty one could ever be returned whole. */
+        return STRSAFE_E_INVALID_PARAMETER;
+    }
+
+    for(;;){
+        size_t cchUnread = (size_t)(pReader->pEnd - pReader->pNext);
+        size_t cchSearch = cchUnread < cchLimit + 1 ? cchUnread :
+                cchLimit + 1;
+        const char * pchNewline;
+
+        /* Only the data that came in with the last block has not been
+         * searched yet. */
+        pchNewline = memchr(pReader->pNext + cchSearched, '\n',
+                cchSearch - cchSearched);
+        pLine->pch = pReader->pNext;
+        if(pchNewline != NULL){
+            /* The line break is read but is not part of the line. */
+            pLine->cch = (size_t)(pchNewline - pReader->pNext);
+            pReader->pNext += pLine->cch + 1;
+            return S_OK;
+        }
+        if(cchSearch > cchLimit){
+            /* The line is too long, return the part that fits and leave
+             * the rest for the next call. */
+            pLine->cch = cchLimit;
+            pReader->pNext += cchLimit;
+            return STRSAFE_E_INSUFFICIENT_BUFFER;
+        }
+
+        cchSearched = cchUnread;
+        if(!strsafe_reader_fill(pReader)){
+            /* The last line does not need a line break. */
+            pLine->pch = pReader->pNext;
+            pLine->cch = cchUnread;
+            pReader->pNext = pReader->pEnd;
+            return cchUnread > 0 ? S_OK : STRSAFE_E_END_OF_FILE;
+        }
+    }
+}
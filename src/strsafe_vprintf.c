@@ -19,13 +19,103 @@
 #ifdef HAVE_WCHAR_H
     #include <wchar.h>
 #endif
+#include "strsafe_internal.h"
+
+/* The generic implementation is compiled separately for dwFlags set to
+ * 0, which is what the functions without Ex pass. */
+
+HRESULT strsafe_vprintf_a_no_flags(
+        LPSTR pszDest,
+        size_t cchDest,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        LPCSTR pszFormat,
+        va_list argList){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #define STRSAFE_GENERIC_FLAGS 0
+    #include "strsafe_vprintf_generic.h"
+    #undef STRSAFE_GENERIC_FLAGS
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+static HRESULT strsafe_vprintf_a_any(
+        LPSTR pszDest,
+        size_t cchDest,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags,
+        LPCSTR pszFormat,
+        va_list argList){
+    #define STRSAFE_GENERIC_WIDE_CHAR 0
+    #include "strsafe_vprintf_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT strsafe_vprintf_w_no_flags(
+        LPWSTR pszDest,
+        size_t cchDest,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        LPCWSTR pszFormat,
+        va_list argList){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #define STRSAFE_GENERIC_FLAGS 0
+    #include "strsafe_vprintf_generic.h"
+    #undef STRSAFE_GENERIC_FLAGS
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+static HRESULT strsafe_vprintf_w_any(
+        LPWSTR pszDest,
+        size_t cchDest,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags,
+        LPCWSTR pszFormat,
+        va_list argList){
+    #define STRSAFE_GENERIC_WIDE_CHAR 1
+    #include "strsafe_vprintf_generic.h"
+    #undef STRSAFE_GENERIC_WIDE_CHAR
+}
+
+HRESULT strsafe_vprintf_a(
+        LPSTR pszDest,
+        size_t cchDest,
+        LPSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags,
+        LPCSTR pszFormat,
+        va_list argList){
+    if(dwFlags == 0){
+        return strsafe_vprintf_a_no_flags(pszDest, cchDest, ppszDestEnd,
+                pcchRemaining, pszFormat, argList);
+    }
+    return strsafe_vprintf_a_any(pszDest, cchDest, ppszDestEnd,
+            pcchRemaining, dwFlags, pszFormat, argList);
+}
+
+HRESULT strsafe_vprintf_w(
+        LPWSTR pszDest,
+        size_t cchDest,
+        LPWSTR * ppszDestEnd,
+        size_t * pcchRemaining,
+        DWORD dwFlags,
+        LPCWSTR pszFormat,
+        va_list argList){
+    if(dwFlags == 0){
+        return strsafe_vprintf_w_no_flags(pszDest, cchDest, ppszDestEnd,
+                pcchRemaining, pszFormat, argList);
+    }
+    return strsafe_vprintf_w_any(pszDest, cchDest, ppszDestEnd,
+            pcchRemaining, dwFlags, pszFormat, argList);
+}
 
 HRESULT StringCchVPrintfA(
         LPSTR pszDest,
         size_t cchDest,
         LPCSTR pszFormat,
         va_list argList){
-    return StringCchVPrintfExA(pszDest, cchDest, NULL, NULL, 0,
+    return strsafe_vprintf_a_no_flags(pszDest, cchDest, NULL, NULL,
             pszFormat, argList);
 }
 
@@ -34,7 +124,7 @@ HRESULT StringCchVPrintfW(
         size_t cchDest,
         LPCWSTR pszFormat,
         va_list argList){
-    return StringCchVPrintfExW(pszDest, cchDest, NULL, NULL, 0,
+    return strsafe_vprintf_w_no_flags(pszDest, cchDest, NULL, NULL,
             pszFormat, argList);
 }
 
@@ -46,11 +136,8 @@ HRESULT StringCchVPrintfExA(
         DWORD dwFlags,
         LPCSTR pszFormat,
         va_list argList){
-     /* This function has a generic implementation in
-     * strsafe_vprintf_generic.h. */
-    #define STRSAFE_GENERIC_WIDE_CHAR 0
-    #include "strsafe_vprintf_generic.h"
-    #undef STRSAFE_GENERIC_WIDE_CHAR
+    return strsafe_vprintf_a(pszDest, cchDest, ppszDestEnd,
+            pcchRemaining, dwFlags, pszFormat, argList);
 }
 
 HRESULT StringCchVPrintfExW(
@@ -61,11 +148,8 @@ HRESULT StringCchVPrintfExW(
         DWORD dwFlags,
         LPCWSTR pszFormat,
         va_list argList){
-    /* This function has a generic implementation in
-     * strsafe_vprintf_generic.h. */
-    #define STRSAFE_GENERIC_WIDE_CHAR 1
-    #include "strsafe_vprintf_generic.h"
-    #undef STRSAFE_GENERIC_WIDE_CHAR
+    return strsafe_vprintf_w(pszDest, cchDest, ppszDestEnd,
+            pcchRemaining, dwFlags, pszFormat, argList);
 }
 
 HRESULT StringCbVPrintfA(
@@ -73,7 +157,7 @@ HRESULT StringCbVPrintfA(
         size_t cbDest,
         LPCSTR pszFormat,
         va_list argList){
-    return StringCbVPrintfExA(pszDest, cbDest, NULL, NULL, 0,
+    return strsafe_vprintf_a_no_flags(pszDest, cbDest, NULL, NULL,
             pszFormat, argList);
 }
 
@@ -82,8 +166,8 @@ HRESULT StringCbVPrintfW(
         size_t cbDest,
         LPCWSTR pszFormat,
         va_list argList){
-    return StringCbVPrintfExW(pszDest, cbDest, NULL, NULL, 0,
-            pszFormat, argList);
+    return strsafe_vprintf_w_no_flags(pszDest, cbDest / sizeof(wchar_t),
+            NULL, NULL, pszFormat, argList);
 }
 
 HRESULT StringCbVPrintfExA(
@@ -94,7 +178,7 @@ HRESULT StringCbVPrintfExA(
         DWORD dwFlags,
         LPCSTR pszFormat,
         va_list argList){
-    return StringCchVPrintfExA(pszDest, cbDest, ppszDestEnd,
+    return strsafe_vprintf_a(pszDest, cbDest, ppszDestEnd,
             pcbRemaining, dwFlags, pszFormat, argList);
 }
 
@@ -106,7 +190,7 @@ HRESULT StringCbVPrintfExW(
         DWORD dwFlags,
         LPCWSTR pszFormat,
         va_list argList){
-    HRESULT result = StringCchVPrintfExW(pszDest, cbDest / sizeof(wchar_t),
+    HRESULT result = strsafe_vprintf_w(pszDest, cbDest / sizeof(wchar_t),
             ppszDestEnd, pcbRemaining, dwFlags, pszFormat, argList);
     if(pcbRemaining != NULL){
         *pcbRemaining *= sizeof(wchar_t);
@@ -5,6 +5,12 @@
  * details, see the LICENSE file.
  */
 
+/*
+ * Internal header for generic implementation of libstrsafe functions.
+ * Like in strsafe_catn_generic.h, STRSAFE_GENERIC_FLAGS can be defined to
+ * a constant that takes the place of dwFlags.
+ */
+
 #ifndef STRSAFE_GENERIC_WIDE_CHAR
 #error "STRSAFE_GENERIC_WIDE_CHAR must be defined."
 #elif STRSAFE_GENERIC_WIDE_CHAR == 0
@@ -17,6 +23,9 @@
 #define STRSAFE_TEXT(c) L##c
 #endif
 
+#ifdef STRSAFE_GENERIC_FLAGS
+const DWORD dwFlags = STRSAFE_GENERIC_FLAGS;
+#endif
 size_t length;
 HRESULT result = S_OK;
 
@@ -42,7 +51,7 @@ if((dwFlags & STRSAFE_IGNORE_NULLS) && pszFormat == NULL){
         } else if(dwFlags & STRSAFE_FILL_ON_FAILURE){
             /* pszDest should be filled with the lower byte of dwFlags
              * and null terminated. */
-            memset(pszDest, dwFlags & 0xff,
+            strsafe_fill(pszDest, dwFlags & 0xff,
                     (cchDest - 1) * sizeof(STRSAFE_CHAR));
             length = cchDest - 1;
         } else {
@@ -60,7 +69,7 @@ if(pcchRemaining != NULL){
     *pcchRemaining = cchDest - length;
 }
 if((dwFlags & STRSAFE_FILL_BEHIND_NULL) && length + 1 < cchDest){
-    memset(pszDest + length + 1, dwFlags & 0xff,
+    strsafe_fill(pszDest + length + 1, dwFlags & 0xff,
             (cchDest - length - 1) * sizeof(STRSAFE_CHAR));
 }
 
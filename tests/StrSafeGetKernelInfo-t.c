@@ -0,0 +1,59 @@
+#include <stdlib.h>
+#include <string.h>
+#include <strsafe.h>
+#include "tap/basic.h"
+
+/*
+ * Checks that a kernel is named after one of the known sets.
+ */
+int isKernel(const char * name){
+    static const char * const names[] = {
+        "avx512", "avx2", "sse2", "swar", "scalar"
+    };
+    size_t i;
+
+    if(name == NULL){
+        return 0;
+    }
+    for(i = 0; i < sizeof(names) / sizeof(names[0]); i++){
+        if(strcmp(name, names[i]) == 0){
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(void){
+    STRSAFE_KERNEL_INFO info;
+    const char * forced = getenv("STRSAFE_KERNEL");
+
+    plan(11);
+
+    ok(StrSafeGetKernelInfo(NULL) == STRSAFE_E_INVALID_PARAMETER,
+            "Make sure error is thrown for a NULL structure.");
+
+    ok(SUCCEEDED(StrSafeGetKernelInfo(&info)),
+            "Get the kernel information.");
+    ok(isKernel(info.pszLengthA), "Name of narrow length kernel.");
+    ok(isKernel(info.pszLengthW), "Name of wide length kernel.");
+    ok(isKernel(info.pszCopyA), "Name of narrow copy kernel.");
+    ok(isKernel(info.pszCopyW), "Name of wide copy kernel.");
+    ok(info.pszDispatch != NULL && (strcmp(info.pszDispatch, "ifunc") == 0 ||
+            strcmp(info.pszDispatch, "table") == 0),
+            "Name of dispatch method.");
+
+    /* The portable sets are supported everywhere, so forcing one of them
+     * must pick it for every kernel. Kernels bound as indirect functions
+     * cannot be forced. */
+    if(forced != NULL && strcmp(info.pszDispatch, "table") == 0 &&
+            (strcmp(forced, "swar") == 0 || strcmp(forced, "scalar") == 0)){
+        is_string(forced, info.pszLengthA, "Forced narrow length kernel.");
+        is_string(forced, info.pszLengthW, "Forced wide length kernel.");
+        is_string(forced, info.pszCopyA, "Forced narrow copy kernel.");
+        is_string(forced, info.pszCopyW, "Forced wide copy kernel.");
+    } else {
+        skip_block(4, "No portable kernel set forced through the table.");
+    }
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <string.h>
+#define STRSAFE_INLINE
+#include <strsafe.h>
+#include "tap/basic.h"
+
+/*
+ * The results of the inline versions must be the same as the results of
+ * the library functions, which are called with the names in parentheses
+ * to get around the macros. Both are called with buffers filled with the
+ * same data, and the whole buffers are compared afterwards.
+ */
+
+char inlineDest[16];
+char libraryDest[16];
+
+void reset(){
+    memset(inlineDest, '#', sizeof(inlineDest));
+    memset(libraryDest, '#', sizeof(libraryDest));
+}
+
+void compare(HRESULT inlineResult, HRESULT libraryResult, const char * name){
+    ok(inlineResult == libraryResult &&
+            memcmp(inlineDest, libraryDest, sizeof(inlineDest)) == 0,
+            "%s", name);
+}
+
+int main(void){
+    char source[] = "not a literal";
+    char * dest;
+    size_t cchDest = 11;
+    HRESULT result;
+
+    plan(10);
+
+    reset();
+    result = StringCchCopyA(inlineDest, 11, "test");
+    compare(result, (StringCchCopyA)(libraryDest, 11, "test"),
+            "Copy a short literal.");
+
+    reset();
+    result = StringCchCopyA(inlineDest, 11, "");
+    compare(result, (StringCchCopyA)(libraryDest, 11, ""),
+            "Copy an empty literal.");
+
+    reset();
+    result = StringCchCopyA(inlineDest, 11, "0123456789");
+    compare(result, (StringCchCopyA)(libraryDest, 11, "0123456789"),
+            "Copy a literal that just fits.");
+
+    reset();
+    result = StringCchCopyA(inlineDest, 11, "longer string");
+    compare(result, (StringCchCopyA)(libraryDest, 11, "longer string"),
+            "Copy a literal that is too long.");
+
+    reset();
+    result = StringCchCopyA(inlineDest, 0, "test");
+    compare(result, (StringCchCopyA)(libraryDest, 0, "test"),
+            "Copy with cchDest set to zero.");
+
+    reset();
+    result = StringCchCopyA(inlineDest, cchDest, source);
+    compare(result, (StringCchCopyA)(libraryDest, cchDest, source),
+            "Copy a string that is not a literal.");
+
+    reset();
+    dest = inlineDest + 2;
+    result = StringCchCopyA(dest, 11, "pointer");
+    dest = libraryDest + 2;
+    compare(result, (StringCchCopyA)(dest, 11, "pointer"),
+            "Copy to a pointer into a buffer.");
+
+    reset();
+    result = StringCbCopyA(inlineDest, sizeof(inlineDest), "bytes");
+    compare(result, (StringCbCopyA)(libraryDest, sizeof(libraryDest), "bytes"),
+            "Copy a short literal with the size in bytes.");
+
+    reset();
+    result = StringCbCopyA(inlineDest, 4, "bytes");
+    compare(result, (StringCbCopyA)(libraryDest, 4, "bytes"),
+            "Copy a literal that is too long with the size in bytes.");
+
+    reset();
+    result = StringCchCopyA(inlineDest, STRSAFE_MAX_CCH + 1, "test");
+    compare(result, (StringCchCopyA)(libraryDest, STRSAFE_MAX_CCH + 1, "test"),
+            "Copy with a too large cchDest.");
+
+    return 0;
+}
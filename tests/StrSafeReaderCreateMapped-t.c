@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <strsafe.h>
+#include "tap/basic.h"
+
+/*
+ * Creates a temporary file with the given contents, positioned at the
+ * start.
+ */
+FILE * openWith(const char * contents, size_t length){
+    FILE * file = tmpfile();
+
+    if(file == NULL){
+        sysbail("Could not create a temporary file");
+    }
+    fwrite(contents, 1, length, file);
+    fflush(file);
+    rewind(file);
+
+    return file;
+}
+
+/*
+ * Checks whether a line has the given contents.
+ */
+int isLine(const STRSAFE_SEGMENT_A * line, const char * wanted){
+    return line->cch == strlen(wanted) &&
+            memcmp(line->pch, wanted, line->cch) == 0;
+}
+
+void testLines(){
+    static const char contents[] =
+            "skipped\nfirst line\na line longer than the buffer\nlast";
+    FILE * file = openWith(contents, sizeof(contents) - 1);
+    STRSAFE_READER * reader;
+    STRSAFE_SEGMENT_A line;
+    char dest[16];
+    char * destEnd;
+    size_t remaining;
+
+    diag("Test reading lines from a mapped file.");
+
+    if(lseek(fileno(file), 8, SEEK_SET) != 8){
+        sysbail("Could not seek in a temporary file");
+    }
+    ok(SUCCEEDED(StrSafeReaderCreateMapped(&reader, fileno(file), 8)),
+            "Create a reader for a regular file.");
+
+    ok(StringCchReadLineExA(reader, dest, 16, &destEnd, &remaining, 0) ==
+            S_OK,
+            "Read a line from the offset of the file.");
+    is_string("first line", dest, "Result of reading a line.");
+    ok(destEnd == &dest[10] && remaining == 6,
+            "End of the result of reading a line.");
+
+    ok(StringCchPeekLineA(reader, 100, &line) == S_OK,
+            "Peek at a line longer than the buffer.");
+    ok(isLine(&line, "a line longer than the buffer"),
+            "Result of peeking at a line longer than the buffer.");
+
+    ok(StringCchReadLineExA(reader, dest, 16, NULL, NULL,
+                    STRSAFE_FILL_BEHIND_NULL | '@') == S_OK,
+            "Read a last line without a line break.");
+    ok(strcmp(dest, "last") == 0 && memcmp(dest + 5, "@@@@@@", 6) == 0,
+            "Result of reading a last line without a line break.");
+
+    ok(StringCchReadLineExA(reader, dest, 16, NULL, NULL,
+                    STRSAFE_NULL_ON_FAILURE) == STRSAFE_E_END_OF_FILE,
+            "Read at the end of the file.");
+    is_string("", dest, "Result of reading at the end of the file.");
+    ok(StringCchPeekLineA(reader, 100, &line) == STRSAFE_E_END_OF_FILE,
+            "Peek at the end of the file.");
+
+    StrSafeReaderDestroy(reader);
+    fclose(file);
+}
+
+void testFallback(){
+    FILE * file = openWith("", 0);
+    int fds[2];
+    STRSAFE_READER * reader;
+    STRSAFE_SEGMENT_A line;
+
+    diag("Test creating readers for what cannot be mapped.");
+
+    ok(SUCCEEDED(StrSafeReaderCreateMapped(&reader, fileno(file), 0)),
+            "Create a reader for an empty file.");
+    ok(StringCchPeekLineA(reader, 100, &line) == STRSAFE_E_END_OF_FILE,
+            "Peek at the end of an empty file.");
+    StrSafeReaderDestroy(reader);
+
+    if(pipe(fds) != 0){
+        sysbail("Could not create a pipe");
+    }
+    if(write(fds[1], "0123456789\nab", 13) != 13){
+        sysbail("Could not write to a pipe");
+    }
+    close(fds[1]);
+    ok(SUCCEEDED(StrSafeReaderCreateMapped(&reader, fds[0], 8)),
+            "Create a reader for a pipe.");
+    ok(StringCchPeekLineA(reader, 100, &line) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER && isLine(&line, "0123456"),
+            "Peek at a line longer than the buffer of a pipe reader.");
+    ok(StringCchPeekLineA(reader, 100, &line) == S_OK &&
+            isLine(&line, "789"),
+            "Peek at the rest of the line from a pipe.");
+    ok(StringCchPeekLineA(reader, 100, &line) == S_OK &&
+            isLine(&line, "ab"),
+            "Peek at a last line without a line break from a pipe.");
+    ok(StringCchPeekLineA(reader, 100, &line) == STRSAFE_E_END_OF_FILE,
+            "Peek at the end of a pipe.");
+    StrSafeReaderDestroy(reader);
+    close(fds[0]);
+
+    ok(StrSafeReaderCreateMapped(NULL, 0, 0) == STRSAFE_E_INVALID_PARAMETER,
+            "Create a reader with ppReader set to NULL.");
+    ok(StrSafeReaderCreateMapped(&reader, -1, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Create a reader for an invalid file descriptor.");
+
+    fclose(file);
+}
+
+/*
+ * Compares the results with those of StringCchFGetsExA for random lines
+ * read from many offsets into the file, including ones that are not at a
+ * page boundary.
+ */
+void testCompare(){
+    static char contents[50000];
+    static const long offsets[] = {0, 1, 4095, 4096, 4097, 40000};
+    size_t i;
+
+    diag("Compare with StringCchFGetsExA.");
+
+    srand(1);
+    for(i = 0; i < sizeof(contents); i++){
+        contents[i] = rand() % 40 == 0 ? '\n' : (char)('a' + rand() % 26);
+    }
+
+    for(i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++){
+        FILE * file = openWith(contents, sizeof(contents));
+        FILE * check = openWith(contents, sizeof(contents));
+        STRSAFE_READER * reader;
+        int correct = 1;
+        HRESULT wantedResult;
+
+        if(lseek(fileno(file), offsets[i], SEEK_SET) != offsets[i] ||
+                fseek(check, offsets[i], SEEK_SET) != 0){
+            sysbail("Could not seek in a temporary file");
+        }
+        if(FAILED(StrSafeReaderCreateMapped(&reader, fileno(file), 0))){
+            bail("Could not create a reader");
+        }
+
+        do {
+            char dest[64];
+            char expected[64];
+            char * destEnd;
+            char * expectedEnd;
+            size_t cchDest = (size_t)(rand() % 63) + 1;
+            HRESULT result;
+
+            result = StringCchReadLineExA(reader, dest, cchDest, &destEnd,
+                    NULL, 0);
+            wantedResult = StringCchFGetsExA(expected, cchDest, check,
+                    &expectedEnd, NULL, 0);
+            correct = correct && result == wantedResult &&
+                    strcmp(dest, expected) == 0 &&
+                    destEnd - dest == expectedEnd - expected;
+        } while(wantedResult != STRSAFE_E_END_OF_FILE && correct);
+
+        ok(correct, "Same results as StringCchFGetsExA from offset %ld.",
+                offsets[i]);
+
+        StrSafeReaderDestroy(reader);
+        fclose(check);
+        fclose(file);
+    }
+}
+
+int main(void){
+    plan(11 + 9 + 6);
+
+    testLines();
+    testFallback();
+    testCompare();
+
+    return 0;
+}
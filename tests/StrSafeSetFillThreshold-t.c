@@ -0,0 +1,79 @@
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <strsafe.h>
+#include "tap/basic.h"
+
+#define SIZE 4096
+
+/*
+ * Fills buffers of many sizes and alignments with STRSAFE_FILL_BEHIND_NULL
+ * and compares them with the result of memset.
+ */
+int checkFillBehindNull(char * buffer, char * expected){
+    size_t offset;
+    int correct = 1;
+
+    for(offset = 0; offset < 64; offset += 7){
+        size_t cchDest;
+        for(cchDest = 2; offset + cchDest <= SIZE; cchDest += 61){
+            memset(buffer, '#', SIZE);
+            memset(expected, '#', SIZE);
+            expected[offset] = 'a';
+            expected[offset + 1] = '\0';
+            memset(expected + offset + 2, '@', cchDest - 2);
+            buffer[offset] = '\0';
+            correct = correct && SUCCEEDED(StringCchCatExA(buffer + offset,
+                    cchDest, "a", NULL, NULL,
+                    STRSAFE_FILL_BEHIND_NULL | '@')) &&
+                    memcmp(buffer, expected, SIZE) == 0;
+        }
+    }
+
+    return correct;
+}
+
+int main(void){
+    char * buffer = malloc(SIZE);
+    char * expected = malloc(SIZE);
+    wchar_t wideBuffer[600];
+    char wanted[600 * sizeof(wchar_t)];
+
+    plan(6);
+
+    if(buffer == NULL || expected == NULL){
+        bail("Out of memory.");
+    }
+
+    ok(checkFillBehindNull(buffer, expected),
+            "Fill with the default threshold.");
+
+    ok(SUCCEEDED(StrSafeSetFillThreshold(0)),
+            "Set the threshold to zero.");
+    ok(checkFillBehindNull(buffer, expected),
+            "Fill with non-temporal stores.");
+
+    ok(StringCchCopyExA(buffer, SIZE, "0123456", NULL, NULL, 0) == S_OK &&
+            StringCchCatNExA(buffer, 8, "x", 1, NULL, NULL,
+                    STRSAFE_FILL_ON_FAILURE | 'z') ==
+                    STRSAFE_E_INSUFFICIENT_BUFFER &&
+            strcmp(buffer, "zzzzzzz") == 0,
+            "Fill on failure with non-temporal stores.");
+
+    memset(wanted, '@', sizeof(wanted));
+    wideBuffer[0] = L'\0';
+    ok(SUCCEEDED(StringCchCatExW(wideBuffer, 600, L"ab", NULL, NULL,
+                    STRSAFE_FILL_BEHIND_NULL | '@')) &&
+            wcscmp(wideBuffer, L"ab") == 0 &&
+            memcmp(wideBuffer + 3, wanted, 597 * sizeof(wchar_t)) == 0,
+            "Fill a wide buffer with non-temporal stores.");
+
+    StrSafeSetFillThreshold(SIZE + 1);
+    ok(checkFillBehindNull(buffer, expected),
+            "Fill with a threshold larger than the buffers.");
+
+    free(buffer);
+    free(expected);
+
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include <stdio.h>
+#include <string.h>
+#include <strsafe.h>
+#include "tap/basic.h"
+
+int main(void){
+    static const char contents[] = "first line\nsecond";
+    FILE * file = tmpfile();
+    char dest[8];
+    char * destEnd;
+    size_t remaining;
+
+    plan(6);
+
+    if(file == NULL){
+        sysbail("Could not create a temporary file");
+    }
+    fwrite(contents, 1, sizeof(contents) - 1, file);
+    rewind(file);
+
+    ok(StringCbFGetsExA(dest, 8, file, &destEnd, &remaining, 0) == S_OK,
+            "Read a line that does not fit.");
+    ok(strcmp(dest, "first l") == 0 && destEnd == &dest[7] &&
+            remaining == 1,
+            "Result of reading a line that does not fit.");
+
+    ok(StringCbFGetsExA(dest, 8, file, &destEnd, &remaining, 0) == S_OK,
+            "Read the rest of the line.");
+    ok(strcmp(dest, "ine") == 0 && destEnd == &dest[3] && remaining == 5,
+            "Result of reading the rest of the line.");
+
+    ok(StringCbFGetsExA(dest, 8, file, NULL, NULL, 0) == S_OK,
+            "Read the last line.");
+    is_string("second", dest, "Result of reading the last line.");
+
+    fclose(file);
+
+    return 0;
+}
@@ -0,0 +1,42 @@
+#include <stdio.h>
+#include <string.h>
+#include <wchar.h>
+#define STRSAFE_NO_DEPRECATE
+#include <strsafe.h>
+#include "tap/wide.h"
+
+int main(void){
+    FILE * file = tmpfile();
+    wchar_t dest[8];
+    const size_t cbDest = sizeof(dest);
+    wchar_t * destEnd;
+    size_t remaining;
+
+    plan(6);
+
+    if(file == NULL){
+        sysbail("Could not create a temporary file");
+    }
+    fputws(L"first line\nsecond", file);
+    rewind(file);
+
+    ok(StringCbFGetsExW(dest, cbDest, file, &destEnd, &remaining, 0) == S_OK,
+            "Read a line that does not fit.");
+    ok(wcscmp(dest, L"first l") == 0 && destEnd == &dest[7] &&
+            remaining == sizeof(wchar_t),
+            "Result of reading a line that does not fit.");
+
+    ok(StringCbFGetsExW(dest, cbDest, file, &destEnd, &remaining, 0) == S_OK,
+            "Read the rest of the line.");
+    ok(wcscmp(dest, L"ine") == 0 && destEnd == &dest[3] &&
+            remaining == 5 * sizeof(wchar_t),
+            "Result of reading the rest of the line.");
+
+    ok(StringCbFGetsExW(dest, cbDest, file, NULL, NULL, 0) == S_OK,
+            "Read the last line.");
+    is_wstring(L"second", dest, "Result of reading the last line.");
+
+    fclose(file);
+
+    return 0;
+}
@@ -5,7 +5,7 @@
 int main(void){
     size_t length;
 
-    plan(7);
+    plan(9);
 
     ok(SUCCEEDED(StringCbLengthW(L"", 1 * sizeof(wchar_t), &length)),
             "Calculate length of empty string.");
@@ -26,5 +26,11 @@ int main(void){
             STRSAFE_E_INVALID_PARAMETER,
             "Make sure error is thrown if null termination is not found.");
 
+    ok(StringCbLengthW(NULL, 5 * sizeof(wchar_t), &length) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Make sure error is thrown for a NULL string.");
+    is_int(0, length,
+            "Value for length of a NULL string.");
+
     return 0;
 }
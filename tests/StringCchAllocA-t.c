@@ -0,0 +1,187 @@
+#include <stdlib.h>
+#include <string.h>
+#include <strsafe.h>
+#include "tap/basic.h"
+
+/* Counts the calls to the allocator and fails when told to. */
+int reallocs = 0;
+int frees = 0;
+int failing = 0;
+
+void * countingRealloc(void * pContext, void * pv, size_t cb){
+    (void)pContext;
+    if(failing){
+        return NULL;
+    }
+    reallocs++;
+    return realloc(pv, cb);
+}
+
+void countingFree(void * pContext, void * pv){
+    (void)pContext;
+    if(pv != NULL){
+        frees++;
+    }
+    free(pv);
+}
+
+void testCopyCat(){
+    char * dest = NULL;
+    size_t cchDest = 0;
+    char longString[301];
+    size_t i;
+
+    diag("Test copying and concatenating to allocated buffers.");
+
+    for(i = 0; i < 300; i++){
+        longString[i] = (char)('a' + i % 26);
+    }
+    longString[300] = '\0';
+
+    ok(SUCCEEDED(StringCchCopyAllocA(&dest, &cchDest, "test")),
+            "Copy to an unallocated buffer.");
+    ok(dest != NULL && cchDest >= 5,
+            "Buffer allocated for copying.");
+    is_string("test", dest,
+            "Result of copying to an unallocated buffer.");
+
+    ok(SUCCEEDED(StringCchCatAllocA(&dest, &cchDest, "ing")),
+            "Concatenate to an allocated buffer.");
+    is_string("testing", dest,
+            "Result of concatenating to an allocated buffer.");
+
+    reallocs = 0;
+    ok(SUCCEEDED(StringCchCatAllocA(&dest, &cchDest, longString)),
+            "Concatenate a string that does not fit in the buffer.");
+    ok(cchDest > 307 && strlen(dest) == 307 &&
+            memcmp(dest + 7, longString, 300 * sizeof(char)) == 0,
+            "Result of concatenating a string that does not fit.");
+    is_int(1, reallocs,
+            "Buffer reallocated once for a string that does not fit.");
+
+    reallocs = 0;
+    for(i = 0; i < 100; i++){
+        StringCchCatAllocA(&dest, &cchDest, longString);
+    }
+    is_int(30307, (long)strlen(dest),
+            "Length after concatenating many strings.");
+    ok(reallocs <= 7,
+            "Buffer reallocated a few times for many strings.");
+
+    reallocs = 0;
+    ok(SUCCEEDED(StringCchCopyAllocA(&dest, &cchDest, "short")),
+            "Copy a short string to a large buffer.");
+    is_string("short", dest,
+            "Result of copying a short string to a large buffer.");
+    is_int(0, reallocs,
+            "Buffer not reallocated for a short string.");
+
+    frees = 0;
+    StrSafeFree(dest);
+    is_int(1, frees,
+            "Buffer freed with the allocator.");
+}
+
+void testPrintf(){
+    char * dest = NULL;
+    size_t cchDest = 0;
+    char longString[301];
+    size_t i;
+
+    diag("Test formatting to allocated buffers.");
+
+    for(i = 0; i < 300; i++){
+        longString[i] = (char)('a' + i % 26);
+    }
+    longString[300] = '\0';
+
+    ok(SUCCEEDED(StringCchPrintfAllocA(&dest, &cchDest, "%s-%d",
+                    "test", 42)),
+            "Format to an unallocated buffer.");
+    is_string("test-42", dest,
+            "Result of formatting to an unallocated buffer.");
+
+    ok(SUCCEEDED(StringCchPrintfAllocA(&dest, &cchDest, "%s-%d",
+                    longString, 42)),
+            "Format a string that does not fit in the buffer.");
+    ok(cchDest > 303 && strlen(dest) == 303 &&
+            memcmp(dest, longString, 300 * sizeof(char)) == 0 &&
+            dest[300] == '-',
+            "Result of formatting a string that does not fit.");
+
+    reallocs = 0;
+    ok(SUCCEEDED(StringCchPrintfAllocA(&dest, &cchDest, "%s-%d",
+                    "again", 7)),
+            "Format a short string to a large buffer.");
+    is_string("again-7", dest,
+            "Result of formatting a short string to a large buffer.");
+    is_int(0, reallocs,
+            "Buffer not reallocated for a short string.");
+
+    StrSafeFree(dest);
+}
+
+void testFailures(){
+    char * dest = NULL;
+    size_t cchDest = 0;
+    char longString[301];
+    size_t i;
+
+    diag("Test failures.");
+
+    for(i = 0; i < 300; i++){
+        longString[i] = (char)('a' + i % 26);
+    }
+    longString[300] = '\0';
+
+    StringCchCopyAllocA(&dest, &cchDest, "kept");
+    failing = 1;
+    ok(StringCchCatAllocA(&dest, &cchDest, longString) ==
+            STRSAFE_E_OUT_OF_MEMORY,
+            "Concatenate when memory cannot be allocated.");
+    is_string("kept", dest,
+            "Buffer kept when memory cannot be allocated.");
+    ok(StringCchPrintfAllocA(&dest, &cchDest, "%s-%d", longString, 1) ==
+            STRSAFE_E_OUT_OF_MEMORY,
+            "Format when memory cannot be allocated.");
+    failing = 0;
+
+    ok(StringCchCopyAllocA(NULL, &cchDest, "test") ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Copy without a buffer pointer.");
+    ok(StringCchCopyAllocA(&dest, &cchDest, NULL) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Copy from NULL.");
+    reallocs = 0;
+    ok(StringCchPrintfAllocA(&dest, &cchDest, "%") ==
+            STRSAFE_E_INVALID_PARAMETER && reallocs == 0,
+            "Format with an invalid format string.");
+    for(i = 0; i < cchDest; i++){
+        dest[i] = 'x';
+    }
+    ok(StringCchCatAllocA(&dest, &cchDest, "test") ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Concatenate to a buffer that is not null terminated.");
+
+    StrSafeFree(dest);
+}
+
+int main(void){
+    STRSAFE_ALLOCATOR allocator = {countingRealloc, countingFree, NULL};
+    STRSAFE_ALLOCATOR invalid = {countingRealloc, NULL, NULL};
+
+    plan(2 + 14 + 7 + 7);
+
+    ok(StrSafeSetAllocator(&invalid) == STRSAFE_E_INVALID_PARAMETER,
+            "Set an allocator without a free function.");
+    ok(SUCCEEDED(StrSafeSetAllocator(&allocator)),
+            "Set an allocator.");
+
+    testCopyCat();
+    testPrintf();
+    testFailures();
+
+    StrSafeSetAllocator(NULL);
+
+    return 0;
+}
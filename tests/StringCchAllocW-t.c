@@ -0,0 +1,189 @@
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#define STRSAFE_NO_DEPRECATE
+#include <strsafe.h>
+#include "tap/wide.h"
+
+/* Counts the calls to the allocator and fails when told to. */
+int reallocs = 0;
+int frees = 0;
+int failing = 0;
+
+void * countingRealloc(void * pContext, void * pv, size_t cb){
+    (void)pContext;
+    if(failing){
+        return NULL;
+    }
+    reallocs++;
+    return realloc(pv, cb);
+}
+
+void countingFree(void * pContext, void * pv){
+    (void)pContext;
+    if(pv != NULL){
+        frees++;
+    }
+    free(pv);
+}
+
+void testCopyCat(){
+    wchar_t * dest = NULL;
+    size_t cchDest = 0;
+    wchar_t longString[301];
+    size_t i;
+
+    diag("Test copying and concatenating to allocated buffers.");
+
+    for(i = 0; i < 300; i++){
+        longString[i] = (wchar_t)('a' + i % 26);
+    }
+    longString[300] = L'\0';
+
+    ok(SUCCEEDED(StringCchCopyAllocW(&dest, &cchDest, L"test")),
+            "Copy to an unallocated buffer.");
+    ok(dest != NULL && cchDest >= 5,
+            "Buffer allocated for copying.");
+    is_wstring(L"test", dest,
+            "Result of copying to an unallocated buffer.");
+
+    ok(SUCCEEDED(StringCchCatAllocW(&dest, &cchDest, L"ing")),
+            "Concatenate to an allocated buffer.");
+    is_wstring(L"testing", dest,
+            "Result of concatenating to an allocated buffer.");
+
+    reallocs = 0;
+    ok(SUCCEEDED(StringCchCatAllocW(&dest, &cchDest, longString)),
+            "Concatenate a string that does not fit in the buffer.");
+    ok(cchDest > 307 && wcslen(dest) == 307 &&
+            memcmp(dest + 7, longString, 300 * sizeof(wchar_t)) == 0,
+            "Result of concatenating a string that does not fit.");
+    is_int(1, reallocs,
+            "Buffer reallocated once for a string that does not fit.");
+
+    reallocs = 0;
+    for(i = 0; i < 100; i++){
+        StringCchCatAllocW(&dest, &cchDest, longString);
+    }
+    is_int(30307, (long)wcslen(dest),
+            "Length after concatenating many strings.");
+    ok(reallocs <= 7,
+            "Buffer reallocated a few times for many strings.");
+
+    reallocs = 0;
+    ok(SUCCEEDED(StringCchCopyAllocW(&dest, &cchDest, L"short")),
+            "Copy a short string to a large buffer.");
+    is_wstring(L"short", dest,
+            "Result of copying a short string to a large buffer.");
+    is_int(0, reallocs,
+            "Buffer not reallocated for a short string.");
+
+    frees = 0;
+    StrSafeFree(dest);
+    is_int(1, frees,
+            "Buffer freed with the allocator.");
+}
+
+void testPrintf(){
+    wchar_t * dest = NULL;
+    size_t cchDest = 0;
+    wchar_t longString[301];
+    size_t i;
+
+    diag("Test formatting to allocated buffers.");
+
+    for(i = 0; i < 300; i++){
+        longString[i] = (wchar_t)('a' + i % 26);
+    }
+    longString[300] = L'\0';
+
+    ok(SUCCEEDED(StringCchPrintfAllocW(&dest, &cchDest, L"%ls-%d",
+                    L"test", 42)),
+            "Format to an unallocated buffer.");
+    is_wstring(L"test-42", dest,
+            "Result of formatting to an unallocated buffer.");
+
+    ok(SUCCEEDED(StringCchPrintfAllocW(&dest, &cchDest, L"%ls-%d",
+                    longString, 42)),
+            "Format a string that does not fit in the buffer.");
+    ok(cchDest > 303 && wcslen(dest) == 303 &&
+            memcmp(dest, longString, 300 * sizeof(wchar_t)) == 0 &&
+            dest[300] == L'-',
+            "Result of formatting a string that does not fit.");
+
+    reallocs = 0;
+    ok(SUCCEEDED(StringCchPrintfAllocW(&dest, &cchDest, L"%ls-%d",
+                    L"again", 7)),
+            "Format a short string to a large buffer.");
+    is_wstring(L"again-7", dest,
+            "Result of formatting a short string to a large buffer.");
+    is_int(0, reallocs,
+            "Buffer not reallocated for a short string.");
+
+    StrSafeFree(dest);
+}
+
+void testFailures(){
+    wchar_t * dest = NULL;
+    size_t cchDest = 0;
+    wchar_t longString[301];
+    size_t i;
+
+    diag("Test failures.");
+
+    for(i = 0; i < 300; i++){
+        longString[i] = (wchar_t)('a' + i % 26);
+    }
+    longString[300] = L'\0';
+
+    StringCchCopyAllocW(&dest, &cchDest, L"kept");
+    failing = 1;
+    ok(StringCchCatAllocW(&dest, &cchDest, longString) ==
+            STRSAFE_E_OUT_OF_MEMORY,
+            "Concatenate when memory cannot be allocated.");
+    is_wstring(L"kept", dest,
+            "Buffer kept when memory cannot be allocated.");
+    ok(StringCchPrintfAllocW(&dest, &cchDest, L"%ls-%d", longString, 1) ==
+            STRSAFE_E_OUT_OF_MEMORY,
+            "Format when memory cannot be allocated.");
+    failing = 0;
+
+    ok(StringCchCopyAllocW(NULL, &cchDest, L"test") ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Copy without a buffer pointer.");
+    ok(StringCchCopyAllocW(&dest, &cchDest, NULL) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Copy from NULL.");
+    reallocs = 0;
+    ok(StringCchPrintfAllocW(&dest, &cchDest, L"%") ==
+            STRSAFE_E_INVALID_PARAMETER && reallocs == 0,
+            "Format with an invalid format string.");
+    for(i = 0; i < cchDest; i++){
+        dest[i] = L'x';
+    }
+    ok(StringCchCatAllocW(&dest, &cchDest, L"test") ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Concatenate to a buffer that is not null terminated.");
+
+    StrSafeFree(dest);
+}
+
+int main(void){
+    STRSAFE_ALLOCATOR allocator = {countingRealloc, countingFree, NULL};
+    STRSAFE_ALLOCATOR invalid = {countingRealloc, NULL, NULL};
+
+    plan(2 + 14 + 7 + 7);
+
+    ok(StrSafeSetAllocator(&invalid) == STRSAFE_E_INVALID_PARAMETER,
+            "Set an allocator without a free function.");
+    ok(SUCCEEDED(StrSafeSetAllocator(&allocator)),
+            "Set an allocator.");
+
+    testCopyCat();
+    testPrintf();
+    testFailures();
+
+    StrSafeSetAllocator(NULL);
+
+    return 0;
+}
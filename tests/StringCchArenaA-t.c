@@ -0,0 +1,195 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strsafe.h>
+#include "tap/basic.h"
+
+/* Counts the calls to the allocator and fails when told to. */
+int reallocs = 0;
+int frees = 0;
+int failing = 0;
+
+void * countingRealloc(void * pContext, void * pv, size_t cb){
+    (void)pContext;
+    if(failing){
+        return NULL;
+    }
+    reallocs++;
+    return realloc(pv, cb);
+}
+
+void countingFree(void * pContext, void * pv){
+    (void)pContext;
+    if(pv != NULL){
+        frees++;
+    }
+    free(pv);
+}
+
+void testDup(){
+    STRSAFE_ARENA * arena;
+    char * first;
+    char * second;
+    char * dest;
+    char longString[301];
+    size_t i;
+
+    diag("Test duplicating strings.");
+
+    for(i = 0; i < 300; i++){
+        longString[i] = (char)('a' + i % 26);
+    }
+    longString[300] = '\0';
+
+    ok(SUCCEEDED(StrSafeArenaCreate(&arena, 128)),
+            "Create an arena.");
+
+    reallocs = 0;
+    ok(SUCCEEDED(StringCchArenaDupA(arena, &first, "first")),
+            "Duplicate a string.");
+    is_string("first", first,
+            "Result of duplicating a string.");
+    ok(SUCCEEDED(StringCchArenaDupA(arena, &second, "second")),
+            "Duplicate another string.");
+    is_string("second", second,
+            "Result of duplicating another string.");
+    ok(strcmp(first, "first") == 0 && second == first + 6,
+            "Strings placed one after the other.");
+    is_int(1, reallocs,
+            "One chunk allocated for short strings.");
+
+    ok(SUCCEEDED(StringCchArenaDupNA(arena, &dest, "truncated", 5)),
+            "Duplicate the start of a string.");
+    is_string("trunc", dest,
+            "Result of duplicating the start of a string.");
+
+    ok(SUCCEEDED(StringCchArenaDupA(arena, &dest, longString)),
+            "Duplicate a string larger than a chunk.");
+    is_string(longString, dest,
+            "Result of duplicating a string larger than a chunk.");
+    is_string("second", second,
+            "Earlier strings kept when a chunk is added.");
+
+    StrSafeArenaReset(arena);
+    reallocs = 0;
+    for(i = 0; i < 20; i++){
+        StringCchArenaDupA(arena, &dest, "0123456789");
+    }
+    is_string("0123456789", dest,
+            "Result of duplicating strings after a reset.");
+    is_int(0, reallocs,
+            "Chunks reused after a reset.");
+
+    frees = 0;
+    StrSafeArenaDestroy(arena);
+    is_int(3, frees,
+            "Chunks and arena freed with the allocator.");
+}
+
+void testCatPrintf(){
+    STRSAFE_ARENA * arena;
+    char * first;
+    char * dest;
+    char longString[301];
+    size_t i;
+
+    diag("Test concatenating and formatting strings.");
+
+    for(i = 0; i < 300; i++){
+        longString[i] = (char)('a' + i % 26);
+    }
+    longString[300] = '\0';
+
+    StrSafeArenaCreate(&arena, 256);
+
+    StringCchArenaDupA(arena, &first, "left");
+    ok(SUCCEEDED(StringCchArenaCatA(arena, &dest, first, "right")),
+            "Concatenate to the last string.");
+    is_string("leftright", dest,
+            "Result of concatenating to the last string.");
+    ok(dest == first,
+            "Last string extended in place.");
+
+    ok(SUCCEEDED(StringCchArenaCatA(arena, &dest, "left", "")),
+            "Concatenate to a string from outside the arena.");
+    ok(dest != first && strcmp(dest, "left") == 0 &&
+            strcmp(first, "leftright") == 0,
+            "Result of concatenating to a string from outside the arena.");
+
+    ok(SUCCEEDED(StringCchArenaCatA(arena, &dest, dest, dest)),
+            "Concatenate a string to itself.");
+    is_string("leftleft", dest,
+            "Result of concatenating a string to itself.");
+
+    ok(SUCCEEDED(StringCchArenaPrintfA(arena, &dest, "%s-%d",
+                    "test", 42)),
+            "Format a string.");
+    is_string("test-42", dest,
+            "Result of formatting a string.");
+
+    ok(SUCCEEDED(StringCchArenaPrintfA(arena, &dest, "%s%s%s%s%s%s%s%s",
+                    longString, longString, longString, longString,
+                    longString, longString, longString, longString)),
+            "Format a string larger than a chunk.");
+    ok(strlen(dest) == 2400 && memcmp(dest + 2100, longString, 300) == 0,
+            "Result of formatting a string larger than a chunk.");
+
+    StrSafeArenaDestroy(arena);
+}
+
+void testFailures(){
+    STRSAFE_ARENA * arena;
+    char * dest = NULL;
+
+    diag("Test failures.");
+
+    ok(StrSafeArenaCreate(NULL, 0) == STRSAFE_E_INVALID_PARAMETER,
+            "Create an arena without a pointer to store it in.");
+    ok(StrSafeArenaCreate(&arena, SIZE_MAX - 8) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Create an arena with chunks too large to allocate.");
+
+    StrSafeArenaCreate(&arena, 64);
+    ok(StringCchArenaDupA(arena, &dest, NULL) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Duplicate NULL.");
+    ok(StringCchArenaDupA(NULL, &dest, "test") ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Duplicate without an arena.");
+    ok(StringCchArenaPrintfA(arena, &dest, NULL) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Format without a format string.");
+
+    failing = 1;
+    ok(StringCchArenaDupA(arena, &dest, "test") == STRSAFE_E_OUT_OF_MEMORY,
+            "Duplicate when memory cannot be allocated.");
+    ok(dest == NULL,
+            "Result not stored when memory cannot be allocated.");
+    failing = 0;
+
+    StringCchArenaDupA(arena, &dest, "test");
+    reallocs = 0;
+    ok(StringCchArenaPrintfA(arena, &dest, "%") ==
+            STRSAFE_E_INVALID_PARAMETER && reallocs == 0,
+            "Format with an invalid format string.");
+
+    StrSafeArenaDestroy(arena);
+    StrSafeArenaReset(NULL);
+    StrSafeArenaDestroy(NULL);
+}
+
+int main(void){
+    STRSAFE_ALLOCATOR allocator = {countingRealloc, countingFree, NULL};
+
+    plan(15 + 11 + 8);
+
+    StrSafeSetAllocator(&allocator);
+
+    testDup();
+    testCatPrintf();
+    testFailures();
+
+    StrSafeSetAllocator(NULL);
+
+    return 0;
+}
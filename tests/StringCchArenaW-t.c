@@ -0,0 +1,199 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#define STRSAFE_NO_DEPRECATE
+#include <strsafe.h>
+#include "tap/wide.h"
+
+/* Counts the calls to the allocator and fails when told to. */
+int reallocs = 0;
+int frees = 0;
+int failing = 0;
+
+void * countingRealloc(void * pContext, void * pv, size_t cb){
+    (void)pContext;
+    if(failing){
+        return NULL;
+    }
+    reallocs++;
+    return realloc(pv, cb);
+}
+
+void countingFree(void * pContext, void * pv){
+    (void)pContext;
+    if(pv != NULL){
+        frees++;
+    }
+    free(pv);
+}
+
+void testDup(){
+    STRSAFE_ARENA * arena;
+    wchar_t * first;
+    wchar_t * second;
+    wchar_t * dest;
+    wchar_t longString[301];
+    size_t i;
+
+    diag("Test duplicating strings.");
+
+    for(i = 0; i < 300; i++){
+        longString[i] = (wchar_t)(L'a' + i % 26);
+    }
+    longString[300] = L'\0';
+
+    ok(SUCCEEDED(StrSafeArenaCreate(&arena, 128)),
+            "Create an arena.");
+
+    reallocs = 0;
+    ok(SUCCEEDED(StringCchArenaDupW(arena, &first, L"first")),
+            "Duplicate a string.");
+    is_wstring(L"first", first,
+            "Result of duplicating a string.");
+    ok(SUCCEEDED(StringCchArenaDupW(arena, &second, L"second")),
+            "Duplicate another string.");
+    is_wstring(L"second", second,
+            "Result of duplicating another string.");
+    ok(wcscmp(first, L"first") == 0 && second == first + 6,
+            "Strings placed one after the other.");
+    is_int(1, reallocs,
+            "One chunk allocated for short strings.");
+
+    ok(SUCCEEDED(StringCchArenaDupNW(arena, &dest, L"truncated", 5)),
+            "Duplicate the start of a string.");
+    is_wstring(L"trunc", dest,
+            "Result of duplicating the start of a string.");
+
+    ok(SUCCEEDED(StringCchArenaDupW(arena, &dest, longString)),
+            "Duplicate a string larger than a chunk.");
+    is_wstring(longString, dest,
+            "Result of duplicating a string larger than a chunk.");
+    is_wstring(L"second", second,
+            "Earlier strings kept when a chunk is added.");
+
+    StrSafeArenaReset(arena);
+    reallocs = 0;
+    for(i = 0; i < 20; i++){
+        StringCchArenaDupW(arena, &dest, L"0123456789");
+    }
+    is_wstring(L"0123456789", dest,
+            "Result of duplicating strings after a reset.");
+    is_int(0, reallocs,
+            "Chunks reused after a reset.");
+
+    frees = 0;
+    StrSafeArenaDestroy(arena);
+    is_int(3, frees,
+            "Chunks and arena freed with the allocator.");
+}
+
+void testCatPrintf(){
+    STRSAFE_ARENA * arena;
+    wchar_t * first;
+    wchar_t * dest;
+    wchar_t longString[301];
+    size_t i;
+
+    diag("Test concatenating and formatting strings.");
+
+    for(i = 0; i < 300; i++){
+        longString[i] = (wchar_t)(L'a' + i % 26);
+    }
+    longString[300] = L'\0';
+
+    StrSafeArenaCreate(&arena, 256);
+
+    StringCchArenaDupW(arena, &first, L"left");
+    ok(SUCCEEDED(StringCchArenaCatW(arena, &dest, first, L"right")),
+            "Concatenate to the last string.");
+    is_wstring(L"leftright", dest,
+            "Result of concatenating to the last string.");
+    ok(dest == first,
+            "Last string extended in place.");
+
+    ok(SUCCEEDED(StringCchArenaCatW(arena, &dest, L"left", L"")),
+            "Concatenate to a string from outside the arena.");
+    ok(dest != first && wcscmp(dest, L"left") == 0 &&
+            wcscmp(first, L"leftright") == 0,
+            "Result of concatenating to a string from outside the arena.");
+
+    ok(SUCCEEDED(StringCchArenaCatW(arena, &dest, dest, dest)),
+            "Concatenate a string to itself.");
+    is_wstring(L"leftleft", dest,
+            "Result of concatenating a string to itself.");
+
+    ok(SUCCEEDED(StringCchArenaPrintfW(arena, &dest, L"%ls-%d",
+                    L"test", 42)),
+            "Format a string.");
+    is_wstring(L"test-42", dest,
+            "Result of formatting a string.");
+
+    ok(SUCCEEDED(StringCchArenaPrintfW(arena, &dest,
+                    L"%ls%ls%ls%ls%ls%ls%ls%ls",
+                    longString, longString, longString, longString,
+                    longString, longString, longString, longString)),
+            "Format a string larger than a chunk.");
+    ok(wcslen(dest) == 2400 && memcmp(dest + 2100, longString,
+                    300 * sizeof(wchar_t)) == 0,
+            "Result of formatting a string larger than a chunk.");
+
+    StrSafeArenaDestroy(arena);
+}
+
+void testFailures(){
+    STRSAFE_ARENA * arena;
+    wchar_t * dest = NULL;
+
+    diag("Test failures.");
+
+    ok(StrSafeArenaCreate(NULL, 0) == STRSAFE_E_INVALID_PARAMETER,
+            "Create an arena without a pointer to store it in.");
+    ok(StrSafeArenaCreate(&arena, SIZE_MAX - 8) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Create an arena with chunks too large to allocate.");
+
+    StrSafeArenaCreate(&arena, 64);
+    ok(StringCchArenaDupW(arena, &dest, NULL) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Duplicate NULL.");
+    ok(StringCchArenaDupW(NULL, &dest, L"test") ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Duplicate without an arena.");
+    ok(StringCchArenaPrintfW(arena, &dest, NULL) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Format without a format string.");
+
+    failing = 1;
+    ok(StringCchArenaDupW(arena, &dest, L"test") == STRSAFE_E_OUT_OF_MEMORY,
+            "Duplicate when memory cannot be allocated.");
+    ok(dest == NULL,
+            "Result not stored when memory cannot be allocated.");
+    failing = 0;
+
+    StringCchArenaDupW(arena, &dest, L"test");
+    reallocs = 0;
+    ok(StringCchArenaPrintfW(arena, &dest, L"%") ==
+            STRSAFE_E_INVALID_PARAMETER && reallocs == 0,
+            "Format with an invalid format string.");
+
+    StrSafeArenaDestroy(arena);
+    StrSafeArenaReset(NULL);
+    StrSafeArenaDestroy(NULL);
+}
+
+int main(void){
+    STRSAFE_ALLOCATOR allocator = {countingRealloc, countingFree, NULL};
+
+    plan(15 + 11 + 8);
+
+    StrSafeSetAllocator(&allocator);
+
+    testDup();
+    testCatPrintf();
+    testFailures();
+
+    StrSafeSetAllocator(NULL);
+
+    return 0;
+}
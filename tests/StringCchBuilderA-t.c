@@ -0,0 +1,183 @@
+#include <string.h>
+#include <strsafe.h>
+#include "tap/basic.h"
+
+void testAppend(){
+    char dest[11];
+    STRSAFE_BUILDER_A builder;
+    size_t length;
+
+    diag("Test building strings.");
+
+    ok(SUCCEEDED(StringCchBuilderInitA(&builder, dest, 11, 0)),
+            "Initialize a builder.");
+    is_string("", dest,
+            "Result of initializing a builder.");
+    ok(SUCCEEDED(StringCchBuilderAppendA(&builder, "ab")) &&
+            SUCCEEDED(StringCchBuilderAppendNA(&builder, "cdef", 2)) &&
+            SUCCEEDED(StringCchBuilderAppendCharA(&builder, 'e')) &&
+            SUCCEEDED(StringCchBuilderPrintfA(&builder, "%d-%s", 1, "x")),
+            "Append pieces of all kinds.");
+    is_string("abcde1-x", dest,
+            "Result of appending pieces of all kinds.");
+    ok(builder.pszEnd == &dest[8] && builder.cchRemaining == 3,
+            "End of the string after appending pieces.");
+    ok(SUCCEEDED(StringCchBuilderAppendA(&builder, "")),
+            "Append an empty string.");
+    ok(SUCCEEDED(StringCchBuilderAppendCharA(&builder, '\0')),
+            "Append a null character.");
+    ok(SUCCEEDED(StringCchBuilderAppendA(&builder, "yz")),
+            "Append a string that just fits.");
+    ok(SUCCEEDED(StringCchBuilderFinishA(&builder, &length)),
+            "Finish a string that fits.");
+    is_int(10, length,
+            "Length of a string that fits.");
+    is_string("abcde1-xyz", dest,
+            "Result of building a string that fits.");
+}
+
+void testTruncation(){
+    char dest[11];
+    STRSAFE_BUILDER_A builder;
+    size_t length;
+
+    diag("Test building strings that do not fit.");
+
+    StringCchBuilderInitA(&builder, dest, 11, 0);
+    StringCchBuilderAppendA(&builder, "test");
+    ok(StringCchBuilderAppendA(&builder, "too long") ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Append a string that does not fit.");
+    is_string("testtoo lo", dest,
+            "Result of appending a string that does not fit.");
+    ok(StringCchBuilderAppendCharA(&builder, 'x') ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Append a character to a full buffer.");
+    ok(SUCCEEDED(StringCchBuilderAppendA(&builder, "")),
+            "Append an empty string to a full buffer.");
+    ok(StringCchBuilderFinishA(&builder, &length) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Finish a truncated string.");
+    is_int(10, length,
+            "Length of a truncated string.");
+
+    StringCchBuilderInitA(&builder, dest, 11, 0);
+    ok(StringCchBuilderPrintfA(&builder, "%d-%s", 12345, "abcdef") ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Print a string that does not fit.");
+    is_string("12345-abcd", dest,
+            "Result of printing a string that does not fit.");
+
+    StringCchBuilderInitA(&builder, dest, 11, STRSAFE_NO_TRUNCATION);
+    StringCchBuilderAppendA(&builder, "test");
+    ok(StringCchBuilderAppendA(&builder, "too long") ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Append a string that does not fit without truncation.");
+    ok(StringCchBuilderPrintfA(&builder, "%d-%s", 12345, "ab") ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Print a string that does not fit without truncation.");
+    is_string("test", dest,
+            "Result of appending strings that do not fit "
+            "without truncation.");
+    ok(SUCCEEDED(StringCchBuilderAppendA(&builder, "short")),
+            "Append a string that fits after one that did not.");
+    ok(StringCchBuilderFinishA(&builder, &length) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Finish a string where some pieces did not fit.");
+    is_int(9, length,
+            "Length of a string where some pieces did not fit.");
+    is_string("testshort", dest,
+            "Result of a string where some pieces did not fit.");
+}
+
+void testFlags(){
+    char dest[11];
+    char wanted[11];
+    STRSAFE_BUILDER_A builder;
+    size_t length;
+
+    diag("Test building strings with flags.");
+
+    StringCchBuilderInitA(&builder, dest, 11, STRSAFE_NULL_ON_FAILURE);
+    StringCchBuilderAppendA(&builder, "test");
+    ok(StringCchBuilderAppendA(&builder, "too long") ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Append a string that does not fit with STRSAFE_NULL_ON_FAILURE.");
+    is_string("", dest,
+            "Result of a failure with STRSAFE_NULL_ON_FAILURE.");
+    ok(StringCchBuilderAppendA(&builder, "more") ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Append after a failure with STRSAFE_NULL_ON_FAILURE.");
+    is_string("", dest,
+            "Result of appending after a failure "
+            "with STRSAFE_NULL_ON_FAILURE.");
+
+    StringCchBuilderInitA(&builder, dest, 11,
+            STRSAFE_FILL_ON_FAILURE | '@');
+    StringCchBuilderAppendA(&builder, "test");
+    ok(StringCchBuilderAppendNA(&builder, "too long", 7) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Append a string that does not fit with STRSAFE_FILL_ON_FAILURE.");
+    ok(StringCchBuilderFinishA(&builder, &length) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Finish a string that failed with STRSAFE_FILL_ON_FAILURE.");
+    is_int(10, length,
+            "Length of a string that failed with STRSAFE_FILL_ON_FAILURE.");
+    memset(wanted, '@', 10 * sizeof(char));
+    wanted[10] = '\0';
+    is_string(wanted, dest,
+            "Result of a failure with STRSAFE_FILL_ON_FAILURE.");
+
+    StringCchBuilderInitA(&builder, dest, 11, STRSAFE_FILL_BEHIND_NULL | '@');
+    StringCchBuilderAppendA(&builder, "test");
+    ok(SUCCEEDED(StringCchBuilderFinishA(&builder, &length)),
+            "Finish a string with STRSAFE_FILL_BEHIND_NULL.");
+    is_string("test", dest,
+            "Result of finishing a string with STRSAFE_FILL_BEHIND_NULL.");
+    ok(memcmp(dest + 5, wanted, 6 * sizeof(char)) == 0,
+            "Buffer filled behind the string with STRSAFE_FILL_BEHIND_NULL.");
+
+    StringCchBuilderInitA(&builder, dest, 11, STRSAFE_IGNORE_NULLS);
+    ok(SUCCEEDED(StringCchBuilderAppendA(&builder, NULL)) &&
+            SUCCEEDED(StringCchBuilderPrintfA(&builder, NULL)),
+            "Append NULL with STRSAFE_IGNORE_NULLS.");
+    is_string("", dest,
+            "Result of appending NULL with STRSAFE_IGNORE_NULLS.");
+}
+
+void testInvalid(){
+    char dest[11];
+    STRSAFE_BUILDER_A builder;
+    size_t length = 1;
+
+    diag("Test builders with invalid parameters.");
+
+    ok(StringCchBuilderInitA(NULL, dest, 11, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Initialize no builder.");
+    ok(StringCchBuilderInitA(&builder, dest, 0, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Initialize a builder with cchDest set to zero.");
+    ok(StringCchBuilderAppendA(&builder, "test") ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Append to a builder that failed to initialize.");
+    ok(StringCchBuilderFinishA(&builder, &length) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Finish a builder that failed to initialize.");
+    is_int(0, length,
+            "Length of a builder that failed to initialize.");
+    ok(StringCchBuilderInitA(&builder, NULL, 11, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Initialize a builder without a buffer.");
+}
+
+int main(void){
+    plan(11 + 15 + 13 + 6);
+
+    testAppend();
+    testTruncation();
+    testFlags();
+    testInvalid();
+
+    return 0;
+}
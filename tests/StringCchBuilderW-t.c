@@ -0,0 +1,186 @@
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#define STRSAFE_NO_DEPRECATE
+#include <strsafe.h>
+#include "tap/wide.h"
+
+void testAppend(){
+    wchar_t dest[11];
+    STRSAFE_BUILDER_W builder;
+    size_t length;
+
+    diag("Test building strings.");
+
+    ok(SUCCEEDED(StringCchBuilderInitW(&builder, dest, 11, 0)),
+            "Initialize a builder.");
+    is_wstring(L"", dest,
+            "Result of initializing a builder.");
+    ok(SUCCEEDED(StringCchBuilderAppendW(&builder, L"ab")) &&
+            SUCCEEDED(StringCchBuilderAppendNW(&builder, L"cdef", 2)) &&
+            SUCCEEDED(StringCchBuilderAppendCharW(&builder, L'e')) &&
+            SUCCEEDED(StringCchBuilderPrintfW(&builder, L"%d-%ls", 1, L"x")),
+            "Append pieces of all kinds.");
+    is_wstring(L"abcde1-x", dest,
+            "Result of appending pieces of all kinds.");
+    ok(builder.pszEnd == &dest[8] && builder.cchRemaining == 3,
+            "End of the string after appending pieces.");
+    ok(SUCCEEDED(StringCchBuilderAppendW(&builder, L"")),
+            "Append an empty string.");
+    ok(SUCCEEDED(StringCchBuilderAppendCharW(&builder, L'\0')),
+            "Append a null character.");
+    ok(SUCCEEDED(StringCchBuilderAppendW(&builder, L"yz")),
+            "Append a string that just fits.");
+    ok(SUCCEEDED(StringCchBuilderFinishW(&builder, &length)),
+            "Finish a string that fits.");
+    is_int(10, length,
+            "Length of a string that fits.");
+    is_wstring(L"abcde1-xyz", dest,
+            "Result of building a string that fits.");
+}
+
+void testTruncation(){
+    wchar_t dest[11];
+    STRSAFE_BUILDER_W builder;
+    size_t length;
+
+    diag("Test building strings that do not fit.");
+
+    StringCchBuilderInitW(&builder, dest, 11, 0);
+    StringCchBuilderAppendW(&builder, L"test");
+    ok(StringCchBuilderAppendW(&builder, L"too long") ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Append a string that does not fit.");
+    is_wstring(L"testtoo lo", dest,
+            "Result of appending a string that does not fit.");
+    ok(StringCchBuilderAppendCharW(&builder, L'x') ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Append a character to a full buffer.");
+    ok(SUCCEEDED(StringCchBuilderAppendW(&builder, L"")),
+            "Append an empty string to a full buffer.");
+    ok(StringCchBuilderFinishW(&builder, &length) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Finish a truncated string.");
+    is_int(10, length,
+            "Length of a truncated string.");
+
+    StringCchBuilderInitW(&builder, dest, 11, 0);
+    ok(StringCchBuilderPrintfW(&builder, L"%d-%ls", 12345, L"abcdef") ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Print a string that does not fit.");
+    is_wstring(L"12345-abcd", dest,
+            "Result of printing a string that does not fit.");
+
+    StringCchBuilderInitW(&builder, dest, 11, STRSAFE_NO_TRUNCATION);
+    StringCchBuilderAppendW(&builder, L"test");
+    ok(StringCchBuilderAppendW(&builder, L"too long") ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Append a string that does not fit without truncation.");
+    ok(StringCchBuilderPrintfW(&builder, L"%d-%ls", 12345, L"ab") ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Print a string that does not fit without truncation.");
+    is_wstring(L"test", dest,
+            "Result of appending strings that do not fit "
+            "without truncation.");
+    ok(SUCCEEDED(StringCchBuilderAppendW(&builder, L"short")),
+            "Append a string that fits after one that did not.");
+    ok(StringCchBuilderFinishW(&builder, &length) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Finish a string where some pieces did not fit.");
+    is_int(9, length,
+            "Length of a string where some pieces did not fit.");
+    is_wstring(L"testshort", dest,
+            "Result of a string where some pieces did not fit.");
+}
+
+void testFlags(){
+    wchar_t dest[11];
+    wchar_t wanted[11];
+    STRSAFE_BUILDER_W builder;
+    size_t length;
+
+    diag("Test building strings with flags.");
+
+    StringCchBuilderInitW(&builder, dest, 11, STRSAFE_NULL_ON_FAILURE);
+    StringCchBuilderAppendW(&builder, L"test");
+    ok(StringCchBuilderAppendW(&builder, L"too long") ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Append a string that does not fit with STRSAFE_NULL_ON_FAILURE.");
+    is_wstring(L"", dest,
+            "Result of a failure with STRSAFE_NULL_ON_FAILURE.");
+    ok(StringCchBuilderAppendW(&builder, L"more") ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Append after a failure with STRSAFE_NULL_ON_FAILURE.");
+    is_wstring(L"", dest,
+            "Result of appending after a failure "
+            "with STRSAFE_NULL_ON_FAILURE.");
+
+    StringCchBuilderInitW(&builder, dest, 11,
+            STRSAFE_FILL_ON_FAILURE | '@');
+    StringCchBuilderAppendW(&builder, L"test");
+    ok(StringCchBuilderAppendNW(&builder, L"too long", 7) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Append a string that does not fit with STRSAFE_FILL_ON_FAILURE.");
+    ok(StringCchBuilderFinishW(&builder, &length) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Finish a string that failed with STRSAFE_FILL_ON_FAILURE.");
+    is_int(10, length,
+            "Length of a string that failed with STRSAFE_FILL_ON_FAILURE.");
+    memset(wanted, '@', 10 * sizeof(wchar_t));
+    wanted[10] = L'\0';
+    is_wstring(wanted, dest,
+            "Result of a failure with STRSAFE_FILL_ON_FAILURE.");
+
+    StringCchBuilderInitW(&builder, dest, 11, STRSAFE_FILL_BEHIND_NULL | '@');
+    StringCchBuilderAppendW(&builder, L"test");
+    ok(SUCCEEDED(StringCchBuilderFinishW(&builder, &length)),
+            "Finish a string with STRSAFE_FILL_BEHIND_NULL.");
+    is_wstring(L"test", dest,
+            "Result of finishing a string with STRSAFE_FILL_BEHIND_NULL.");
+    ok(memcmp(dest + 5, wanted, 6 * sizeof(wchar_t)) == 0,
+            "Buffer filled behind the string with STRSAFE_FILL_BEHIND_NULL.");
+
+    StringCchBuilderInitW(&builder, dest, 11, STRSAFE_IGNORE_NULLS);
+    ok(SUCCEEDED(StringCchBuilderAppendW(&builder, NULL)) &&
+            SUCCEEDED(StringCchBuilderPrintfW(&builder, NULL)),
+            "Append NULL with STRSAFE_IGNORE_NULLS.");
+    is_wstring(L"", dest,
+            "Result of appending NULL with STRSAFE_IGNORE_NULLS.");
+}
+
+void testInvalid(){
+    wchar_t dest[11];
+    STRSAFE_BUILDER_W builder;
+    size_t length = 1;
+
+    diag("Test builders with invalid parameters.");
+
+    ok(StringCchBuilderInitW(NULL, dest, 11, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Initialize no builder.");
+    ok(StringCchBuilderInitW(&builder, dest, 0, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Initialize a builder with cchDest set to zero.");
+    ok(StringCchBuilderAppendW(&builder, L"test") ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Append to a builder that failed to initialize.");
+    ok(StringCchBuilderFinishW(&builder, &length) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Finish a builder that failed to initialize.");
+    is_int(0, length,
+            "Length of a builder that failed to initialize.");
+    ok(StringCchBuilderInitW(&builder, NULL, 11, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Initialize a builder without a buffer.");
+}
+
+int main(void){
+    plan(11 + 15 + 13 + 6);
+
+    testAppend();
+    testTruncation();
+    testFlags();
+    testInvalid();
+
+    return 0;
+}
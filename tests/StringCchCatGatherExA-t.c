@@ -0,0 +1,118 @@
+#include <string.h>
+#include <strsafe.h>
+#include "tap/basic.h"
+
+void testSegments(){
+    char dest[11];
+    char * destEnd;
+    size_t remaining;
+    /* The lengths stop short of the null terminations to show that the
+     * segments are not scanned. */
+    STRSAFE_SEGMENT_A segments[] = {
+        {"abX", 2},
+        {NULL, 0},
+        {"cdX", 0},
+        {"cdeX", 3}
+    };
+
+    diag("Test concatenating segments.");
+
+    strcpy(dest, "foo");
+    ok(SUCCEEDED(StringCchCatGatherExA(dest, 11, segments, 4, &destEnd,
+                    &remaining, 0)),
+            "Gather segments.");
+    is_string("fooabcde", dest,
+            "Result of gathering segments.");
+    ok(destEnd == &dest[8] && remaining == 3,
+            "End of the result of gathering segments.");
+
+    strcpy(dest, "foo");
+    ok(SUCCEEDED(StringCchCatGatherExA(dest, 11, NULL, 0, &destEnd,
+                    &remaining, 0)),
+            "Gather no segments.");
+    is_string("foo", dest,
+            "Result of gathering no segments.");
+    ok(destEnd == &dest[3] && remaining == 8,
+            "End of the result of gathering no segments.");
+}
+
+void testTruncation(){
+    char dest[11];
+    char wanted[11];
+    char * destEnd;
+    size_t remaining;
+    STRSAFE_SEGMENT_A segments[] = {
+        {"0123", 4},
+        {"45678", 5}
+    };
+    STRSAFE_SEGMENT_A nullSegments[] = {
+        {"ab", 2},
+        {NULL, 5}
+    };
+
+    diag("Test gathering segments that do not fit.");
+
+    strcpy(dest, "foo");
+    ok(StringCchCatGatherExA(dest, 12, segments, 2, &destEnd, &remaining, 0) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Gather segments that do not fit.");
+    is_string("foo01234567", dest,
+            "Result of gathering segments that do not fit.");
+    ok(destEnd == &dest[11] && remaining == 1,
+            "End of the result of gathering segments that do not fit.");
+
+    strcpy(dest, "foo");
+    ok(StringCchCatGatherExA(dest, 12, segments, 2, NULL, NULL,
+                    STRSAFE_NO_TRUNCATION) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Gather segments that do not fit without truncation.");
+    is_string("foo", dest,
+            "Result of gathering segments that do not fit "
+            "without truncation.");
+
+    strcpy(dest, "foo");
+    ok(StringCchCatGatherExA(dest, 12, segments, 2, NULL, NULL,
+                    STRSAFE_NULL_ON_FAILURE) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Gather segments that do not fit with STRSAFE_NULL_ON_FAILURE.");
+    is_string("", dest,
+            "Result of a failure with STRSAFE_NULL_ON_FAILURE.");
+
+    strcpy(dest, "foo");
+    ok(StringCchCatGatherExA(dest, 11, segments, 2, NULL, NULL,
+                    STRSAFE_FILL_ON_FAILURE | '@') ==
+                    STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Gather segments with STRSAFE_FILL_ON_FAILURE.");
+    memset(wanted, '@', 10 * sizeof(char));
+    wanted[10] = '\0';
+    is_string(wanted, dest,
+            "Result of gathering segments with STRSAFE_FILL_ON_FAILURE.");
+
+    strcpy(dest, "foo");
+    ok(SUCCEEDED(StringCchCatGatherExA(dest, 11, nullSegments, 1, NULL, NULL,
+                    STRSAFE_FILL_BEHIND_NULL | '@')),
+            "Gather segments with STRSAFE_FILL_BEHIND_NULL.");
+    ok(memcmp(dest + 6, wanted, 5 * sizeof(char)) == 0,
+            "Buffer filled behind the result with STRSAFE_FILL_BEHIND_NULL.");
+
+    strcpy(dest, "foo");
+    ok(StringCchCatGatherExA(dest, 11, nullSegments, 2, NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Gather a NULL segment.");
+    strcpy(dest, "foo");
+    ok(SUCCEEDED(StringCchCatGatherExA(dest, 11, nullSegments, 2, NULL, NULL,
+                    STRSAFE_IGNORE_NULLS)),
+            "Gather a NULL segment with STRSAFE_IGNORE_NULLS.");
+    is_string("fooab", dest,
+            "Result of gathering a NULL segment with STRSAFE_IGNORE_NULLS.");
+    ok(StringCchCatGatherExA(dest, 0, segments, 2, NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Gather segments with cchDest set to zero.");
+}
+
+int main(void){
+    plan(6 + 15);
+
+    testSegments();
+    testTruncation();
+
+    return 0;
+}
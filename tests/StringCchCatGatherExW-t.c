@@ -0,0 +1,121 @@
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#define STRSAFE_NO_DEPRECATE
+#include <strsafe.h>
+#include "tap/wide.h"
+
+void testSegments(){
+    wchar_t dest[11];
+    wchar_t * destEnd;
+    size_t remaining;
+    /* The lengths stop short of the null terminations to show that the
+     * segments are not scanned. */
+    STRSAFE_SEGMENT_W segments[] = {
+        {L"abX", 2},
+        {NULL, 0},
+        {L"cdX", 0},
+        {L"cdeX", 3}
+    };
+
+    diag("Test concatenating segments.");
+
+    wcscpy(dest, L"foo");
+    ok(SUCCEEDED(StringCchCatGatherExW(dest, 11, segments, 4, &destEnd,
+                    &remaining, 0)),
+            "Gather segments.");
+    is_wstring(L"fooabcde", dest,
+            "Result of gathering segments.");
+    ok(destEnd == &dest[8] && remaining == 3,
+            "End of the result of gathering segments.");
+
+    wcscpy(dest, L"foo");
+    ok(SUCCEEDED(StringCchCatGatherExW(dest, 11, NULL, 0, &destEnd,
+                    &remaining, 0)),
+            "Gather no segments.");
+    is_wstring(L"foo", dest,
+            "Result of gathering no segments.");
+    ok(destEnd == &dest[3] && remaining == 8,
+            "End of the result of gathering no segments.");
+}
+
+void testTruncation(){
+    wchar_t dest[11];
+    wchar_t wanted[11];
+    wchar_t * destEnd;
+    size_t remaining;
+    STRSAFE_SEGMENT_W segments[] = {
+        {L"0123", 4},
+        {L"45678", 5}
+    };
+    STRSAFE_SEGMENT_W nullSegments[] = {
+        {L"ab", 2},
+        {NULL, 5}
+    };
+
+    diag("Test gathering segments that do not fit.");
+
+    wcscpy(dest, L"foo");
+    ok(StringCchCatGatherExW(dest, 12, segments, 2, &destEnd, &remaining, 0) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Gather segments that do not fit.");
+    is_wstring(L"foo01234567", dest,
+            "Result of gathering segments that do not fit.");
+    ok(destEnd == &dest[11] && remaining == 1,
+            "End of the result of gathering segments that do not fit.");
+
+    wcscpy(dest, L"foo");
+    ok(StringCchCatGatherExW(dest, 12, segments, 2, NULL, NULL,
+                    STRSAFE_NO_TRUNCATION) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Gather segments that do not fit without truncation.");
+    is_wstring(L"foo", dest,
+            "Result of gathering segments that do not fit "
+            "without truncation.");
+
+    wcscpy(dest, L"foo");
+    ok(StringCchCatGatherExW(dest, 12, segments, 2, NULL, NULL,
+                    STRSAFE_NULL_ON_FAILURE) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Gather segments that do not fit with STRSAFE_NULL_ON_FAILURE.");
+    is_wstring(L"", dest,
+            "Result of a failure with STRSAFE_NULL_ON_FAILURE.");
+
+    wcscpy(dest, L"foo");
+    ok(StringCchCatGatherExW(dest, 11, segments, 2, NULL, NULL,
+                    STRSAFE_FILL_ON_FAILURE | '@') ==
+                    STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Gather segments with STRSAFE_FILL_ON_FAILURE.");
+    memset(wanted, '@', 10 * sizeof(wchar_t));
+    wanted[10] = L'\0';
+    is_wstring(wanted, dest,
+            "Result of gathering segments with STRSAFE_FILL_ON_FAILURE.");
+
+    wcscpy(dest, L"foo");
+    ok(SUCCEEDED(StringCchCatGatherExW(dest, 11, nullSegments, 1, NULL, NULL,
+                    STRSAFE_FILL_BEHIND_NULL | '@')),
+            "Gather segments with STRSAFE_FILL_BEHIND_NULL.");
+    ok(memcmp(dest + 6, wanted, 5 * sizeof(wchar_t)) == 0,
+            "Buffer filled behind the result with STRSAFE_FILL_BEHIND_NULL.");
+
+    wcscpy(dest, L"foo");
+    ok(StringCchCatGatherExW(dest, 11, nullSegments, 2, NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Gather a NULL segment.");
+    wcscpy(dest, L"foo");
+    ok(SUCCEEDED(StringCchCatGatherExW(dest, 11, nullSegments, 2, NULL, NULL,
+                    STRSAFE_IGNORE_NULLS)),
+            "Gather a NULL segment with STRSAFE_IGNORE_NULLS.");
+    is_wstring(L"fooab", dest,
+            "Result of gathering a NULL segment with STRSAFE_IGNORE_NULLS.");
+    ok(StringCchCatGatherExW(dest, 0, segments, 2, NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Gather segments with cchDest set to zero.");
+}
+
+int main(void){
+    plan(6 + 15);
+
+    testSegments();
+    testTruncation();
+
+    return 0;
+}
@@ -0,0 +1,210 @@
+#include <string.h>
+#include <strsafe.h>
+#include "tap/basic.h"
+
+void testConcatenation(){
+    char dest[11];
+    char * destEnd;
+    size_t remaining;
+    LPCSTR sources[] = {"ab", "", "cde", "f"};
+
+    diag("Test concatenating several strings.");
+
+    dest[0] = '\0';
+    ok(SUCCEEDED(StringCchCatMultiExA(dest, 11, sources, 4, &destEnd,
+                    &remaining, 0)),
+            "Concatenate an array of strings.");
+    is_string("abcdef", dest,
+            "Result of concatenating an array of strings.");
+    ok(destEnd == &dest[6] && remaining == 5,
+            "End of the result of concatenating an array of strings.");
+
+    strcpy(dest, "foo");
+    ok(SUCCEEDED(StringCchCatMultiListExA(dest, 11, &destEnd, &remaining,
+                    0, "ba", "r", "", "baz", NULL)),
+            "Concatenate a list of strings.");
+    is_string("foobarbaz", dest,
+            "Result of concatenating a list of strings.");
+    ok(destEnd == &dest[9] && remaining == 2,
+            "End of the result of concatenating a list of strings.");
+
+    ok(SUCCEEDED(StringCchCatMultiExA(dest, 11, NULL, 0, &destEnd,
+                    &remaining, 0)),
+            "Concatenate no strings.");
+    is_string("foobarbaz", dest,
+            "Result of concatenating no strings.");
+    ok(SUCCEEDED(StringCchCatMultiListExA(dest, 11, NULL, NULL, 0,
+                    "x", NULL)),
+            "Concatenate a string that just fits.");
+    is_string("foobarbazx", dest,
+            "Result of concatenating a string that just fits.");
+}
+
+void testTruncation(){
+    char dest[11];
+    char * destEnd;
+    size_t remaining;
+    LPCSTR sources[] = {"one", "two", "three"};
+
+    diag("Test concatenating strings that do not fit.");
+
+    strcpy(dest, "0");
+    ok(StringCchCatMultiExA(dest, 11, sources, 3, &destEnd, &remaining,
+                    0) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Concatenate strings that do not fit.");
+    is_string("0onetwothr", dest,
+            "Result of concatenating strings that do not fit.");
+    ok(destEnd == &dest[10] && remaining == 1,
+            "End of the result of concatenating strings that do not fit.");
+
+    strcpy(dest, "0");
+    dest[5] = '#';
+    ok(StringCchCatMultiExA(dest, 11, sources, 3, NULL, NULL,
+                    STRSAFE_NO_TRUNCATION) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Concatenate strings that do not fit without truncation.");
+    is_string("0", dest,
+            "Result of concatenating strings that do not fit "
+            "without truncation.");
+    ok(dest[5] == '#',
+            "Buffer untouched after concatenating strings that do not fit "
+            "without truncation.");
+
+    ok(StringCchCatMultiListExA(dest, 11, NULL, NULL,
+                    STRSAFE_NULL_ON_FAILURE, "0123456789", NULL) ==
+                    STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Concatenate strings that do not fit with "
+            "STRSAFE_NULL_ON_FAILURE.");
+    is_string("", dest,
+            "Result of a failure with STRSAFE_NULL_ON_FAILURE.");
+}
+
+void testFlags(){
+    char dest[11];
+    char wanted[11];
+    LPCSTR sources[] = {"ab", NULL, "cd"};
+
+    diag("Test concatenating strings with flags.");
+
+    dest[0] = '\0';
+    ok(StringCchCatMultiExA(dest, 11, sources, 3, NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Concatenate an array with a NULL element.");
+    ok(SUCCEEDED(StringCchCatMultiExA(dest, 11, sources, 3, NULL, NULL,
+                    STRSAFE_IGNORE_NULLS)),
+            "Concatenate an array with a NULL element "
+            "with STRSAFE_IGNORE_NULLS.");
+    is_string("abcd", dest,
+            "Result of concatenating an array with a NULL element.");
+
+    ok(StringCchCatMultiListExA(dest, 11, NULL, NULL,
+                    STRSAFE_FILL_ON_FAILURE | '@', "efg",
+                    "hijk", NULL) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Concatenate strings that do not fit with "
+            "STRSAFE_FILL_ON_FAILURE.");
+    memset(wanted, '@', 10 * sizeof(char));
+    wanted[10] = '\0';
+    is_string(wanted, dest,
+            "Result of a failure with STRSAFE_FILL_ON_FAILURE.");
+
+    dest[0] = '\0';
+    ok(SUCCEEDED(StringCchCatMultiListExA(dest, 11, NULL, NULL,
+                    STRSAFE_FILL_BEHIND_NULL | '@', "ef", "g",
+                    NULL)),
+            "Concatenate strings with STRSAFE_FILL_BEHIND_NULL.");
+    is_string("efg", dest,
+            "Result of concatenating strings with STRSAFE_FILL_BEHIND_NULL.");
+    ok(memcmp(dest + 4, wanted, 7 * sizeof(char)) == 0,
+            "Buffer filled behind the result with STRSAFE_FILL_BEHIND_NULL.");
+
+    memset(dest, 'x', sizeof(dest));
+    ok(StringCchCatMultiListExA(dest, 11, NULL, NULL, 0, "a",
+                    NULL) == STRSAFE_E_INVALID_PARAMETER,
+            "Concatenate to a buffer that is not null terminated.");
+    ok(StringCchCatMultiListExA(dest, 0, NULL, NULL, 0, "a",
+                    NULL) == STRSAFE_E_INVALID_PARAMETER,
+            "Concatenate with cchDest set to zero.");
+}
+
+/*
+ * Compares the results with those of concatenating the same strings one
+ * at a time with StringCchCatExA, for strings of many lengths that
+ * start and end anywhere within a vector.
+ */
+void testCompare(){
+    char source[80];
+    char dest[100];
+    char expected[100];
+    size_t split;
+    DWORD flags[] = {0, STRSAFE_NO_TRUNCATION};
+    size_t i;
+
+    diag("Compare with concatenating one string at a time.");
+
+    for(i = 0; i < 2; i++){
+        int correct = 1;
+        for(split = 0; split < 70; split++){
+            size_t prefix;
+            for(prefix = 0; prefix < 40; prefix += 3){
+                size_t cchDest;
+                for(cchDest = prefix + 1; cchDest < 100; cchDest += 5){
+                    LPCSTR sources[3] = {
+                        source, source + split + 1, source + 70
+                    };
+                    HRESULT result;
+                    HRESULT wantedResult;
+                    size_t j;
+
+                    for(j = 0; j < 79; j++){
+                        source[j] = (char)('a' + j % 26);
+                    }
+                    source[79] = '\0';
+                    source[split] = '\0';
+
+                    for(j = 0; j < 100; j++){
+                        dest[j] = expected[j] = '#';
+                    }
+                    for(j = 0; j < prefix; j++){
+                        dest[j] = expected[j] = 'p';
+                    }
+                    dest[prefix] = expected[prefix] = '\0';
+
+                    wantedResult = StringCchCatExA(expected, cchDest,
+                            sources[0], NULL, NULL, 0);
+                    if(SUCCEEDED(wantedResult)){
+                        wantedResult = StringCchCatExA(expected, cchDest,
+                                sources[1], NULL, NULL, 0);
+                    }
+                    if(SUCCEEDED(wantedResult)){
+                        wantedResult = StringCchCatExA(expected, cchDest,
+                                sources[2], NULL, NULL, 0);
+                    }
+                    if(FAILED(wantedResult) && flags[i] != 0){
+                        /* Nothing should be written. */
+                        for(j = prefix + 1; j < 100; j++){
+                            expected[j] = '#';
+                        }
+                        expected[prefix] = '\0';
+                    }
+
+                    result = StringCchCatMultiExA(dest, cchDest, sources,
+                            3, NULL, NULL, flags[i]);
+                    correct = correct && result == wantedResult &&
+                            memcmp(dest, expected, sizeof(dest)) == 0;
+                }
+            }
+        }
+        ok(correct, "Same results as StringCchCatExA with flags %lu.",
+                (unsigned long)flags[i]);
+    }
+}
+
+int main(void){
+    plan(10 + 8 + 10 + 2);
+
+    testConcatenation();
+    testTruncation();
+    testFlags();
+    testCompare();
+
+    return 0;
+}
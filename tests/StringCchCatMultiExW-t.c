@@ -0,0 +1,213 @@
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#define STRSAFE_NO_DEPRECATE
+#include <strsafe.h>
+#include "tap/wide.h"
+
+void testConcatenation(){
+    wchar_t dest[11];
+    wchar_t * destEnd;
+    size_t remaining;
+    LPCWSTR sources[] = {L"ab", L"", L"cde", L"f"};
+
+    diag("Test concatenating several strings.");
+
+    dest[0] = L'\0';
+    ok(SUCCEEDED(StringCchCatMultiExW(dest, 11, sources, 4, &destEnd,
+                    &remaining, 0)),
+            "Concatenate an array of strings.");
+    is_wstring(L"abcdef", dest,
+            "Result of concatenating an array of strings.");
+    ok(destEnd == &dest[6] && remaining == 5,
+            "End of the result of concatenating an array of strings.");
+
+    wcscpy(dest, L"foo");
+    ok(SUCCEEDED(StringCchCatMultiListExW(dest, 11, &destEnd, &remaining,
+                    0, L"ba", L"r", L"", L"baz", NULL)),
+            "Concatenate a list of strings.");
+    is_wstring(L"foobarbaz", dest,
+            "Result of concatenating a list of strings.");
+    ok(destEnd == &dest[9] && remaining == 2,
+            "End of the result of concatenating a list of strings.");
+
+    ok(SUCCEEDED(StringCchCatMultiExW(dest, 11, NULL, 0, &destEnd,
+                    &remaining, 0)),
+            "Concatenate no strings.");
+    is_wstring(L"foobarbaz", dest,
+            "Result of concatenating no strings.");
+    ok(SUCCEEDED(StringCchCatMultiListExW(dest, 11, NULL, NULL, 0,
+                    L"x", NULL)),
+            "Concatenate a string that just fits.");
+    is_wstring(L"foobarbazx", dest,
+            "Result of concatenating a string that just fits.");
+}
+
+void testTruncation(){
+    wchar_t dest[11];
+    wchar_t * destEnd;
+    size_t remaining;
+    LPCWSTR sources[] = {L"one", L"two", L"three"};
+
+    diag("Test concatenating strings that do not fit.");
+
+    wcscpy(dest, L"0");
+    ok(StringCchCatMultiExW(dest, 11, sources, 3, &destEnd, &remaining,
+                    0) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Concatenate strings that do not fit.");
+    is_wstring(L"0onetwothr", dest,
+            "Result of concatenating strings that do not fit.");
+    ok(destEnd == &dest[10] && remaining == 1,
+            "End of the result of concatenating strings that do not fit.");
+
+    wcscpy(dest, L"0");
+    dest[5] = L'#';
+    ok(StringCchCatMultiExW(dest, 11, sources, 3, NULL, NULL,
+                    STRSAFE_NO_TRUNCATION) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Concatenate strings that do not fit without truncation.");
+    is_wstring(L"0", dest,
+            "Result of concatenating strings that do not fit "
+            "without truncation.");
+    ok(dest[5] == L'#',
+            "Buffer untouched after concatenating strings that do not fit "
+            "without truncation.");
+
+    ok(StringCchCatMultiListExW(dest, 11, NULL, NULL,
+                    STRSAFE_NULL_ON_FAILURE, L"0123456789", NULL) ==
+                    STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Concatenate strings that do not fit with "
+            "STRSAFE_NULL_ON_FAILURE.");
+    is_wstring(L"", dest,
+            "Result of a failure with STRSAFE_NULL_ON_FAILURE.");
+}
+
+void testFlags(){
+    wchar_t dest[11];
+    wchar_t wanted[11];
+    LPCWSTR sources[] = {L"ab", NULL, L"cd"};
+
+    diag("Test concatenating strings with flags.");
+
+    dest[0] = L'\0';
+    ok(StringCchCatMultiExW(dest, 11, sources, 3, NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Concatenate an array with a NULL element.");
+    ok(SUCCEEDED(StringCchCatMultiExW(dest, 11, sources, 3, NULL, NULL,
+                    STRSAFE_IGNORE_NULLS)),
+            "Concatenate an array with a NULL element "
+            "with STRSAFE_IGNORE_NULLS.");
+    is_wstring(L"abcd", dest,
+            "Result of concatenating an array with a NULL element.");
+
+    ok(StringCchCatMultiListExW(dest, 11, NULL, NULL,
+                    STRSAFE_FILL_ON_FAILURE | '@', L"efg",
+                    L"hijk", NULL) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Concatenate strings that do not fit with "
+            "STRSAFE_FILL_ON_FAILURE.");
+    memset(wanted, '@', 10 * sizeof(wchar_t));
+    wanted[10] = L'\0';
+    is_wstring(wanted, dest,
+            "Result of a failure with STRSAFE_FILL_ON_FAILURE.");
+
+    dest[0] = L'\0';
+    ok(SUCCEEDED(StringCchCatMultiListExW(dest, 11, NULL, NULL,
+                    STRSAFE_FILL_BEHIND_NULL | '@', L"ef", L"g",
+                    NULL)),
+            "Concatenate strings with STRSAFE_FILL_BEHIND_NULL.");
+    is_wstring(L"efg", dest,
+            "Result of concatenating strings with STRSAFE_FILL_BEHIND_NULL.");
+    ok(memcmp(dest + 4, wanted, 7 * sizeof(wchar_t)) == 0,
+            "Buffer filled behind the result with STRSAFE_FILL_BEHIND_NULL.");
+
+    memset(dest, 'x', sizeof(dest));
+    ok(StringCchCatMultiListExW(dest, 11, NULL, NULL, 0, L"a",
+                    NULL) == STRSAFE_E_INVALID_PARAMETER,
+            "Concatenate to a buffer that is not null terminated.");
+    ok(StringCchCatMultiListExW(dest, 0, NULL, NULL, 0, L"a",
+                    NULL) == STRSAFE_E_INVALID_PARAMETER,
+            "Concatenate with cchDest set to zero.");
+}
+
+/*
+ * Compares the results with those of concatenating the same strings one
+ * at a time with StringCchCatExW, for strings of many lengths that
+ * start and end anywhere within a vector.
+ */
+void testCompare(){
+    wchar_t source[80];
+    wchar_t dest[100];
+    wchar_t expected[100];
+    size_t split;
+    DWORD flags[] = {0, STRSAFE_NO_TRUNCATION};
+    size_t i;
+
+    diag("Compare with concatenating one string at a time.");
+
+    for(i = 0; i < 2; i++){
+        int correct = 1;
+        for(split = 0; split < 70; split++){
+            size_t prefix;
+            for(prefix = 0; prefix < 40; prefix += 3){
+                size_t cchDest;
+                for(cchDest = prefix + 1; cchDest < 100; cchDest += 5){
+                    LPCWSTR sources[3] = {
+                        source, source + split + 1, source + 70
+                    };
+                    HRESULT result;
+                    HRESULT wantedResult;
+                    size_t j;
+
+                    for(j = 0; j < 79; j++){
+                        source[j] = (wchar_t)('a' + j % 26);
+                    }
+                    source[79] = L'\0';
+                    source[split] = L'\0';
+
+                    for(j = 0; j < 100; j++){
+                        dest[j] = expected[j] = L'#';
+                    }
+                    for(j = 0; j < prefix; j++){
+                        dest[j] = expected[j] = L'p';
+                    }
+                    dest[prefix] = expected[prefix] = L'\0';
+
+                    wantedResult = StringCchCatExW(expected, cchDest,
+                            sources[0], NULL, NULL, 0);
+                    if(SUCCEEDED(wantedResult)){
+                        wantedResult = StringCchCatExW(expected, cchDest,
+                                sources[1], NULL, NULL, 0);
+                    }
+                    if(SUCCEEDED(wantedResult)){
+                        wantedResult = StringCchCatExW(expected, cchDest,
+                                sources[2], NULL, NULL, 0);
+                    }
+                    if(FAILED(wantedResult) && flags[i] != 0){
+                        /* Nothing should be written. */
+                        for(j = prefix + 1; j < 100; j++){
+                            expected[j] = L'#';
+                        }
+                        expected[prefix] = L'\0';
+                    }
+
+                    result = StringCchCatMultiExW(dest, cchDest, sources,
+                            3, NULL, NULL, flags[i]);
+                    correct = correct && result == wantedResult &&
+                            memcmp(dest, expected, sizeof(dest)) == 0;
+                }
+            }
+        }
+        ok(correct, "Same results as StringCchCatExW with flags %lu.",
+                (unsigned long)flags[i]);
+    }
+}
+
+int main(void){
+    plan(10 + 8 + 10 + 2);
+
+    testConcatenation();
+    testTruncation();
+    testFlags();
+    testCompare();
+
+    return 0;
+}
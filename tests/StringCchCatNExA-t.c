@@ -114,6 +114,7 @@ void testRemaining(){
 
 void testFlags(){
     char dest[11];
+    char unterminated[7] = { 'x', 'x', 'x', 'x', 'x', 'x', 'x' };
 
     diag("Test the STRSAFE_IGNORE_NULLS flag.");
 
@@ -161,12 +162,96 @@ void testFlags(){
             "Test copying with truncating disabled.");
     is_string("data", dest,
             "Result after copying with truncating disabled.");
+
+    diag("Test failing early on a source that does not fit.");
+
+    /* unterminated has exactly one character more than fits in dest, so
+     * nothing beyond it may be read. */
+    strcpy(dest, "data");
+    ok(StringCchCatNExA(dest, 11, unterminated, STRSAFE_MAX_CCH, NULL, NULL,
+                    STRSAFE_NO_TRUNCATION) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Test appending an unterminated string with truncating disabled.");
+    is_string("data", dest,
+            "Result after appending an unterminated string "
+            "with truncating disabled.");
+
+    strcpy(dest, "data");
+    ok(StringCchCatNExA(dest, 11, unterminated, STRSAFE_MAX_CCH, NULL, NULL,
+                    STRSAFE_NULL_ON_FAILURE) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Test appending an unterminated string with nulling on failure.");
+    is_string("", dest,
+            "Result after appending an unterminated string "
+            "with nulling on failure.");
+}
+
+/*
+ * Appends strings of different lengths, starting at different alignments,
+ * to destinations with different amounts of space left and compares the
+ * result with the expected result. Characters of pszDest beyond the copied
+ * string must be left untouched.
+ */
+void testAlignment(){
+    char src[224];
+    char dest[200];
+    char expected[200];
+    size_t offset;
+    size_t i;
+
+    diag("Test strings of different lengths at different alignments.");
+
+    for(i = 0; i < sizeof(src) / sizeof(src[0]); i++){
+        src[i] = (char)('a' + i % 26);
+    }
+
+    for(offset = 0; offset < 64; offset++){
+        int correct = 1;
+        size_t srcLength;
+        for(srcLength = 0; srcLength < 140; srcLength++){
+            size_t cchDest;
+            char saved = src[offset + srcLength];
+            src[offset + srcLength] = '\0';
+            for(cchDest = 1; cchDest < 160; cchDest += 13){
+                size_t cchSrc;
+                for(cchSrc = srcLength / 2; cchSrc < srcLength + 3;
+                        cchSrc += srcLength / 4 + 1){
+                    size_t destLength = cchDest / 3;
+                    size_t copyLength = srcLength < cchSrc ? srcLength : cchSrc;
+                    HRESULT wanted = S_OK;
+                    HRESULT result;
+                    char * destEnd = NULL;
+
+                    if(copyLength >= cchDest - destLength){
+                        copyLength = cchDest - destLength - 1;
+                        wanted = STRSAFE_E_INSUFFICIENT_BUFFER;
+                    }
+                    memset(dest, '#', 200);
+                    memset(dest, 'D', destLength);
+                    dest[destLength] = '\0';
+                    memset(expected, '#', 200);
+                    memset(expected, 'D', destLength);
+                    for(i = 0; i < copyLength; i++){
+                        expected[destLength + i] = src[offset + i];
+                    }
+                    expected[destLength + copyLength] = '\0';
+
+                    result = StringCchCatNExA(dest, cchDest, src + offset, cchSrc,
+                            &destEnd, NULL, 0);
+                    correct = correct && result == wanted &&
+                            destEnd == dest + destLength + copyLength &&
+                            memcmp(dest, expected, 200) == 0;
+                }
+            }
+            src[offset + srcLength] = saved;
+        }
+        ok(correct, "Append strings starting at offset %lu.",
+                (unsigned long)offset);
+    }
 }
 
 int main(void){
     char dest[11] = "TEST";
     
-    plan(43);
+    plan(47 + 64);
 
     ok(SUCCEEDED(StringCchCatNExA(dest, 11, "testing", 4, NULL, NULL, 0)),
             "Concatenate short strings without any extended functionality.");
@@ -176,6 +261,7 @@ int main(void){
     testDestEnd();
     testRemaining();
     testFlags();
+    testAlignment();
 
     return 0;
 }
@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include <string.h>
+#include <wchar.h>
 #define STRSAFE_NO_DEPRECATE
 #include <strsafe.h>
 #include "tap/wide.h"
@@ -116,6 +117,9 @@ void testRemaining(){
 
 void testFlags(){
     wchar_t dest[11];
+    wchar_t unterminated[7] = {
+        L'x', L'x', L'x', L'x', L'x', L'x', L'x'
+    };
     wchar_t * wanted;
 
     diag("Test the STRSAFE_IGNORE_NULLS flag.");
@@ -184,12 +188,96 @@ void testFlags(){
             "Test copying with truncating disabled.");
     is_wstring(L"data", dest,
             "Result after copying with truncating disabled.");
+
+    diag("Test failing early on a source that does not fit.");
+
+    /* unterminated has exactly one character more than fits in dest, so
+     * nothing beyond it may be read. */
+    wcscpy(dest, L"data");
+    ok(StringCchCatNExW(dest, 11, unterminated, STRSAFE_MAX_CCH, NULL, NULL,
+                    STRSAFE_NO_TRUNCATION) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Test appending an unterminated string with truncating disabled.");
+    is_wstring(L"data", dest,
+            "Result after appending an unterminated string "
+            "with truncating disabled.");
+
+    wcscpy(dest, L"data");
+    ok(StringCchCatNExW(dest, 11, unterminated, STRSAFE_MAX_CCH, NULL, NULL,
+                    STRSAFE_NULL_ON_FAILURE) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Test appending an unterminated string with nulling on failure.");
+    is_wstring(L"", dest,
+            "Result after appending an unterminated string "
+            "with nulling on failure.");
+}
+
+/*
+ * Appends strings of different lengths, starting at different alignments,
+ * to destinations with different amounts of space left and compares the
+ * result with the expected result. Characters of pszDest beyond the copied
+ * string must be left untouched.
+ */
+void testAlignment(){
+    wchar_t src[176];
+    wchar_t dest[200];
+    wchar_t expected[200];
+    size_t offset;
+    size_t i;
+
+    diag("Test strings of different lengths at different alignments.");
+
+    for(i = 0; i < sizeof(src) / sizeof(src[0]); i++){
+        src[i] = (wchar_t)(L'a' + i % 26);
+    }
+
+    for(offset = 0; offset < 16; offset++){
+        int correct = 1;
+        size_t srcLength;
+        for(srcLength = 0; srcLength < 140; srcLength++){
+            size_t cchDest;
+            wchar_t saved = src[offset + srcLength];
+            src[offset + srcLength] = L'\0';
+            for(cchDest = 1; cchDest < 160; cchDest += 13){
+                size_t cchSrc;
+                for(cchSrc = srcLength / 2; cchSrc < srcLength + 3;
+                        cchSrc += srcLength / 4 + 1){
+                    size_t destLength = cchDest / 3;
+                    size_t copyLength = srcLength < cchSrc ? srcLength : cchSrc;
+                    HRESULT wanted = S_OK;
+                    HRESULT result;
+                    wchar_t * destEnd = NULL;
+
+                    if(copyLength >= cchDest - destLength){
+                        copyLength = cchDest - destLength - 1;
+                        wanted = STRSAFE_E_INSUFFICIENT_BUFFER;
+                    }
+                    wmemset(dest, L'#', 200);
+                    wmemset(dest, L'D', destLength);
+                    dest[destLength] = L'\0';
+                    wmemset(expected, L'#', 200);
+                    wmemset(expected, L'D', destLength);
+                    for(i = 0; i < copyLength; i++){
+                        expected[destLength + i] = src[offset + i];
+                    }
+                    expected[destLength + copyLength] = L'\0';
+
+                    result = StringCchCatNExW(dest, cchDest, src + offset, cchSrc,
+                            &destEnd, NULL, 0);
+                    correct = correct && result == wanted &&
+                            destEnd == dest + destLength + copyLength &&
+                            wmemcmp(dest, expected, 200) == 0;
+                }
+            }
+            src[offset + srcLength] = saved;
+        }
+        ok(correct, "Append strings starting at offset %lu.",
+                (unsigned long)offset);
+    }
 }
 
 int main(void){
     wchar_t dest[11] = L"TEST";
     
-    plan(44);
+    plan(48 + 16);
 
     ok(SUCCEEDED(StringCchCatNExW(dest, 11, L"testing", 4, NULL, NULL, 0)),
             "Concatenate short strings without any extended functionality.");
@@ -199,6 +287,7 @@ int main(void){
     testDestEnd();
     testRemaining();
     testFlags();
+    testAlignment();
 
     return 0;
 }
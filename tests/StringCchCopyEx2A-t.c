@@ -0,0 +1,121 @@
+#include <string.h>
+#include <strsafe.h>
+#include "tap/basic.h"
+
+void testRequired(){
+    char dest[11];
+    char * destEnd;
+    size_t remaining;
+    size_t required;
+
+    diag("Test the required length.");
+
+    strcpy(dest, "foo");
+    required = 0;
+    ok(SUCCEEDED(StringCchCopyEx2A(dest, 11, "test", &destEnd, &remaining, 0,
+                    &required)),
+            "Get the required length of a string that fits.");
+    is_string("test", dest,
+            "Result for a string that fits.");
+    is_int(4, required,
+            "Required length of a string that fits.");
+
+    strcpy(dest, "foo");
+    required = 0;
+    ok(StringCchCopyEx2A(dest, 11, "a much longer string", &destEnd,
+                    &remaining, 0, &required) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Get the required length of a string that does not fit.");
+    is_string("a much lon", dest,
+            "Result for a string that does not fit.");
+    is_int(20, required,
+            "Required length of a string that does not fit.");
+    ok(destEnd == &dest[10] && remaining == 1,
+            "End of the result for a string that does not fit.");
+
+    strcpy(dest, "foo");
+    required = 0;
+    ok(StringCchCopyEx2A(dest, 11, "a much longer string", NULL, NULL,
+                    STRSAFE_NO_TRUNCATION, &required) ==
+                    STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Get the required length without truncation.");
+    is_string("", dest,
+            "Result for a string that does not fit without truncation.");
+    is_int(20, required,
+            "Required length without truncation.");
+
+    strcpy(dest, "foo");
+    required = 0;
+    ok(SUCCEEDED(StringCchCopyEx2A(dest, 11, NULL, NULL, NULL,
+                    STRSAFE_IGNORE_NULLS, &required)),
+            "Get the required length of NULL with STRSAFE_IGNORE_NULLS.");
+    is_int(0, required,
+            "Required length of NULL with STRSAFE_IGNORE_NULLS.");
+
+    strcpy(dest, "foo");
+    ok(StringCchCopyEx2A(dest, 11, NULL, NULL, NULL, STRSAFE_NO_TRUNCATION,
+                    &required) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Get the required length of NULL without truncation.");
+    is_string("", dest,
+            "Result for NULL without truncation.");
+
+    strcpy(dest, "foo");
+    ok(StringCchCopyEx2A(dest, 11, "a much longer string", &destEnd,
+                    &remaining, 0, NULL) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Leave out the required length.");
+    is_string("a much lon", dest,
+            "Result without the required length.");
+}
+
+/*
+ * Compares the results with those of StringCchCopyExA and the required length
+ * with the length of the source, for sources of many lengths that start
+ * anywhere within a vector.
+ */
+void testCompare(){
+    char source[320];
+    char dest[64];
+    char expected[64];
+    size_t offset;
+    int correct = 1;
+
+    diag("Compare with StringCchCopyExA.");
+
+    for(offset = 0; offset < 64; offset++){
+        size_t sourceLength;
+        for(sourceLength = 0; sourceLength < 200; sourceLength += 7){
+            size_t cchDest;
+            size_t i;
+            for(i = 0; i < 320; i++){
+                source[i] = (char)('a' + i % 26);
+            }
+            source[offset + sourceLength] = '\0';
+            for(cchDest = 4; cchDest < 64; cchDest += 3){
+                size_t required = 0;
+                HRESULT result;
+                HRESULT wantedResult;
+
+                memset(dest, 0, sizeof(dest));
+                memset(expected, 0, sizeof(expected));
+                strcpy(dest, "foo");
+                strcpy(expected, "foo");
+                wantedResult = StringCchCopyExA(expected, cchDest,
+                        source + offset, NULL, NULL, 0);
+                result = StringCchCopyEx2A(dest, cchDest, source + offset,
+                        NULL, NULL, 0, &required);
+                correct = correct && result == wantedResult &&
+                        memcmp(dest, expected, sizeof(dest)) == 0 &&
+                        required == 0 + sourceLength;
+            }
+        }
+    }
+    ok(correct, "Same results as StringCchCopyExA.");
+}
+
+int main(void){
+    plan(3 + 4 + 3 + 2 + 2 + 2 + 1);
+
+    testRequired();
+    testCompare();
+
+    return 0;
+}
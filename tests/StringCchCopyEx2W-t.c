@@ -0,0 +1,124 @@
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#define STRSAFE_NO_DEPRECATE
+#include <strsafe.h>
+#include "tap/wide.h"
+
+void testRequired(){
+    wchar_t dest[11];
+    wchar_t * destEnd;
+    size_t remaining;
+    size_t required;
+
+    diag("Test the required length.");
+
+    wcscpy(dest, L"foo");
+    required = 0;
+    ok(SUCCEEDED(StringCchCopyEx2W(dest, 11, L"test", &destEnd, &remaining, 0,
+                    &required)),
+            "Get the required length of a string that fits.");
+    is_wstring(L"test", dest,
+            "Result for a string that fits.");
+    is_int(4, required,
+            "Required length of a string that fits.");
+
+    wcscpy(dest, L"foo");
+    required = 0;
+    ok(StringCchCopyEx2W(dest, 11, L"a much longer string", &destEnd,
+                    &remaining, 0, &required) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Get the required length of a string that does not fit.");
+    is_wstring(L"a much lon", dest,
+            "Result for a string that does not fit.");
+    is_int(20, required,
+            "Required length of a string that does not fit.");
+    ok(destEnd == &dest[10] && remaining == 1,
+            "End of the result for a string that does not fit.");
+
+    wcscpy(dest, L"foo");
+    required = 0;
+    ok(StringCchCopyEx2W(dest, 11, L"a much longer string", NULL, NULL,
+                    STRSAFE_NO_TRUNCATION, &required) ==
+                    STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Get the required length without truncation.");
+    is_wstring(L"", dest,
+            "Result for a string that does not fit without truncation.");
+    is_int(20, required,
+            "Required length without truncation.");
+
+    wcscpy(dest, L"foo");
+    required = 0;
+    ok(SUCCEEDED(StringCchCopyEx2W(dest, 11, NULL, NULL, NULL,
+                    STRSAFE_IGNORE_NULLS, &required)),
+            "Get the required length of NULL with STRSAFE_IGNORE_NULLS.");
+    is_int(0, required,
+            "Required length of NULL with STRSAFE_IGNORE_NULLS.");
+
+    wcscpy(dest, L"foo");
+    ok(StringCchCopyEx2W(dest, 11, NULL, NULL, NULL, STRSAFE_NO_TRUNCATION,
+                    &required) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Get the required length of NULL without truncation.");
+    is_wstring(L"", dest,
+            "Result for NULL without truncation.");
+
+    wcscpy(dest, L"foo");
+    ok(StringCchCopyEx2W(dest, 11, L"a much longer string", &destEnd,
+                    &remaining, 0, NULL) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Leave out the required length.");
+    is_wstring(L"a much lon", dest,
+            "Result without the required length.");
+}
+
+/*
+ * Compares the results with those of StringCchCopyExW and the required length
+ * with the length of the source, for sources of many lengths that start
+ * anywhere within a vector.
+ */
+void testCompare(){
+    wchar_t source[320];
+    wchar_t dest[64];
+    wchar_t expected[64];
+    size_t offset;
+    int correct = 1;
+
+    diag("Compare with StringCchCopyExW.");
+
+    for(offset = 0; offset < 64; offset++){
+        size_t sourceLength;
+        for(sourceLength = 0; sourceLength < 200; sourceLength += 7){
+            size_t cchDest;
+            size_t i;
+            for(i = 0; i < 320; i++){
+                source[i] = (wchar_t)('a' + i % 26);
+            }
+            source[offset + sourceLength] = L'\0';
+            for(cchDest = 4; cchDest < 64; cchDest += 3){
+                size_t required = 0;
+                HRESULT result;
+                HRESULT wantedResult;
+
+                memset(dest, 0, sizeof(dest));
+                memset(expected, 0, sizeof(expected));
+                wcscpy(dest, L"foo");
+                wcscpy(expected, L"foo");
+                wantedResult = StringCchCopyExW(expected, cchDest,
+                        source + offset, NULL, NULL, 0);
+                result = StringCchCopyEx2W(dest, cchDest, source + offset,
+                        NULL, NULL, 0, &required);
+                correct = correct && result == wantedResult &&
+                        memcmp(dest, expected, sizeof(dest)) == 0 &&
+                        required == 0 + sourceLength;
+            }
+        }
+    }
+    ok(correct, "Same results as StringCchCopyExW.");
+}
+
+int main(void){
+    plan(3 + 4 + 3 + 2 + 2 + 2 + 1);
+
+    testRequired();
+    testCompare();
+
+    return 0;
+}
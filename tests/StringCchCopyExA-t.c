@@ -1,3 +1,4 @@
+#include <string.h>
 #include <strsafe.h>
 #include "tap/basic.h"
 
@@ -116,10 +117,74 @@ void testFlags(){
             "Result after copying with truncating disabled.");
 }
 
+/*
+ * Copies strings of different lengths, starting at different alignments,
+ * to destinations at different alignments and compares the result with
+ * the expected result. Characters of pszDest beyond the null termination
+ * must be left untouched.
+ */
+void testAlignment(){
+    char src[64 + 300];
+    char dest[64 + 300];
+    char expected[64 + 300];
+    size_t destOffset;
+    size_t i;
+
+    diag("Test copying between different alignments.");
+
+    for(i = 0; i < sizeof(src) / sizeof(src[0]); i++){
+        src[i] = (char)('a' + i % 26);
+    }
+
+    for(destOffset = 0; destOffset < 64; destOffset++){
+        int correct = 1;
+        size_t srcOffset;
+        for(srcOffset = 0; srcOffset < 64; srcOffset++){
+            size_t srcLength;
+            for(srcLength = 0; srcLength < 260; srcLength += 7){
+                size_t cchDest;
+                char saved = src[srcOffset + srcLength];
+                src[srcOffset + srcLength] = '\0';
+                for(cchDest = srcLength; cchDest < srcLength + 3; cchDest++){
+                    size_t copyLength = srcLength;
+                    HRESULT wanted = S_OK;
+                    char * destEnd = NULL;
+                    HRESULT result;
+
+                    if(cchDest == 0){
+                        continue;
+                    }
+                    if(copyLength >= cchDest){
+                        copyLength = cchDest - 1;
+                        wanted = STRSAFE_E_INSUFFICIENT_BUFFER;
+                    }
+                    memset(dest, '#', sizeof(dest) / sizeof(dest[0]));
+                    memset(expected, '#',
+                            sizeof(expected) / sizeof(expected[0]));
+                    for(i = 0; i < copyLength; i++){
+                        expected[destOffset + i] = src[srcOffset + i];
+                    }
+                    expected[destOffset + copyLength] = '\0';
+
+                    result = StringCchCopyExA(dest + destOffset, cchDest,
+                            src + srcOffset, &destEnd, NULL, 0);
+                    correct = correct && result == wanted &&
+                            destEnd == dest + destOffset + copyLength &&
+                            memcmp(dest, expected,
+                                    sizeof(dest) / sizeof(dest[0])) == 0;
+                }
+                src[srcOffset + srcLength] = saved;
+            }
+        }
+        ok(correct, "Copy strings to offset %lu.",
+                (unsigned long)destOffset);
+    }
+}
+
 int main(void){
     char dest[11];
     
-    plan(31);
+    plan(31 + 64);
 
     ok(SUCCEEDED(StringCchCopyExA(dest, 11, "test", NULL, NULL, 0)),
             "Copy short string without any extended functionality.");
@@ -129,6 +194,7 @@ int main(void){
     testDestEnd();
     testRemaining();
     testFlags();
+    testAlignment();
 
     return 0;
 }
@@ -135,10 +135,74 @@ void testFlags(){
             "Result after copying with truncating disabled.");
 }
 
+/*
+ * Copies strings of different lengths, starting at different alignments,
+ * to destinations at different alignments and compares the result with
+ * the expected result. Characters of pszDest beyond the null termination
+ * must be left untouched.
+ */
+void testAlignment(){
+    wchar_t src[16 + 300];
+    wchar_t dest[16 + 300];
+    wchar_t expected[16 + 300];
+    size_t destOffset;
+    size_t i;
+
+    diag("Test copying between different alignments.");
+
+    for(i = 0; i < sizeof(src) / sizeof(src[0]); i++){
+        src[i] = (wchar_t)(L'a' + i % 26);
+    }
+
+    for(destOffset = 0; destOffset < 16; destOffset++){
+        int correct = 1;
+        size_t srcOffset;
+        for(srcOffset = 0; srcOffset < 16; srcOffset++){
+            size_t srcLength;
+            for(srcLength = 0; srcLength < 260; srcLength += 7){
+                size_t cchDest;
+                wchar_t saved = src[srcOffset + srcLength];
+                src[srcOffset + srcLength] = L'\0';
+                for(cchDest = srcLength; cchDest < srcLength + 3; cchDest++){
+                    size_t copyLength = srcLength;
+                    HRESULT wanted = S_OK;
+                    wchar_t * destEnd = NULL;
+                    HRESULT result;
+
+                    if(cchDest == 0){
+                        continue;
+                    }
+                    if(copyLength >= cchDest){
+                        copyLength = cchDest - 1;
+                        wanted = STRSAFE_E_INSUFFICIENT_BUFFER;
+                    }
+                    wmemset(dest, L'#', sizeof(dest) / sizeof(dest[0]));
+                    wmemset(expected, L'#',
+                            sizeof(expected) / sizeof(expected[0]));
+                    for(i = 0; i < copyLength; i++){
+                        expected[destOffset + i] = src[srcOffset + i];
+                    }
+                    expected[destOffset + copyLength] = L'\0';
+
+                    result = StringCchCopyExW(dest + destOffset, cchDest,
+                            src + srcOffset, &destEnd, NULL, 0);
+                    correct = correct && result == wanted &&
+                            destEnd == dest + destOffset + copyLength &&
+                            wmemcmp(dest, expected,
+                                    sizeof(dest) / sizeof(dest[0])) == 0;
+                }
+                src[srcOffset + srcLength] = saved;
+            }
+        }
+        ok(correct, "Copy strings to offset %lu.",
+                (unsigned long)destOffset);
+    }
+}
+
 int main(void){
     wchar_t dest[11];
     
-    plan(32);
+    plan(32 + 16);
 
     ok(SUCCEEDED(StringCchCopyExW(dest, 11, L"test", NULL, NULL, 0)),
             "Copy short string without any extended functionality.");
@@ -148,6 +212,7 @@ int main(void){
     testDestEnd();
     testRemaining();
     testFlags();
+    testAlignment();
 
     return 0;
 }
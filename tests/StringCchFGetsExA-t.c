@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <string.h>
+#include <strsafe.h>
+#include "tap/basic.h"
+
+/*
+ * Creates a temporary file with the given contents, positioned at the
+ * start.
+ */
+FILE * openWith(const char * contents, size_t length){
+    FILE * file = tmpfile();
+
+    if(file == NULL){
+        sysbail("Could not create a temporary file");
+    }
+    fwrite(contents, 1, length, file);
+    rewind(file);
+
+    return file;
+}
+
+void testLines(){
+    static const char contents[] = "first line\nunittests\n\nlong line\nlast";
+    FILE * file = openWith(contents, sizeof(contents) - 1);
+    char dest[32];
+    char * destEnd;
+    size_t remaining;
+
+    diag("Test reading lines from a stream.");
+
+    ok(StringCchFGetsExA(dest, 32, file, &destEnd, &remaining, 0) == S_OK,
+            "Read a line.");
+    is_string("first line", dest, "Result of reading a line.");
+    ok(destEnd == &dest[10] && remaining == 22,
+            "End of the result of reading a line.");
+
+    ok(StringCchFGetsExA(dest, 10, file, NULL, NULL, 0) == S_OK,
+            "Read a line that exactly fits.");
+    is_string("unittests", dest,
+            "Result of reading a line that exactly fits.");
+    ok(StringCchFGetsExA(dest, 10, file, NULL, NULL, 0) == S_OK,
+            "Read the line break after a line that exactly fits.");
+    is_string("", dest,
+            "Result of reading the line break after a line that exactly "
+            "fits.");
+
+    ok(StringCchFGetsExA(dest, 32, file, NULL, NULL, 0) == S_OK,
+            "Read an empty line.");
+    is_string("", dest, "Result of reading an empty line.");
+
+    ok(StringCchFGetsExA(dest, 5, file, NULL, NULL, 0) == S_OK,
+            "Read a line that does not fit.");
+    is_string("long", dest, "Result of reading a line that does not fit.");
+    ok(fgetc(file) == ' ',
+            "The rest of the line is left in the stream.");
+    ok(StringCchFGetsExA(dest, 32, file, NULL, NULL, 0) == S_OK,
+            "Read the rest of the line.");
+    is_string("line", dest, "Result of reading the rest of the line.");
+
+    ok(StringCchFGetsExA(dest, 32, file, &destEnd, NULL, 0) == S_OK,
+            "Read a last line without a line break.");
+    ok(strcmp(dest, "last") == 0 && destEnd == &dest[4],
+            "Result of reading a last line without a line break.");
+
+    ok(StringCchFGetsExA(dest, 32, file, &destEnd, &remaining, 0) ==
+            STRSAFE_E_END_OF_FILE,
+            "Read at the end of the stream.");
+    ok(dest[0] == '\0' && destEnd == dest && remaining == 32,
+            "Result of reading at the end of the stream.");
+
+    fclose(file);
+}
+
+void testLongLine(){
+    static char contents[20001];
+    static char dest[20000];
+    FILE * file;
+    size_t length;
+
+    diag("Test reading lines longer than the buffer of the stream.");
+
+    memset(contents, 'x', 20000);
+    contents[10000] = '\n';
+    file = openWith(contents, 20000);
+
+    ok(StringCchFGetsExA(dest, 20000, file, NULL, NULL, 0) == S_OK,
+            "Read a long line.");
+    length = strlen(dest);
+    ok(length == 10000 && strspn(dest, "x") == 10000,
+            "Result of reading a long line.");
+    ok(StringCchFGetsExA(dest, 5000, file, NULL, NULL, 0) == S_OK &&
+            strlen(dest) == 4999,
+            "Read part of a long last line.");
+
+    fclose(file);
+}
+
+void testFlags(){
+    FILE * file = openWith("", 0);
+    char dest[11];
+    char wanted[11];
+
+    diag("Test reading lines with invalid parameters and flags.");
+
+    ok(StringCchFGetsExA(dest, 11, NULL, NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Read from a NULL stream.");
+    ok(StringCchFGetsExA(dest, 1, file, NULL, NULL, 0) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER && dest[0] == '\0',
+            "Read into a buffer without room for a character.");
+
+    ok(StringCchFGetsExA(dest, 11, file, NULL, NULL,
+                    STRSAFE_FILL_ON_FAILURE | '@') == STRSAFE_E_END_OF_FILE,
+            "Read at the end of the stream with STRSAFE_FILL_ON_FAILURE.");
+    memset(wanted, '@', 10 * sizeof(char));
+    wanted[10] = '\0';
+    is_string(wanted, dest,
+            "Result of a failure with STRSAFE_FILL_ON_FAILURE.");
+
+    ok(StringCchFGetsExA(dest, 11, file, NULL, NULL,
+                    STRSAFE_NULL_ON_FAILURE) == STRSAFE_E_END_OF_FILE,
+            "Read at the end of the stream with STRSAFE_NULL_ON_FAILURE.");
+    is_string("", dest,
+            "Result of a failure with STRSAFE_NULL_ON_FAILURE.");
+
+    fclose(file);
+}
+
+int main(void){
+    plan(18 + 3 + 6);
+
+    testLines();
+    testLongLine();
+    testFlags();
+
+    return 0;
+}
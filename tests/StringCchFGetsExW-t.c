@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <string.h>
+#include <wchar.h>
+#define STRSAFE_NO_DEPRECATE
+#include <strsafe.h>
+#include "tap/wide.h"
+
+/*
+ * Creates a temporary wide oriented file with the given contents,
+ * positioned at the start.
+ */
+FILE * openWith(LPCWSTR contents){
+    FILE * file = tmpfile();
+
+    if(file == NULL){
+        sysbail("Could not create a temporary file");
+    }
+    fputws(contents, file);
+    rewind(file);
+
+    return file;
+}
+
+void testLines(){
+    FILE * file = openWith(L"first line\nunittests\n\nlong line\nlast");
+    wchar_t dest[32];
+    wchar_t * destEnd;
+    size_t remaining;
+
+    diag("Test reading lines from a stream.");
+
+    ok(StringCchFGetsExW(dest, 32, file, &destEnd, &remaining, 0) == S_OK,
+            "Read a line.");
+    is_wstring(L"first line", dest, "Result of reading a line.");
+    ok(destEnd == &dest[10] && remaining == 22,
+            "End of the result of reading a line.");
+
+    ok(StringCchFGetsExW(dest, 10, file, NULL, NULL, 0) == S_OK,
+            "Read a line that exactly fits.");
+    is_wstring(L"unittests", dest,
+            "Result of reading a line that exactly fits.");
+    ok(StringCchFGetsExW(dest, 10, file, NULL, NULL, 0) == S_OK,
+            "Read the line break after a line that exactly fits.");
+    is_wstring(L"", dest,
+            "Result of reading the line break after a line that exactly "
+            "fits.");
+
+    ok(StringCchFGetsExW(dest, 32, file, NULL, NULL, 0) == S_OK,
+            "Read an empty line.");
+    is_wstring(L"", dest, "Result of reading an empty line.");
+
+    ok(StringCchFGetsExW(dest, 5, file, NULL, NULL, 0) == S_OK,
+            "Read a line that does not fit.");
+    is_wstring(L"long", dest,
+            "Result of reading a line that does not fit.");
+    ok(fgetwc(file) == L' ',
+            "The rest of the line is left in the stream.");
+    ok(StringCchFGetsExW(dest, 32, file, NULL, NULL, 0) == S_OK,
+            "Read the rest of the line.");
+    is_wstring(L"line", dest, "Result of reading the rest of the line.");
+
+    ok(StringCchFGetsExW(dest, 32, file, &destEnd, NULL, 0) == S_OK,
+            "Read a last line without a line break.");
+    ok(wcscmp(dest, L"last") == 0 && destEnd == &dest[4],
+            "Result of reading a last line without a line break.");
+
+    ok(StringCchFGetsExW(dest, 32, file, &destEnd, &remaining, 0) ==
+            STRSAFE_E_END_OF_FILE,
+            "Read at the end of the stream.");
+    ok(dest[0] == L'\0' && destEnd == dest && remaining == 32,
+            "Result of reading at the end of the stream.");
+
+    fclose(file);
+}
+
+void testLongLine(){
+    static wchar_t contents[20001];
+    static wchar_t dest[20000];
+    FILE * file;
+    size_t length;
+
+    diag("Test reading lines longer than the buffer of the stream.");
+
+    wmemset(contents, L'x', 20000);
+    contents[10000] = L'\n';
+    contents[20000] = L'\0';
+    file = openWith(contents);
+
+    ok(StringCchFGetsExW(dest, 20000, file, NULL, NULL, 0) == S_OK,
+            "Read a long line.");
+    length = wcslen(dest);
+    ok(length == 10000 && wcsspn(dest, L"x") == 10000,
+            "Result of reading a long line.");
+    ok(StringCchFGetsExW(dest, 5000, file, NULL, NULL, 0) == S_OK &&
+            wcslen(dest) == 4999,
+            "Read part of a long last line.");
+
+    fclose(file);
+}
+
+void testFlags(){
+    FILE * file = openWith(L"");
+    wchar_t dest[11];
+    wchar_t wanted[11];
+
+    diag("Test reading lines with invalid parameters and flags.");
+
+    ok(StringCchFGetsExW(dest, 11, NULL, NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Read from a NULL stream.");
+    ok(StringCchFGetsExW(dest, 1, file, NULL, NULL, 0) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER && dest[0] == L'\0',
+            "Read into a buffer without room for a character.");
+
+    ok(StringCchFGetsExW(dest, 11, file, NULL, NULL,
+                    STRSAFE_FILL_ON_FAILURE | '@') == STRSAFE_E_END_OF_FILE,
+            "Read at the end of the stream with STRSAFE_FILL_ON_FAILURE.");
+    memset(wanted, '@', 10 * sizeof(wchar_t));
+    wanted[10] = L'\0';
+    is_wstring(wanted, dest,
+            "Result of a failure with STRSAFE_FILL_ON_FAILURE.");
+
+    ok(StringCchFGetsExW(dest, 11, file, NULL, NULL,
+                    STRSAFE_NULL_ON_FAILURE) == STRSAFE_E_END_OF_FILE,
+            "Read at the end of the stream with STRSAFE_NULL_ON_FAILURE.");
+    is_wstring(L"", dest,
+            "Result of a failure with STRSAFE_NULL_ON_FAILURE.");
+
+    fclose(file);
+}
+
+int main(void){
+    plan(18 + 3 + 6);
+
+    testLines();
+    testLongLine();
+    testFlags();
+
+    return 0;
+}
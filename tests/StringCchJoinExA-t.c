@@ -0,0 +1,242 @@
+#include <string.h>
+#include <strsafe.h>
+#include "tap/basic.h"
+
+void testJoin(){
+    char dest[11];
+    char * destEnd;
+    size_t remaining;
+    LPCSTR sources[] = {"ab", "", "cd"};
+    LPCSTR single[] = {"one"};
+    STRSAFE_SEGMENT_A segments[] = {{"abXX", 2}, {NULL, 0}, {"cd", 2}};
+
+    diag("Test joining strings.");
+
+    dest[0] = '\0';
+    ok(SUCCEEDED(StringCchJoinExA(dest, 11, sources, 3, ", ", &destEnd,
+                    &remaining, 0)),
+            "Join an array of strings.");
+    is_string("ab, , cd", dest,
+            "Result of joining an array of strings.");
+    ok(destEnd == &dest[8] && remaining == 3,
+            "End of the result of joining an array of strings.");
+
+    strcpy(dest, "x=");
+    ok(SUCCEEDED(StringCchJoinExA(dest, 11, single, 1, ", ", NULL, NULL,
+                    0)),
+            "Join a single string to a prefix.");
+    is_string("x=one", dest,
+            "Result of joining a single string to a prefix.");
+
+    ok(SUCCEEDED(StringCchJoinExA(dest, 11, NULL, 0, ", ", NULL, NULL,
+                    0)),
+            "Join no strings.");
+    is_string("x=one", dest,
+            "Result of joining no strings.");
+
+    dest[0] = '\0';
+    ok(SUCCEEDED(StringCchJoinGatherExA(dest, 11, segments, 3, "/",
+                    &destEnd, &remaining, 0)),
+            "Join segments.");
+    is_string("ab//cd", dest,
+            "Result of joining segments.");
+    ok(destEnd == &dest[6] && remaining == 5,
+            "End of the result of joining segments.");
+
+    dest[0] = '\0';
+    ok(SUCCEEDED(StringCchJoinExA(dest, 11, sources, 3, "", NULL, NULL,
+                    0)),
+            "Join with an empty separator.");
+    is_string("abcd", dest,
+            "Result of joining with an empty separator.");
+}
+
+void testTruncation(){
+    char dest[11];
+    char * destEnd;
+    size_t remaining;
+    LPCSTR sources[] = {"one", "two", "three"};
+    STRSAFE_SEGMENT_A segments[] = {{"one", 3}, {"two", 3}, {"three", 5}};
+
+    diag("Test joining strings that do not fit.");
+
+    dest[0] = '\0';
+    ok(StringCchJoinExA(dest, 11, sources, 3, ", ", &destEnd, &remaining,
+                    0) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Join strings that do not fit.");
+    is_string("one, two, ", dest,
+            "Result of joining strings that do not fit.");
+    ok(destEnd == &dest[10] && remaining == 1,
+            "End of the result of joining strings that do not fit.");
+
+    dest[0] = '\0';
+    ok(StringCchJoinExA(dest, 11, sources, 3, "---", NULL, NULL, 0) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Join strings whose separator does not fit.");
+    is_string("one---two-", dest,
+            "Result of joining strings whose separator does not fit.");
+
+    strcpy(dest, "0");
+    dest[5] = '#';
+    ok(StringCchJoinExA(dest, 11, sources, 3, ",", NULL, NULL,
+                    STRSAFE_NO_TRUNCATION) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Join strings that do not fit without truncation.");
+    is_string("0", dest,
+            "Result of joining strings that do not fit without "
+            "truncation.");
+    ok(dest[5] == '#',
+            "Buffer untouched after joining strings that do not fit "
+            "without truncation.");
+
+    dest[0] = '\0';
+    ok(StringCchJoinGatherExA(dest, 11, segments, 3, ",", NULL, NULL, 0) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Join segments that do not fit.");
+    is_string("one,two,th", dest,
+            "Result of joining segments that do not fit.");
+
+    ok(StringCchJoinGatherExA(dest, 11, segments, 3, ",", NULL, NULL,
+                    STRSAFE_NULL_ON_FAILURE) ==
+                    STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Join segments that do not fit with STRSAFE_NULL_ON_FAILURE.");
+    is_string("", dest,
+            "Result of a failure with STRSAFE_NULL_ON_FAILURE.");
+}
+
+void testFlags(){
+    char dest[11];
+    char wanted[11];
+    LPCSTR sources[] = {"ab", NULL, "cd"};
+
+    diag("Test joining strings with flags.");
+
+    dest[0] = '\0';
+    ok(StringCchJoinExA(dest, 11, sources, 3, ",", NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Join an array with a NULL element.");
+    ok(SUCCEEDED(StringCchJoinExA(dest, 11, sources, 3, ",", NULL, NULL,
+                    STRSAFE_IGNORE_NULLS)),
+            "Join an array with a NULL element with STRSAFE_IGNORE_NULLS.");
+    is_string("ab,,cd", dest,
+            "Result of joining an array with a NULL element.");
+
+    dest[0] = '\0';
+    ok(StringCchJoinExA(dest, 11, sources, 1, NULL, NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Join with a NULL separator.");
+    ok(SUCCEEDED(StringCchJoinExA(dest, 11, sources, 3, NULL, NULL, NULL,
+                    STRSAFE_IGNORE_NULLS)),
+            "Join with a NULL separator with STRSAFE_IGNORE_NULLS.");
+    is_string("abcd", dest,
+            "Result of joining with a NULL separator.");
+
+    ok(StringCchJoinExA(dest, 11, sources, 3, "+++", NULL, NULL,
+                    STRSAFE_IGNORE_NULLS | STRSAFE_FILL_ON_FAILURE | '@') ==
+                    STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Join strings that do not fit with STRSAFE_FILL_ON_FAILURE.");
+    memset(wanted, '@', 10 * sizeof(char));
+    wanted[10] = '\0';
+    is_string(wanted, dest,
+            "Result of a failure with STRSAFE_FILL_ON_FAILURE.");
+
+    dest[0] = '\0';
+    ok(SUCCEEDED(StringCchJoinExA(dest, 11, sources, 3, "", NULL, NULL,
+                    STRSAFE_IGNORE_NULLS | STRSAFE_FILL_BEHIND_NULL | '@')),
+            "Join strings with STRSAFE_FILL_BEHIND_NULL.");
+    ok(strcmp(dest, "abcd") == 0 &&
+            memcmp(dest + 5, wanted, 6 * sizeof(char)) == 0,
+            "Buffer filled behind the result with STRSAFE_FILL_BEHIND_NULL.");
+
+    memset(dest, 'x', sizeof(dest));
+    ok(StringCchJoinExA(dest, 11, sources, 1, ",", NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Join to a buffer that is not null terminated.");
+    ok(StringCchJoinExA(dest, 0, sources, 1, ",", NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Join with cchDest set to zero.");
+}
+
+/*
+ * Compares the results with those of concatenating the strings and
+ * separators one at a time with StringCchCatExA, for strings of many
+ * lengths that start and end anywhere within a vector.
+ */
+void testCompare(){
+    char source[80];
+    char dest[100];
+    char expected[100];
+    size_t split;
+    DWORD flags[] = {0, STRSAFE_NO_TRUNCATION};
+    size_t i;
+
+    diag("Compare with concatenating one string at a time.");
+
+    for(i = 0; i < 2; i++){
+        int correct = 1;
+        for(split = 0; split < 70; split++){
+            size_t prefix;
+            for(prefix = 0; prefix < 40; prefix += 3){
+                size_t cchDest;
+                for(cchDest = prefix + 1; cchDest < 100; cchDest += 5){
+                    LPCSTR sources[3] = {
+                        source, source + split + 1, source + 70
+                    };
+                    HRESULT result;
+                    HRESULT wantedResult;
+                    size_t j;
+
+                    for(j = 0; j < 79; j++){
+                        source[j] = (char)('a' + j % 26);
+                    }
+                    source[79] = '\0';
+                    source[split] = '\0';
+
+                    for(j = 0; j < 100; j++){
+                        dest[j] = expected[j] = '#';
+                    }
+                    for(j = 0; j < prefix; j++){
+                        dest[j] = expected[j] = 'p';
+                    }
+                    dest[prefix] = expected[prefix] = '\0';
+
+                    wantedResult = S_OK;
+                    for(j = 0; j < 3 && SUCCEEDED(wantedResult); j++){
+                        if(j > 0){
+                            wantedResult = StringCchCatExA(expected,
+                                    cchDest, ", ", NULL, NULL, 0);
+                        }
+                        if(SUCCEEDED(wantedResult)){
+                            wantedResult = StringCchCatExA(expected,
+                                    cchDest, sources[j], NULL, NULL, 0);
+                        }
+                    }
+                    if(FAILED(wantedResult) && flags[i] != 0){
+                        /* Nothing should be written. */
+                        for(j = prefix + 1; j < 100; j++){
+                            expected[j] = '#';
+                        }
+                        expected[prefix] = '\0';
+                    }
+
+                    result = StringCchJoinExA(dest, cchDest, sources, 3,
+                            ", ", NULL, NULL, flags[i]);
+                    correct = correct && result == wantedResult &&
+                            memcmp(dest, expected, sizeof(dest)) == 0;
+                }
+            }
+        }
+        ok(correct, "Same results as StringCchCatExA with flags %lu.",
+                (unsigned long)flags[i]);
+    }
+}
+
+int main(void){
+    plan(12 + 12 + 12 + 2);
+
+    testJoin();
+    testTruncation();
+    testFlags();
+    testCompare();
+
+    return 0;
+}
@@ -0,0 +1,244 @@
+#include <string.h>
+#include <wchar.h>
+#define STRSAFE_NO_DEPRECATE
+#include <strsafe.h>
+#include "tap/wide.h"
+
+void testJoin(){
+    wchar_t dest[11];
+    wchar_t * destEnd;
+    size_t remaining;
+    LPCWSTR sources[] = {L"ab", L"", L"cd"};
+    LPCWSTR single[] = {L"one"};
+    STRSAFE_SEGMENT_W segments[] = {{L"abXX", 2}, {NULL, 0}, {L"cd", 2}};
+
+    diag("Test joining strings.");
+
+    dest[0] = L'\0';
+    ok(SUCCEEDED(StringCchJoinExW(dest, 11, sources, 3, L", ", &destEnd,
+                    &remaining, 0)),
+            "Join an array of strings.");
+    is_wstring(L"ab, , cd", dest,
+            "Result of joining an array of strings.");
+    ok(destEnd == &dest[8] && remaining == 3,
+            "End of the result of joining an array of strings.");
+
+    wcscpy(dest, L"x=");
+    ok(SUCCEEDED(StringCchJoinExW(dest, 11, single, 1, L", ", NULL, NULL,
+                    0)),
+            "Join a single string to a prefix.");
+    is_wstring(L"x=one", dest,
+            "Result of joining a single string to a prefix.");
+
+    ok(SUCCEEDED(StringCchJoinExW(dest, 11, NULL, 0, L", ", NULL, NULL,
+                    0)),
+            "Join no strings.");
+    is_wstring(L"x=one", dest,
+            "Result of joining no strings.");
+
+    dest[0] = L'\0';
+    ok(SUCCEEDED(StringCchJoinGatherExW(dest, 11, segments, 3, L"/",
+                    &destEnd, &remaining, 0)),
+            "Join segments.");
+    is_wstring(L"ab//cd", dest,
+            "Result of joining segments.");
+    ok(destEnd == &dest[6] && remaining == 5,
+            "End of the result of joining segments.");
+
+    dest[0] = L'\0';
+    ok(SUCCEEDED(StringCchJoinExW(dest, 11, sources, 3, L"", NULL, NULL,
+                    0)),
+            "Join with an empty separator.");
+    is_wstring(L"abcd", dest,
+            "Result of joining with an empty separator.");
+}
+
+void testTruncation(){
+    wchar_t dest[11];
+    wchar_t * destEnd;
+    size_t remaining;
+    LPCWSTR sources[] = {L"one", L"two", L"three"};
+    STRSAFE_SEGMENT_W segments[] = {{L"one", 3}, {L"two", 3}, {L"three", 5}};
+
+    diag("Test joining strings that do not fit.");
+
+    dest[0] = L'\0';
+    ok(StringCchJoinExW(dest, 11, sources, 3, L", ", &destEnd, &remaining,
+                    0) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Join strings that do not fit.");
+    is_wstring(L"one, two, ", dest,
+            "Result of joining strings that do not fit.");
+    ok(destEnd == &dest[10] && remaining == 1,
+            "End of the result of joining strings that do not fit.");
+
+    dest[0] = L'\0';
+    ok(StringCchJoinExW(dest, 11, sources, 3, L"---", NULL, NULL, 0) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Join strings whose separator does not fit.");
+    is_wstring(L"one---two-", dest,
+            "Result of joining strings whose separator does not fit.");
+
+    wcscpy(dest, L"0");
+    dest[5] = L'#';
+    ok(StringCchJoinExW(dest, 11, sources, 3, L",", NULL, NULL,
+                    STRSAFE_NO_TRUNCATION) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Join strings that do not fit without truncation.");
+    is_wstring(L"0", dest,
+            "Result of joining strings that do not fit without "
+            "truncation.");
+    ok(dest[5] == L'#',
+            "Buffer untouched after joining strings that do not fit "
+            "without truncation.");
+
+    dest[0] = L'\0';
+    ok(StringCchJoinGatherExW(dest, 11, segments, 3, L",", NULL, NULL, 0) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Join segments that do not fit.");
+    is_wstring(L"one,two,th", dest,
+            "Result of joining segments that do not fit.");
+
+    ok(StringCchJoinGatherExW(dest, 11, segments, 3, L",", NULL, NULL,
+                    STRSAFE_NULL_ON_FAILURE) ==
+                    STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Join segments that do not fit with STRSAFE_NULL_ON_FAILURE.");
+    is_wstring(L"", dest,
+            "Result of a failure with STRSAFE_NULL_ON_FAILURE.");
+}
+
+void testFlags(){
+    wchar_t dest[11];
+    wchar_t wanted[11];
+    LPCWSTR sources[] = {L"ab", NULL, L"cd"};
+
+    diag("Test joining strings with flags.");
+
+    dest[0] = L'\0';
+    ok(StringCchJoinExW(dest, 11, sources, 3, L",", NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Join an array with a NULL element.");
+    ok(SUCCEEDED(StringCchJoinExW(dest, 11, sources, 3, L",", NULL, NULL,
+                    STRSAFE_IGNORE_NULLS)),
+            "Join an array with a NULL element with STRSAFE_IGNORE_NULLS.");
+    is_wstring(L"ab,,cd", dest,
+            "Result of joining an array with a NULL element.");
+
+    dest[0] = L'\0';
+    ok(StringCchJoinExW(dest, 11, sources, 1, NULL, NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Join with a NULL separator.");
+    ok(SUCCEEDED(StringCchJoinExW(dest, 11, sources, 3, NULL, NULL, NULL,
+                    STRSAFE_IGNORE_NULLS)),
+            "Join with a NULL separator with STRSAFE_IGNORE_NULLS.");
+    is_wstring(L"abcd", dest,
+            "Result of joining with a NULL separator.");
+
+    ok(StringCchJoinExW(dest, 11, sources, 3, L"+++", NULL, NULL,
+                    STRSAFE_IGNORE_NULLS | STRSAFE_FILL_ON_FAILURE | '@') ==
+                    STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Join strings that do not fit with STRSAFE_FILL_ON_FAILURE.");
+    memset(wanted, '@', 10 * sizeof(wchar_t));
+    wanted[10] = L'\0';
+    is_wstring(wanted, dest,
+            "Result of a failure with STRSAFE_FILL_ON_FAILURE.");
+
+    dest[0] = L'\0';
+    ok(SUCCEEDED(StringCchJoinExW(dest, 11, sources, 3, L"", NULL, NULL,
+                    STRSAFE_IGNORE_NULLS | STRSAFE_FILL_BEHIND_NULL | '@')),
+            "Join strings with STRSAFE_FILL_BEHIND_NULL.");
+    ok(wcscmp(dest, L"abcd") == 0 &&
+            memcmp(dest + 5, wanted, 6 * sizeof(wchar_t)) == 0,
+            "Buffer filled behind the result with STRSAFE_FILL_BEHIND_NULL.");
+
+    memset(dest, 'x', sizeof(dest));
+    ok(StringCchJoinExW(dest, 11, sources, 1, L",", NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Join to a buffer that is not null terminated.");
+    ok(StringCchJoinExW(dest, 0, sources, 1, L",", NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Join with cchDest set to zero.");
+}
+
+/*
+ * Compares the results with those of concatenating the strings and
+ * separators one at a time with StringCchCatExW, for strings of many
+ * lengths that start and end anywhere within a vector.
+ */
+void testCompare(){
+    wchar_t source[80];
+    wchar_t dest[100];
+    wchar_t expected[100];
+    size_t split;
+    DWORD flags[] = {0, STRSAFE_NO_TRUNCATION};
+    size_t i;
+
+    diag("Compare with concatenating one string at a time.");
+
+    for(i = 0; i < 2; i++){
+        int correct = 1;
+        for(split = 0; split < 70; split++){
+            size_t prefix;
+            for(prefix = 0; prefix < 40; prefix += 3){
+                size_t cchDest;
+                for(cchDest = prefix + 1; cchDest < 100; cchDest += 5){
+                    LPCWSTR sources[3] = {
+                        source, source + split + 1, source + 70
+                    };
+                    HRESULT result;
+                    HRESULT wantedResult;
+                    size_t j;
+
+                    for(j = 0; j < 79; j++){
+                        source[j] = (wchar_t)(L'a' + j % 26);
+                    }
+                    source[79] = L'\0';
+                    source[split] = L'\0';
+
+                    for(j = 0; j < 100; j++){
+                        dest[j] = expected[j] = L'#';
+                    }
+                    for(j = 0; j < prefix; j++){
+                        dest[j] = expected[j] = L'p';
+                    }
+                    dest[prefix] = expected[prefix] = L'\0';
+
+                    wantedResult = S_OK;
+                    for(j = 0; j < 3 && SUCCEEDED(wantedResult); j++){
+                        if(j > 0){
+                            wantedResult = StringCchCatExW(expected,
+                                    cchDest, L", ", NULL, NULL, 0);
+                        }
+                        if(SUCCEEDED(wantedResult)){
+                            wantedResult = StringCchCatExW(expected,
+                                    cchDest, sources[j], NULL, NULL, 0);
+                        }
+                    }
+                    if(FAILED(wantedResult) && flags[i] != 0){
+                        /* Nothing should be written. */
+                        for(j = prefix + 1; j < 100; j++){
+                            expected[j] = L'#';
+                        }
+                        expected[prefix] = L'\0';
+                    }
+
+                    result = StringCchJoinExW(dest, cchDest, sources, 3,
+                            L", ", NULL, NULL, flags[i]);
+                    correct = correct && result == wantedResult &&
+                            memcmp(dest, expected, sizeof(dest)) == 0;
+                }
+            }
+        }
+        ok(correct, "Same results as StringCchCatExW with flags %lu.",
+                (unsigned long)flags[i]);
+    }
+}
+
+int main(void){
+    plan(12 + 12 + 12 + 2);
+
+    testJoin();
+    testTruncation();
+    testFlags();
+    testCompare();
+
+    return 0;
+}
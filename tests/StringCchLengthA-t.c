@@ -1,10 +1,49 @@
+#include <string.h>
 #include <strsafe.h>
 #include "tap/basic.h"
 
+/*
+ * Compares the result for every combination of alignment, string length
+ * and cchMax around the string length with the expected result. This
+ * covers strings that start and end anywhere within a vector.
+ */
+void testAlignment(){
+    char buffer[320];
+    size_t offset;
+
+    diag("Test strings of different lengths at different alignments.");
+
+    for(offset = 0; offset < 64; offset++){
+        int correct = 1;
+        size_t stringLength;
+        for(stringLength = 0; stringLength < 200; stringLength++){
+            size_t cchMax;
+            memset(buffer, 'x', sizeof(buffer));
+            buffer[offset + stringLength] = '\0';
+            for(cchMax = stringLength > 40 ? stringLength - 40 : 0;
+                    cchMax < stringLength + 40; cchMax++){
+                size_t length = 12345;
+                HRESULT result =
+                        StringCchLengthA(buffer + offset, cchMax, &length);
+                if(cchMax > stringLength){
+                    correct = correct && result == S_OK &&
+                            length == stringLength;
+                } else {
+                    correct = correct &&
+                            result == STRSAFE_E_INVALID_PARAMETER &&
+                            length == cchMax;
+                }
+            }
+        }
+        ok(correct, "Length of strings starting at offset %lu.",
+                (unsigned long)offset);
+    }
+}
+
 int main(void){
     size_t length;
 
-    plan(7);
+    plan(7 + 64);
 
     ok(SUCCEEDED(StringCchLengthA("", 1, &length)),
             "Calculate length of empty string.");
@@ -15,15 +54,17 @@ int main(void){
             "Calculate length of short string.");
     is_int(4, length,
             "Value for length of short string.");
-    
+
     ok(SUCCEEDED(StringCchLengthA("test\0test", 10, &length)),
             "Calculate length of string with embedded null character.");
     is_int(4, length,
             "Value for length of string with embedded null character.");
-    
+
     ok(StringCchLengthA("too long", 8, &length) ==
             STRSAFE_E_INVALID_PARAMETER,
             "Make sure error is thrown if null termination is not found.");
 
+    testAlignment();
+
     return 0;
 }
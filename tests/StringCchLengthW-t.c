@@ -2,10 +2,48 @@
 #include <wchar.h>
 #include "tap/basic.h"
 
+/*
+ * Compares the result for every combination of alignment, string length
+ * and cchMax around the string length with the expected result. This
+ * covers strings that start and end anywhere within a vector.
+ */
+void testAlignment(){
+    wchar_t buffer[280];
+    size_t offset;
+
+    diag("Test strings of different lengths at different alignments.");
+
+    for(offset = 0; offset < 16; offset++){
+        int correct = 1;
+        size_t stringLength;
+        for(stringLength = 0; stringLength < 200; stringLength++){
+            size_t cchMax;
+            wmemset(buffer, L'x', sizeof(buffer) / sizeof(wchar_t));
+            buffer[offset + stringLength] = L'\0';
+            for(cchMax = stringLength > 40 ? stringLength - 40 : 0;
+                    cchMax < stringLength + 40; cchMax++){
+                size_t length = 12345;
+                HRESULT result =
+                        StringCchLengthW(buffer + offset, cchMax, &length);
+                if(cchMax > stringLength){
+                    correct = correct && result == S_OK &&
+                            length == stringLength;
+                } else {
+                    correct = correct &&
+                            result == STRSAFE_E_INVALID_PARAMETER &&
+                            length == cchMax;
+                }
+            }
+        }
+        ok(correct, "Length of strings starting at offset %lu.",
+                (unsigned long)offset);
+    }
+}
+
 int main(void){
     size_t length;
 
-    plan(7);
+    plan(7 + 16);
 
     ok(SUCCEEDED(StringCchLengthW(L"", 1, &length)),
             "Calculate length of empty string.");
@@ -26,5 +64,7 @@ int main(void){
             STRSAFE_E_INVALID_PARAMETER,
             "Make sure error is thrown if null termination is not found.");
 
+    testAlignment();
+
     return 0;
 }
@@ -0,0 +1,122 @@
+#include <string.h>
+#include <strsafe.h>
+#include "tap/basic.h"
+
+void testCombine(){
+    static LPCSTR cases[][3] = {
+        {"/usr/local", "bin/tool", "/usr/local/bin/tool"},
+        {"/usr/local/", "/etc/passwd", "/etc/passwd"},
+        {"srv//data/", "./a/./b", "srv/data/a/b"},
+        {"/srv/data", "../etc", "/srv/etc"},
+        {"/srv", "../../../etc", "/etc"},
+        {"a/b", "../../..", ".."},
+        {"../x", "../../y", "../../y"},
+        {"a", "..", "."},
+        {"", "", "."},
+        {"/", "", "/"},
+        {"///", "..", "/"},
+        {"a/", "b/", "a/b"},
+        {"a/..b", "c..", "a/..b/c.."}
+    };
+    char dest[32];
+    size_t i;
+
+    diag("Test combining and normalizing paths.");
+
+    for(i = 0; i < sizeof(cases) / sizeof(cases[0]); i++){
+        ok(SUCCEEDED(StringCchPathCombineA(dest, 32, cases[i][0],
+                        cases[i][1])),
+                "Combine \"%s\" and \"%s\".", cases[i][0], cases[i][1]);
+        is_string(cases[i][2], dest,
+                "Result of combining \"%s\" and \"%s\".", cases[i][0],
+                cases[i][1]);
+    }
+}
+
+void testTruncation(){
+    char dest[11];
+    char wanted[11];
+    char * destEnd;
+    size_t remaining;
+
+    diag("Test combining paths that do not fit.");
+
+    ok(SUCCEEDED(StringCchPathCombineExA(dest, 11, "/usr", "lib/x",
+                    &destEnd, &remaining, 0)),
+            "Combine paths that just fit.");
+    ok(strcmp(dest, "/usr/lib/x") == 0 && destEnd == &dest[10] &&
+            remaining == 1,
+            "End of the result of combining paths that just fit.");
+
+    ok(StringCchPathCombineExA(dest, 11, "/usr/local", "bin", &destEnd,
+                    &remaining, 0) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Combine paths that do not fit.");
+    is_string("/usr/local", dest,
+            "Result of combining paths that do not fit.");
+    ok(destEnd == &dest[10] && remaining == 1,
+            "End of the result of combining paths that do not fit.");
+
+    ok(StringCchPathCombineA(dest, 11, "/usr/locale", "..") ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Combine paths that only fit after \"..\".");
+    is_string("/usr/local", dest,
+            "Result of combining paths that only fit after \"..\".");
+
+    ok(StringCchPathCombineExA(dest, 11, "/usr/local", "bin", NULL, NULL,
+                    STRSAFE_NO_TRUNCATION) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Combine paths that do not fit without truncation.");
+    is_string("", dest,
+            "Result of combining paths that do not fit without "
+            "truncation.");
+
+    ok(StringCchPathCombineExA(dest, 11, "/usr/local", "bin", NULL, NULL,
+                    STRSAFE_FILL_ON_FAILURE | '@') ==
+                    STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Combine paths that do not fit with STRSAFE_FILL_ON_FAILURE.");
+    memset(wanted, '@', 10 * sizeof(char));
+    wanted[10] = '\0';
+    is_string(wanted, dest,
+            "Result of a failure with STRSAFE_FILL_ON_FAILURE.");
+
+    ok(StringCchPathCombineA(dest, 1, "", "") ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Combine paths into a buffer without room for \".\".");
+}
+
+void testFlags(){
+    char dest[11];
+    char wanted[11];
+
+    diag("Test combining paths with flags.");
+
+    ok(StringCchPathCombineA(dest, 11, NULL, "a") ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Combine with a NULL directory.");
+    ok(SUCCEEDED(StringCchPathCombineExA(dest, 11, NULL, "a", NULL, NULL,
+                    STRSAFE_IGNORE_NULLS)),
+            "Combine with a NULL directory with STRSAFE_IGNORE_NULLS.");
+    is_string("a", dest,
+            "Result of combining with a NULL directory.");
+
+    ok(SUCCEEDED(StringCchPathCombineExA(dest, 11, "a", "b", NULL, NULL,
+                    STRSAFE_FILL_BEHIND_NULL | '@')),
+            "Combine paths with STRSAFE_FILL_BEHIND_NULL.");
+    memset(wanted, '@', 10 * sizeof(char));
+    ok(strcmp(dest, "a/b") == 0 &&
+            memcmp(dest + 4, wanted, 7 * sizeof(char)) == 0,
+            "Buffer filled behind the result with STRSAFE_FILL_BEHIND_NULL.");
+
+    ok(StringCchPathCombineA(dest, 0, "a", "b") ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Combine with cchDest set to zero.");
+}
+
+int main(void){
+    plan(26 + 12 + 6);
+
+    testCombine();
+    testTruncation();
+    testFlags();
+
+    return 0;
+}
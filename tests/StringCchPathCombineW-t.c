@@ -0,0 +1,124 @@
+#include <string.h>
+#include <wchar.h>
+#define STRSAFE_NO_DEPRECATE
+#include <strsafe.h>
+#include "tap/wide.h"
+
+void testCombine(){
+    static LPCWSTR cases[][3] = {
+        {L"/usr/local", L"bin/tool", L"/usr/local/bin/tool"},
+        {L"/usr/local/", L"/etc/passwd", L"/etc/passwd"},
+        {L"srv//data/", L"./a/./b", L"srv/data/a/b"},
+        {L"/srv/data", L"../etc", L"/srv/etc"},
+        {L"/srv", L"../../../etc", L"/etc"},
+        {L"a/b", L"../../..", L".."},
+        {L"../x", L"../../y", L"../../y"},
+        {L"a", L"..", L"."},
+        {L"", L"", L"."},
+        {L"/", L"", L"/"},
+        {L"///", L"..", L"/"},
+        {L"a/", L"b/", L"a/b"},
+        {L"a/..b", L"c..", L"a/..b/c.."}
+    };
+    wchar_t dest[32];
+    size_t i;
+
+    diag("Test combining and normalizing paths.");
+
+    for(i = 0; i < sizeof(cases) / sizeof(cases[0]); i++){
+        ok(SUCCEEDED(StringCchPathCombineW(dest, 32, cases[i][0],
+                        cases[i][1])),
+                "Combine \"%ls\" and \"%ls\".", cases[i][0], cases[i][1]);
+        is_wstring(cases[i][2], dest,
+                "Result of combining \"%ls\" and \"%ls\".", cases[i][0],
+                cases[i][1]);
+    }
+}
+
+void testTruncation(){
+    wchar_t dest[11];
+    wchar_t wanted[11];
+    wchar_t * destEnd;
+    size_t remaining;
+
+    diag("Test combining paths that do not fit.");
+
+    ok(SUCCEEDED(StringCchPathCombineExW(dest, 11, L"/usr", L"lib/x",
+                    &destEnd, &remaining, 0)),
+            "Combine paths that just fit.");
+    ok(wcscmp(dest, L"/usr/lib/x") == 0 && destEnd == &dest[10] &&
+            remaining == 1,
+            "End of the result of combining paths that just fit.");
+
+    ok(StringCchPathCombineExW(dest, 11, L"/usr/local", L"bin", &destEnd,
+                    &remaining, 0) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Combine paths that do not fit.");
+    is_wstring(L"/usr/local", dest,
+            "Result of combining paths that do not fit.");
+    ok(destEnd == &dest[10] && remaining == 1,
+            "End of the result of combining paths that do not fit.");
+
+    ok(StringCchPathCombineW(dest, 11, L"/usr/locale", L"..") ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Combine paths that only fit after \"..\".");
+    is_wstring(L"/usr/local", dest,
+            "Result of combining paths that only fit after \"..\".");
+
+    ok(StringCchPathCombineExW(dest, 11, L"/usr/local", L"bin", NULL, NULL,
+                    STRSAFE_NO_TRUNCATION) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Combine paths that do not fit without truncation.");
+    is_wstring(L"", dest,
+            "Result of combining paths that do not fit without "
+            "truncation.");
+
+    ok(StringCchPathCombineExW(dest, 11, L"/usr/local", L"bin", NULL, NULL,
+                    STRSAFE_FILL_ON_FAILURE | '@') ==
+                    STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Combine paths that do not fit with STRSAFE_FILL_ON_FAILURE.");
+    memset(wanted, '@', 10 * sizeof(wchar_t));
+    wanted[10] = L'\0';
+    is_wstring(wanted, dest,
+            "Result of a failure with STRSAFE_FILL_ON_FAILURE.");
+
+    ok(StringCchPathCombineW(dest, 1, L"", L"") ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Combine paths into a buffer without room for \".\".");
+}
+
+void testFlags(){
+    wchar_t dest[11];
+    wchar_t wanted[11];
+
+    diag("Test combining paths with flags.");
+
+    ok(StringCchPathCombineW(dest, 11, NULL, L"a") ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Combine with a NULL directory.");
+    ok(SUCCEEDED(StringCchPathCombineExW(dest, 11, NULL, L"a", NULL, NULL,
+                    STRSAFE_IGNORE_NULLS)),
+            "Combine with a NULL directory with STRSAFE_IGNORE_NULLS.");
+    is_wstring(L"a", dest,
+            "Result of combining with a NULL directory.");
+
+    ok(SUCCEEDED(StringCchPathCombineExW(dest, 11, L"a", L"b", NULL, NULL,
+                    STRSAFE_FILL_BEHIND_NULL | '@')),
+            "Combine paths with STRSAFE_FILL_BEHIND_NULL.");
+    memset(wanted, '@', 10 * sizeof(wchar_t));
+    ok(wcscmp(dest, L"a/b") == 0 &&
+            memcmp(dest + 4, wanted, 7 * sizeof(wchar_t)) == 0,
+            "Buffer filled behind the result with STRSAFE_FILL_BEHIND_NULL.");
+
+    ok(StringCchPathCombineW(dest, 0, L"a", L"b") ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Combine with cchDest set to zero.");
+}
+
+int main(void){
+    plan(26 + 12 + 6);
+
+    testCombine();
+    testTruncation();
+    testFlags();
+
+    return 0;
+}
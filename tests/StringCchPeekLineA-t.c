@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <strsafe.h>
+#include "tap/basic.h"
+
+/*
+ * Creates a temporary file with the given contents, positioned at the
+ * start.
+ */
+FILE * openWith(const char * contents, size_t length){
+    FILE * file = tmpfile();
+
+    if(file == NULL){
+        sysbail("Could not create a temporary file");
+    }
+    fwrite(contents, 1, length, file);
+    fflush(file);
+    rewind(file);
+
+    return file;
+}
+
+/*
+ * Creates a reader with the given buffer size for a file.
+ */
+STRSAFE_READER * readerFor(FILE * file, size_t cbBuffer){
+    STRSAFE_READER * reader;
+
+    if(FAILED(StrSafeReaderCreate(&reader, fileno(file), cbBuffer))){
+        bail("Could not create a reader");
+    }
+
+    return reader;
+}
+
+/*
+ * Checks whether a line has the given contents.
+ */
+int isLine(const STRSAFE_SEGMENT_A * line, const char * wanted){
+    return line->cch == strlen(wanted) &&
+            memcmp(line->pch, wanted, line->cch) == 0;
+}
+
+void testLines(){
+    static const char contents[] = "first line\n\nlong line\nlast";
+    FILE * file = openWith(contents, sizeof(contents) - 1);
+    STRSAFE_READER * reader = readerFor(file, 0);
+    STRSAFE_SEGMENT_A line;
+    char dest[32];
+
+    diag("Test peeking at lines.");
+
+    ok(StringCchPeekLineA(reader, 32, &line) == S_OK,
+            "Peek at a line.");
+    ok(isLine(&line, "first line"), "Result of peeking at a line.");
+
+    ok(StringCchPeekLineA(reader, 32, &line) == S_OK,
+            "Peek at an empty line.");
+    ok(line.cch == 0, "Result of peeking at an empty line.");
+
+    ok(StringCchPeekLineA(reader, 4, &line) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Peek at a line longer than cchMax.");
+    ok(isLine(&line, "long"),
+            "Result of peeking at a line longer than cchMax.");
+    ok(StringCchReadLineExA(reader, dest, 32, NULL, NULL, 0) == S_OK,
+            "Read the rest of the line.");
+    is_string(" line", dest, "Result of reading the rest of the line.");
+
+    ok(StringCchPeekLineA(reader, 4, &line) == S_OK,
+            "Peek at a last line without a line break.");
+    ok(isLine(&line, "last"),
+            "Result of peeking at a last line without a line break.");
+
+    ok(StringCchPeekLineA(reader, 32, &line) == STRSAFE_E_END_OF_FILE,
+            "Peek at the end of the file.");
+    ok(line.cch == 0, "Result of peeking at the end of the file.");
+
+    StrSafeReaderDestroy(reader);
+    fclose(file);
+}
+
+void testCompaction(){
+    int fds[2];
+    STRSAFE_READER * reader;
+    STRSAFE_SEGMENT_A line;
+
+    diag("Test peeking at lines that are split between reads.");
+
+    if(pipe(fds) != 0){
+        sysbail("Could not create a pipe");
+    }
+    ok(SUCCEEDED(StrSafeReaderCreate(&reader, fds[0], 8)),
+            "Create a reader with a small buffer.");
+
+    if(write(fds[1], "ab\ncd", 5) != 5){
+        sysbail("Could not write to a pipe");
+    }
+    ok(StringCchPeekLineA(reader, 32, &line) == S_OK && isLine(&line, "ab"),
+            "Peek at a line in the first read.");
+
+    if(write(fds[1], "efg\n", 4) != 4){
+        sysbail("Could not write to a pipe");
+    }
+    ok(StringCchPeekLineA(reader, 32, &line) == S_OK &&
+            isLine(&line, "cdefg"),
+            "Peek at a line that is split between reads.");
+
+    if(write(fds[1], "0123456789\n", 11) != 11){
+        sysbail("Could not write to a pipe");
+    }
+    close(fds[1]);
+    ok(StringCchPeekLineA(reader, 32, &line) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER && isLine(&line, "0123456"),
+            "Peek at a line longer than the buffer.");
+    ok(StringCchPeekLineA(reader, 32, &line) == S_OK &&
+            isLine(&line, "789"),
+            "Peek at the rest of a line longer than the buffer.");
+    ok(StringCchPeekLineA(reader, 32, &line) == STRSAFE_E_END_OF_FILE,
+            "Peek at the end of a pipe.");
+
+    StrSafeReaderDestroy(reader);
+    close(fds[0]);
+}
+
+void testInvalid(){
+    FILE * file = openWith("a\n", 2);
+    STRSAFE_READER * reader = readerFor(file, 1);
+    STRSAFE_SEGMENT_A line;
+
+    diag("Test peeking at lines with invalid parameters.");
+
+    ok(StringCchPeekLineA(NULL, 32, &line) == STRSAFE_E_INVALID_PARAMETER,
+            "Peek with a NULL reader.");
+    ok(StringCchPeekLineA(reader, 32, NULL) == STRSAFE_E_INVALID_PARAMETER,
+            "Peek with pLine set to NULL.");
+    ok(StringCchPeekLineA(reader, 32, &line) == STRSAFE_E_INVALID_PARAMETER,
+            "Peek with a single byte buffer.");
+    StrSafeReaderDestroy(reader);
+
+    reader = readerFor(file, 0);
+    ok(StringCchPeekLineA(reader, 0, &line) == STRSAFE_E_INVALID_PARAMETER,
+            "Peek with cchMax set to zero.");
+    ok(StringCchPeekLineA(reader, STRSAFE_MAX_CCH + 1, &line) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Peek with cchMax larger than STRSAFE_MAX_CCH.");
+    StrSafeReaderDestroy(reader);
+
+    fclose(file);
+}
+
+/*
+ * Compares the results with those of StringCchFGetsExA for random lines
+ * read with buffers of many sizes, all larger than the longest line.
+ */
+void testCompare(){
+    static char contents[50000];
+    static const size_t buffers[] = {128, 200, 4096, 0};
+    size_t length = 0;
+    size_t i;
+
+    diag("Compare with StringCchFGetsExA.");
+
+    srand(1);
+    for(i = 0; i < sizeof(contents); i++){
+        if(length == 100 || rand() % 40 == 0){
+            contents[i] = '\n';
+            length = 0;
+        } else {
+            contents[i] = (char)('a' + rand() % 26);
+            length++;
+        }
+    }
+
+    for(i = 0; i < sizeof(buffers) / sizeof(buffers[0]); i++){
+        FILE * file = openWith(contents, sizeof(contents));
+        FILE * check = openWith(contents, sizeof(contents));
+        STRSAFE_READER * reader = readerFor(file, buffers[i]);
+        int correct = 1;
+        HRESULT wantedResult;
+
+        do {
+            STRSAFE_SEGMENT_A line;
+            char expected[128];
+            HRESULT result;
+
+            result = StringCchPeekLineA(reader, 127, &line);
+            wantedResult = StringCchFGetsExA(expected, 128, check, NULL,
+                    NULL, 0);
+            correct = correct && result == wantedResult &&
+                    isLine(&line, expected);
+        } while(wantedResult != STRSAFE_E_END_OF_FILE && correct);
+
+        ok(correct, "Same results as StringCchFGetsExA with a %lu byte "
+                "buffer.", (unsigned long)buffers[i]);
+
+        StrSafeReaderDestroy(reader);
+        fclose(check);
+        fclose(file);
+    }
+}
+
+int main(void){
+    plan(12 + 6 + 5 + 4);
+
+    testLines();
+    testCompaction();
+    testInvalid();
+    testCompare();
+
+    return 0;
+}
@@ -0,0 +1,220 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <strsafe.h>
+#include "tap/basic.h"
+
+/*
+ * Creates a temporary file with the given contents, positioned at the
+ * start.
+ */
+FILE * openWith(const char * contents, size_t length){
+    FILE * file = tmpfile();
+
+    if(file == NULL){
+        sysbail("Could not create a temporary file");
+    }
+    fwrite(contents, 1, length, file);
+    fflush(file);
+    rewind(file);
+
+    return file;
+}
+
+/*
+ * Creates a reader with the given buffer size for a file.
+ */
+STRSAFE_READER * readerFor(FILE * file, size_t cbBuffer){
+    STRSAFE_READER * reader;
+
+    if(FAILED(StrSafeReaderCreate(&reader, fileno(file), cbBuffer))){
+        bail("Could not create a reader");
+    }
+
+    return reader;
+}
+
+void testLines(){
+    static const char contents[] = "first line\nunittests\n\nlong line\nlast";
+    FILE * file = openWith(contents, sizeof(contents) - 1);
+    STRSAFE_READER * reader = readerFor(file, 0);
+    char dest[32];
+    char * destEnd;
+    size_t remaining;
+
+    diag("Test reading lines from a file descriptor.");
+
+    ok(StringCchReadLineExA(reader, dest, 32, &destEnd, &remaining, 0) ==
+            S_OK,
+            "Read a line.");
+    is_string("first line", dest, "Result of reading a line.");
+    ok(destEnd == &dest[10] && remaining == 22,
+            "End of the result of reading a line.");
+
+    ok(StringCchReadLineExA(reader, dest, 10, NULL, NULL, 0) == S_OK,
+            "Read a line that exactly fits.");
+    is_string("unittests", dest,
+            "Result of reading a line that exactly fits.");
+    ok(StringCchReadLineExA(reader, dest, 10, NULL, NULL, 0) == S_OK,
+            "Read the line break after a line that exactly fits.");
+    is_string("", dest,
+            "Result of reading the line break after a line that exactly "
+            "fits.");
+
+    ok(StringCchReadLineExA(reader, dest, 32, NULL, NULL, 0) == S_OK,
+            "Read an empty line.");
+    is_string("", dest, "Result of reading an empty line.");
+
+    ok(StringCchReadLineExA(reader, dest, 5, NULL, NULL, 0) == S_OK,
+            "Read a line that does not fit.");
+    is_string("long", dest, "Result of reading a line that does not fit.");
+    ok(StringCchReadLineExA(reader, dest, 32, NULL, NULL, 0) == S_OK,
+            "Read the rest of the line.");
+    is_string(" line", dest, "Result of reading the rest of the line.");
+
+    ok(StringCchReadLineExA(reader, dest, 32, &destEnd, NULL, 0) == S_OK,
+            "Read a last line without a line break.");
+    ok(strcmp(dest, "last") == 0 && destEnd == &dest[4],
+            "Result of reading a last line without a line break.");
+
+    ok(StringCchReadLineExA(reader, dest, 32, &destEnd, &remaining, 0) ==
+            STRSAFE_E_END_OF_FILE,
+            "Read at the end of the file.");
+    ok(dest[0] == '\0' && destEnd == dest && remaining == 32,
+            "Result of reading at the end of the file.");
+
+    StrSafeReaderDestroy(reader);
+    fclose(file);
+}
+
+void testPipe(){
+    int fds[2];
+    STRSAFE_READER * reader;
+    char dest[16];
+
+    diag("Test reading lines from a pipe with a small buffer.");
+
+    if(pipe(fds) != 0){
+        sysbail("Could not create a pipe");
+    }
+    if(write(fds[1], "abcdefgh\nij\n", 12) != 12){
+        sysbail("Could not write to a pipe");
+    }
+    close(fds[1]);
+
+    ok(SUCCEEDED(StrSafeReaderCreate(&reader, fds[0], 3)),
+            "Create a reader with a small buffer.");
+    ok(StringCchReadLineExA(reader, dest, 16, NULL, NULL, 0) == S_OK,
+            "Read a line longer than the buffer of the reader.");
+    is_string("abcdefgh", dest,
+            "Result of reading a line longer than the buffer of the "
+            "reader.");
+    ok(StringCchReadLineExA(reader, dest, 16, NULL, NULL, 0) == S_OK,
+            "Read a line from a pipe.");
+    is_string("ij", dest, "Result of reading a line from a pipe.");
+    ok(StringCchReadLineExA(reader, dest, 16, NULL, NULL, 0) ==
+            STRSAFE_E_END_OF_FILE,
+            "Read at the end of a pipe.");
+
+    StrSafeReaderDestroy(reader);
+    close(fds[0]);
+}
+
+void testFlags(){
+    FILE * file = openWith("", 0);
+    STRSAFE_READER * reader = readerFor(file, 0);
+    char dest[11];
+    char wanted[11];
+
+    diag("Test reading lines with invalid parameters and flags.");
+
+    ok(StrSafeReaderCreate(NULL, 0, 0) == STRSAFE_E_INVALID_PARAMETER,
+            "Create a reader with ppReader set to NULL.");
+    ok(StrSafeReaderCreate(&reader, -1, 0) == STRSAFE_E_INVALID_PARAMETER,
+            "Create a reader for an invalid file descriptor.");
+    ok(StringCchReadLineExA(NULL, dest, 11, NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Read from a NULL reader.");
+    ok(StringCchReadLineExA(reader, dest, 1, NULL, NULL, 0) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER && dest[0] == '\0',
+            "Read into a buffer without room for a character.");
+
+    ok(StringCchReadLineExA(reader, dest, 11, NULL, NULL,
+                    STRSAFE_FILL_ON_FAILURE | '@') == STRSAFE_E_END_OF_FILE,
+            "Read at the end of the file with STRSAFE_FILL_ON_FAILURE.");
+    memset(wanted, '@', 10 * sizeof(char));
+    wanted[10] = '\0';
+    is_string(wanted, dest,
+            "Result of a failure with STRSAFE_FILL_ON_FAILURE.");
+
+    ok(StringCchReadLineExA(reader, dest, 11, NULL, NULL,
+                    STRSAFE_NULL_ON_FAILURE) == STRSAFE_E_END_OF_FILE,
+            "Read at the end of the file with STRSAFE_NULL_ON_FAILURE.");
+    is_string("", dest,
+            "Result of a failure with STRSAFE_NULL_ON_FAILURE.");
+
+    StrSafeReaderDestroy(reader);
+    StrSafeReaderDestroy(NULL);
+    fclose(file);
+}
+
+/*
+ * Compares the results with those of StringCchFGetsExA for random lines
+ * read with buffers of many sizes.
+ */
+void testCompare(){
+    static char contents[50000];
+    static const size_t buffers[] = {1, 7, 64, 4096, 0};
+    size_t i;
+
+    diag("Compare with StringCchFGetsExA.");
+
+    srand(1);
+    for(i = 0; i < sizeof(contents); i++){
+        contents[i] = rand() % 40 == 0 ? '\n' : (char)('a' + rand() % 26);
+    }
+
+    for(i = 0; i < sizeof(buffers) / sizeof(buffers[0]); i++){
+        FILE * file = openWith(contents, sizeof(contents));
+        FILE * check = openWith(contents, sizeof(contents));
+        STRSAFE_READER * reader = readerFor(file, buffers[i]);
+        int correct = 1;
+        HRESULT wantedResult;
+
+        do {
+            char dest[64];
+            char expected[64];
+            char * destEnd;
+            char * expectedEnd;
+            size_t cchDest = (size_t)(rand() % 63) + 1;
+            HRESULT result;
+
+            result = StringCchReadLineExA(reader, dest, cchDest, &destEnd,
+                    NULL, 0);
+            wantedResult = StringCchFGetsExA(expected, cchDest, check,
+                    &expectedEnd, NULL, 0);
+            correct = correct && result == wantedResult &&
+                    strcmp(dest, expected) == 0 &&
+                    destEnd - dest == expectedEnd - expected;
+        } while(wantedResult != STRSAFE_E_END_OF_FILE && correct);
+
+        ok(correct, "Same results as StringCchFGetsExA with a %lu byte "
+                "buffer.", (unsigned long)buffers[i]);
+
+        StrSafeReaderDestroy(reader);
+        fclose(check);
+        fclose(file);
+    }
+}
+
+int main(void){
+    plan(17 + 6 + 8 + 5);
+
+    testLines();
+    testPipe();
+    testFlags();
+    testCompare();
+
+    return 0;
+}
@@ -0,0 +1,223 @@
+#include <string.h>
+#include <strsafe.h>
+#include "tap/basic.h"
+
+void testEdit(){
+    char dest[11];
+    char * destEnd;
+    size_t remaining;
+
+    diag("Test editing strings in place.");
+
+    strcpy(dest, "abcdef");
+    ok(SUCCEEDED(StringCchReplaceRangeExA(dest, 11, 2, 2, "XYZ", &destEnd,
+                    &remaining, 0)),
+            "Replace a range with a longer string.");
+    is_string("abXYZef", dest,
+            "Result of replacing a range with a longer string.");
+    ok(destEnd == &dest[7] && remaining == 4,
+            "End of the result of replacing a range with a longer string.");
+
+    ok(SUCCEEDED(StringCchReplaceRangeExA(dest, 11, 1, 4, "-", &destEnd,
+                    &remaining, 0)),
+            "Replace a range with a shorter string.");
+    is_string("a-ef", dest,
+            "Result of replacing a range with a shorter string.");
+    ok(destEnd == &dest[4] && remaining == 7,
+            "End of the result of replacing a range with a shorter string.");
+
+    ok(SUCCEEDED(StringCchReplaceRangeExA(dest, 11, 2, 100, "xyz", NULL,
+                    NULL, 0)),
+            "Replace a range that goes past the end.");
+    is_string("a-xyz", dest,
+            "Result of replacing a range that goes past the end.");
+
+    ok(SUCCEEDED(StringCchInsertExA(dest, 11, 0, "<<", &destEnd,
+                    &remaining, 0)),
+            "Insert a string at the start.");
+    is_string("<<a-xyz", dest,
+            "Result of inserting a string at the start.");
+    ok(destEnd == &dest[7] && remaining == 4,
+            "End of the result of inserting a string at the start.");
+
+    ok(SUCCEEDED(StringCchInsertExA(dest, 11, 7, ">>", NULL, NULL, 0)),
+            "Insert a string at the end.");
+    is_string("<<a-xyz>>", dest,
+            "Result of inserting a string at the end.");
+
+    ok(SUCCEEDED(StringCchDeleteA(dest, 11, 3, 2, &destEnd)),
+            "Delete a range.");
+    is_string("<<ayz>>", dest,
+            "Result of deleting a range.");
+    ok(destEnd == &dest[7],
+            "End of the result of deleting a range.");
+
+    ok(SUCCEEDED(StringCchDeleteA(dest, 11, 5, 100, &destEnd)),
+            "Delete a range that goes past the end.");
+    is_string("<<ayz", dest,
+            "Result of deleting a range that goes past the end.");
+
+    ok(SUCCEEDED(StringCchDeleteA(dest, 11, 5, 1, &destEnd)),
+            "Delete at the end.");
+    ok(strcmp(dest, "<<ayz") == 0 && destEnd == &dest[5],
+            "Result of deleting at the end.");
+}
+
+void testTruncation(){
+    char dest[11];
+    char wanted[11];
+    char * destEnd;
+    size_t remaining;
+
+    diag("Test edits whose result does not fit.");
+
+    strcpy(dest, "abcdefgh");
+    ok(StringCchInsertExA(dest, 11, 2, "1234", &destEnd, &remaining, 0) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Insert a string that does not fit.");
+    is_string("ab1234cdef", dest,
+            "Result of inserting a string that does not fit.");
+    ok(destEnd == &dest[10] && remaining == 1,
+            "End of the result of inserting a string that does not fit.");
+
+    strcpy(dest, "abcdefgh");
+    ok(StringCchReplaceRangeExA(dest, 11, 6, 1, "0123456789", NULL, NULL,
+                    0) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Replace a range with a string that does not fit at all.");
+    is_string("abcdef0123", dest,
+            "Result of replacing a range with a string that does not fit "
+            "at all.");
+
+    strcpy(dest, "abcdefgh");
+    dest[9] = '#';
+    ok(StringCchInsertExA(dest, 11, 2, "1234", NULL, NULL,
+                    STRSAFE_NO_TRUNCATION) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Insert a string that does not fit without truncation.");
+    ok(strcmp(dest, "abcdefgh") == 0 && dest[9] == '#',
+            "pszDest untouched after inserting a string that does not fit "
+            "without truncation.");
+
+    ok(StringCchInsertExA(dest, 11, 2, "1234", NULL, NULL,
+                    STRSAFE_NULL_ON_FAILURE) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Insert a string that does not fit with "
+            "STRSAFE_NULL_ON_FAILURE.");
+    is_string("", dest,
+            "Result of a failure with STRSAFE_NULL_ON_FAILURE.");
+
+    strcpy(dest, "abcdefgh");
+    ok(StringCchInsertExA(dest, 11, 2, "1234", NULL, NULL,
+                    STRSAFE_FILL_ON_FAILURE | '@') ==
+                    STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Insert a string that does not fit with "
+            "STRSAFE_FILL_ON_FAILURE.");
+    memset(wanted, '@', 10 * sizeof(char));
+    wanted[10] = '\0';
+    is_string(wanted, dest,
+            "Result of a failure with STRSAFE_FILL_ON_FAILURE.");
+}
+
+void testFlags(){
+    char dest[11];
+    char wanted[11];
+
+    diag("Test editing strings with invalid parameters and flags.");
+
+    strcpy(dest, "abc");
+    ok(StringCchInsertExA(dest, 11, 4, "x", NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Insert behind the end of pszDest.");
+    ok(StringCchDeleteA(dest, 11, 4, 1, NULL) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Delete behind the end of pszDest.");
+    ok(StringCchInsertExA(dest, 11, 0, NULL, NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Insert NULL.");
+    ok(SUCCEEDED(StringCchReplaceRangeExA(dest, 11, 1, 1, NULL, NULL, NULL,
+                    STRSAFE_IGNORE_NULLS)),
+            "Replace a range with NULL with STRSAFE_IGNORE_NULLS.");
+    is_string("ac", dest,
+            "Result of replacing a range with NULL.");
+    ok(StringCchInsertExA(dest, 0, 0, "x", NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Insert with cchDest set to zero.");
+
+    memset(dest, 'x', sizeof(dest));
+    ok(StringCchInsertExA(dest, 11, 0, "x", NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Insert into a buffer that is not null terminated.");
+
+    strcpy(dest, "abc");
+    ok(SUCCEEDED(StringCchInsertExA(dest, 11, 1, "12", NULL, NULL,
+                    STRSAFE_FILL_BEHIND_NULL | '@')),
+            "Insert a string with STRSAFE_FILL_BEHIND_NULL.");
+    memset(wanted, '@', 10 * sizeof(char));
+    ok(strcmp(dest, "a12bc") == 0 &&
+            memcmp(dest + 6, wanted, 5 * sizeof(char)) == 0,
+            "Buffer filled behind the result with STRSAFE_FILL_BEHIND_NULL.");
+}
+
+/*
+ * Compares the results with those of building the edited string in a
+ * second buffer with StringCchCopyNA and StringCchCatExA.
+ */
+void testCompare(){
+    LPCSTR initial = "abcdefghijklmnopqrst";
+    LPCSTR source = "0123456789ABCDEFGHIJ";
+    char dest[24];
+    char expected[24];
+    char tail[24];
+    int correct = 1;
+    size_t cchDest;
+
+    diag("Compare with editing through a second buffer.");
+
+    for(cchDest = 1; cchDest <= 24; cchDest++){
+        size_t destLength = cchDest - 1 < 20 ? cchDest - 1 : 20;
+        size_t offset;
+        for(offset = 0; offset <= destLength; offset++){
+            size_t count;
+            for(count = 0; count <= destLength - offset + 1; count++){
+                size_t srcLength;
+                for(srcLength = 0; srcLength <= 20; srcLength += 3){
+                    char src[21];
+                    HRESULT result;
+                    HRESULT wantedResult;
+                    size_t tailStart = offset + count < destLength ?
+                            offset + count : destLength;
+
+                    memcpy(src, source, srcLength);
+                    src[srcLength] = '\0';
+                    memset(dest, '#', sizeof(dest));
+                    StringCchCopyNA(dest, cchDest, initial, destLength);
+
+                    StringCchCopyA(tail, 24, dest + tailStart);
+                    memcpy(expected, dest, sizeof(expected));
+                    expected[offset] = '\0';
+                    wantedResult = StringCchCatExA(expected, cchDest, src,
+                            NULL, NULL, 0);
+                    if(SUCCEEDED(wantedResult)){
+                        wantedResult = StringCchCatExA(expected, cchDest,
+                                tail, NULL, NULL, 0);
+                    }
+
+                    result = StringCchReplaceRangeExA(dest, cchDest, offset,
+                            count, src, NULL, NULL, 0);
+                    correct = correct && result == wantedResult &&
+                            strcmp(dest, expected) == 0;
+                }
+            }
+        }
+    }
+    ok(correct, "Same results as editing through a second buffer.");
+}
+
+int main(void){
+    plan(20 + 11 + 9 + 1);
+
+    testEdit();
+    testTruncation();
+    testFlags();
+    testCompare();
+
+    return 0;
+}
@@ -0,0 +1,225 @@
+#include <string.h>
+#include <wchar.h>
+#define STRSAFE_NO_DEPRECATE
+#include <strsafe.h>
+#include "tap/wide.h"
+
+void testEdit(){
+    wchar_t dest[11];
+    wchar_t * destEnd;
+    size_t remaining;
+
+    diag("Test editing strings in place.");
+
+    wcscpy(dest, L"abcdef");
+    ok(SUCCEEDED(StringCchReplaceRangeExW(dest, 11, 2, 2, L"XYZ", &destEnd,
+                    &remaining, 0)),
+            "Replace a range with a longer string.");
+    is_wstring(L"abXYZef", dest,
+            "Result of replacing a range with a longer string.");
+    ok(destEnd == &dest[7] && remaining == 4,
+            "End of the result of replacing a range with a longer string.");
+
+    ok(SUCCEEDED(StringCchReplaceRangeExW(dest, 11, 1, 4, L"-", &destEnd,
+                    &remaining, 0)),
+            "Replace a range with a shorter string.");
+    is_wstring(L"a-ef", dest,
+            "Result of replacing a range with a shorter string.");
+    ok(destEnd == &dest[4] && remaining == 7,
+            "End of the result of replacing a range with a shorter string.");
+
+    ok(SUCCEEDED(StringCchReplaceRangeExW(dest, 11, 2, 100, L"xyz", NULL,
+                    NULL, 0)),
+            "Replace a range that goes past the end.");
+    is_wstring(L"a-xyz", dest,
+            "Result of replacing a range that goes past the end.");
+
+    ok(SUCCEEDED(StringCchInsertExW(dest, 11, 0, L"<<", &destEnd,
+                    &remaining, 0)),
+            "Insert a string at the start.");
+    is_wstring(L"<<a-xyz", dest,
+            "Result of inserting a string at the start.");
+    ok(destEnd == &dest[7] && remaining == 4,
+            "End of the result of inserting a string at the start.");
+
+    ok(SUCCEEDED(StringCchInsertExW(dest, 11, 7, L">>", NULL, NULL, 0)),
+            "Insert a string at the end.");
+    is_wstring(L"<<a-xyz>>", dest,
+            "Result of inserting a string at the end.");
+
+    ok(SUCCEEDED(StringCchDeleteW(dest, 11, 3, 2, &destEnd)),
+            "Delete a range.");
+    is_wstring(L"<<ayz>>", dest,
+            "Result of deleting a range.");
+    ok(destEnd == &dest[7],
+            "End of the result of deleting a range.");
+
+    ok(SUCCEEDED(StringCchDeleteW(dest, 11, 5, 100, &destEnd)),
+            "Delete a range that goes past the end.");
+    is_wstring(L"<<ayz", dest,
+            "Result of deleting a range that goes past the end.");
+
+    ok(SUCCEEDED(StringCchDeleteW(dest, 11, 5, 1, &destEnd)),
+            "Delete at the end.");
+    ok(wcscmp(dest, L"<<ayz") == 0 && destEnd == &dest[5],
+            "Result of deleting at the end.");
+}
+
+void testTruncation(){
+    wchar_t dest[11];
+    wchar_t wanted[11];
+    wchar_t * destEnd;
+    size_t remaining;
+
+    diag("Test edits whose result does not fit.");
+
+    wcscpy(dest, L"abcdefgh");
+    ok(StringCchInsertExW(dest, 11, 2, L"1234", &destEnd, &remaining, 0) ==
+            STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Insert a string that does not fit.");
+    is_wstring(L"ab1234cdef", dest,
+            "Result of inserting a string that does not fit.");
+    ok(destEnd == &dest[10] && remaining == 1,
+            "End of the result of inserting a string that does not fit.");
+
+    wcscpy(dest, L"abcdefgh");
+    ok(StringCchReplaceRangeExW(dest, 11, 6, 1, L"0123456789", NULL, NULL,
+                    0) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Replace a range with a string that does not fit at all.");
+    is_wstring(L"abcdef0123", dest,
+            "Result of replacing a range with a string that does not fit "
+            "at all.");
+
+    wcscpy(dest, L"abcdefgh");
+    dest[9] = '#';
+    ok(StringCchInsertExW(dest, 11, 2, L"1234", NULL, NULL,
+                    STRSAFE_NO_TRUNCATION) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Insert a string that does not fit without truncation.");
+    ok(wcscmp(dest, L"abcdefgh") == 0 && dest[9] == '#',
+            "pszDest untouched after inserting a string that does not fit "
+            "without truncation.");
+
+    ok(StringCchInsertExW(dest, 11, 2, L"1234", NULL, NULL,
+                    STRSAFE_NULL_ON_FAILURE) == STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Insert a string that does not fit with "
+            "STRSAFE_NULL_ON_FAILURE.");
+    is_wstring(L"", dest,
+            "Result of a failure with STRSAFE_NULL_ON_FAILURE.");
+
+    wcscpy(dest, L"abcdefgh");
+    ok(StringCchInsertExW(dest, 11, 2, L"1234", NULL, NULL,
+                    STRSAFE_FILL_ON_FAILURE | '@') ==
+                    STRSAFE_E_INSUFFICIENT_BUFFER,
+            "Insert a string that does not fit with "
+            "STRSAFE_FILL_ON_FAILURE.");
+    memset(wanted, '@', 10 * sizeof(wchar_t));
+    wanted[10] = L'\0';
+    is_wstring(wanted, dest,
+            "Result of a failure with STRSAFE_FILL_ON_FAILURE.");
+}
+
+void testFlags(){
+    wchar_t dest[11];
+    wchar_t wanted[11];
+
+    diag("Test editing strings with invalid parameters and flags.");
+
+    wcscpy(dest, L"abc");
+    ok(StringCchInsertExW(dest, 11, 4, L"x", NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Insert behind the end of pszDest.");
+    ok(StringCchDeleteW(dest, 11, 4, 1, NULL) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Delete behind the end of pszDest.");
+    ok(StringCchInsertExW(dest, 11, 0, NULL, NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Insert NULL.");
+    ok(SUCCEEDED(StringCchReplaceRangeExW(dest, 11, 1, 1, NULL, NULL, NULL,
+                    STRSAFE_IGNORE_NULLS)),
+            "Replace a range with NULL with STRSAFE_IGNORE_NULLS.");
+    is_wstring(L"ac", dest,
+            "Result of replacing a range with NULL.");
+    ok(StringCchInsertExW(dest, 0, 0, L"x", NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Insert with cchDest set to zero.");
+
+    memset(dest, 'x', sizeof(dest));
+    ok(StringCchInsertExW(dest, 11, 0, L"x", NULL, NULL, 0) ==
+            STRSAFE_E_INVALID_PARAMETER,
+            "Insert into a buffer that is not null terminated.");
+
+    wcscpy(dest, L"abc");
+    ok(SUCCEEDED(StringCchInsertExW(dest, 11, 1, L"12", NULL, NULL,
+                    STRSAFE_FILL_BEHIND_NULL | '@')),
+            "Insert a string with STRSAFE_FILL_BEHIND_NULL.");
+    memset(wanted, '@', 10 * sizeof(wchar_t));
+    ok(wcscmp(dest, L"a12bc") == 0 &&
+            memcmp(dest + 6, wanted, 5 * sizeof(wchar_t)) == 0,
+            "Buffer filled behind the result with STRSAFE_FILL_BEHIND_NULL.");
+}
+
+/*
+ * Compares the results with those of building the edited string in a
+ * second buffer with StringCchCopyNW and StringCchCatExW.
+ */
+void testCompare(){
+    LPCWSTR initial = L"abcdefghijklmnopqrst";
+    LPCWSTR source = L"0123456789ABCDEFGHIJ";
+    wchar_t dest[24];
+    wchar_t expected[24];
+    wchar_t tail[24];
+    int correct = 1;
+    size_t cchDest;
+
+    diag("Compare with editing through a second buffer.");
+
+    for(cchDest = 1; cchDest <= 24; cchDest++){
+        size_t destLength = cchDest - 1 < 20 ? cchDest - 1 : 20;
+        size_t offset;
+        for(offset = 0; offset <= destLength; offset++){
+            size_t count;
+            for(count = 0; count <= destLength - offset + 1; count++){
+                size_t srcLength;
+                for(srcLength = 0; srcLength <= 20; srcLength += 3){
+                    wchar_t src[21];
+                    HRESULT result;
+                    HRESULT wantedResult;
+                    size_t tailStart = offset + count < destLength ?
+                            offset + count : destLength;
+
+                    memcpy(src, source, srcLength * sizeof(wchar_t));
+                    src[srcLength] = L'\0';
+                    wmemset(dest, L'#', 24);
+                    StringCchCopyNW(dest, cchDest, initial, destLength);
+
+                    StringCchCopyW(tail, 24, dest + tailStart);
+                    memcpy(expected, dest, sizeof(expected));
+                    expected[offset] = L'\0';
+                    wantedResult = StringCchCatExW(expected, cchDest, src,
+                            NULL, NULL, 0);
+                    if(SUCCEEDED(wantedResult)){
+                        wantedResult = StringCchCatExW(expected, cchDest,
+                                tail, NULL, NULL, 0);
+                    }
+
+                    result = StringCchReplaceRangeExW(dest, cchDest, offset,
+                            count, src, NULL, NULL, 0);
+                    correct = correct && result == wantedResult &&
+                            wcscmp(dest, expected) == 0;
+                }
+            }
+        }
+    }
+    ok(correct, "Same results as editing through a second buffer.");
+}
+
+int main(void){
+    plan(20 + 11 + 9 + 1);
+
+    testEdit();
+    testTruncation();
+    testFlags();
+    testCompare();
+
+    return 0;
+}